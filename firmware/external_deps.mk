@@ -11,4 +11,11 @@ $(platform_build_dir)/firmware/fw_dynamic.o: $(FW_FDT_PATH)
 $(platform_build_dir)/firmware/fw_jump.o: $(FW_FDT_PATH)
 $(platform_build_dir)/firmware/fw_payload.o: $(FW_FDT_PATH)
 
-$(platform_build_dir)/firmware/fw_payload.o: $(FW_PAYLOAD_PATH_FINAL)
+$(platform_build_dir)/firmware/fw_payload.o: $(FW_PAYLOAD_PATH_EMBED)
+
+ifeq ($(FW_PAYLOAD_COMPRESS),lz4)
+$(platform_build_dir)/firmware/fw_payload.dep: $(FW_PAYLOAD_PATH_EMBED)
+endif
+
+$(platform_build_dir)/firmware/payload.bin.lz4: $(FW_PAYLOAD_PATH_FINAL)
+	$(call compile_lz4,$@,$<)
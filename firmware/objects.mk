@@ -40,7 +40,14 @@ FW_PAYLOAD_PATH_FINAL=$(FW_PAYLOAD_PATH)
 else
 FW_PAYLOAD_PATH_FINAL=$(platform_build_dir)/firmware/payloads/test.bin
 endif
-firmware-genflags-$(FW_PAYLOAD) += -DFW_PAYLOAD_PATH=\"$(FW_PAYLOAD_PATH_FINAL)\"
+ifeq ($(FW_PAYLOAD_COMPRESS),lz4)
+FW_PAYLOAD_PATH_EMBED=$(platform_build_dir)/firmware/payload.bin.lz4
+firmware-genflags-$(FW_PAYLOAD) += -DFW_PAYLOAD_LZ4
+firmware-genflags-$(FW_PAYLOAD) += -DFW_PAYLOAD_LZ4_INFO=\"$(FW_PAYLOAD_PATH_EMBED).h\"
+else
+FW_PAYLOAD_PATH_EMBED=$(FW_PAYLOAD_PATH_FINAL)
+endif
+firmware-genflags-$(FW_PAYLOAD) += -DFW_PAYLOAD_PATH=\"$(FW_PAYLOAD_PATH_EMBED)\"
 ifdef FW_PAYLOAD_OFFSET
 firmware-genflags-$(FW_PAYLOAD) += -DFW_PAYLOAD_OFFSET=$(FW_PAYLOAD_OFFSET)
 endif
@@ -0,0 +1,183 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+/*
+ * Ping-pong latency benchmark of inter-domain channels
+ *
+ * The same binary is loaded as next stage of two domains connected by
+ * a channel. The next_arg1 of each domain selects the channel (bits
+ * [15:0]) and the role (bit 16 clear for ping and set for pong). The
+ * code is position independent so both copies can be loaded at any
+ * address.
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_ecall_interface.h>
+
+#define DCHAN_BENCH_ARG1_CHAN_MASK	0xffffUL
+#define DCHAN_BENCH_ARG1_PONG		(1UL << 16)
+
+#define DCHAN_BENCH_READY		0x52454459UL
+#define DCHAN_BENCH_ITERATIONS		1000
+
+/* Layout of the channel shared memory */
+struct dchan_bench_shmem {
+	volatile unsigned long ready;
+	volatile unsigned long ping;
+	volatile unsigned long pong;
+};
+
+struct sbiret {
+	long error;
+	unsigned long value;
+};
+
+#define SBI_ECALL(__ext, __fid, __a0, __a1, __a2)                             \
+	({                                                                    \
+		struct sbiret __ret;                                          \
+		register unsigned long a0 asm("a0") = (unsigned long)(__a0);  \
+		register unsigned long a1 asm("a1") = (unsigned long)(__a1);  \
+		register unsigned long a2 asm("a2") = (unsigned long)(__a2);  \
+		register unsigned long a6 asm("a6") = (unsigned long)(__fid); \
+		register unsigned long a7 asm("a7") = (unsigned long)(__ext); \
+		asm volatile("ecall"                                          \
+			     : "+r"(a0), "+r"(a1)                             \
+			     : "r"(a2), "r"(a6), "r"(a7)                      \
+			     : "memory");                                     \
+		__ret.error = a0;                                             \
+		__ret.value = a1;                                             \
+		__ret;                                                        \
+	})
+
+#define sbi_ecall_console_putc(c) \
+	SBI_ECALL(SBI_EXT_0_1_CONSOLE_PUTCHAR, 0, (c), 0, 0)
+
+static void sbi_ecall_console_puts(const char *str)
+{
+	while (str && *str)
+		sbi_ecall_console_putc(*str++);
+}
+
+static void print_ulong(unsigned long val)
+{
+	int i = 0;
+	char buf[24];
+
+	do {
+		buf[i++] = '0' + (val % 10);
+		val /= 10;
+	} while (val);
+
+	while (i)
+		sbi_ecall_console_putc(buf[--i]);
+}
+
+static inline unsigned long read_time(void)
+{
+	unsigned long t;
+
+	__asm__ __volatile__("rdtime %0" : "=r"(t));
+	return t;
+}
+
+/*
+ * Wait for a value in shared memory
+ *
+ * The doorbell sets sip.SSIP so clearing it before checking the shared
+ * memory ensures that wfi() does not sleep over a missed doorbell.
+ */
+static void dchan_wait(volatile unsigned long *ptr, unsigned long val)
+{
+	while (1) {
+		csr_clear(CSR_SIP, MIP_SSIP);
+		if (*ptr == val)
+			break;
+		wfi();
+	}
+}
+
+static void dchan_ring(unsigned long chan)
+{
+	/* Order shared memory writes before the doorbell */
+	__asm__ __volatile__("fence rw, rw" ::: "memory");
+	SBI_ECALL(SBI_EXT_DCHAN, SBI_EXT_DCHAN_RING, chan, 0, -1UL);
+}
+
+static void dchan_pong(unsigned long chan, struct dchan_bench_shmem *shm)
+{
+	unsigned long i;
+
+	shm->ping = 0;
+	shm->pong = 0;
+	__asm__ __volatile__("fence rw, rw" ::: "memory");
+	shm->ready = DCHAN_BENCH_READY;
+	dchan_ring(chan);
+
+	for (i = 1; i <= DCHAN_BENCH_ITERATIONS; i++) {
+		dchan_wait(&shm->ping, i);
+		shm->pong = i;
+		dchan_ring(chan);
+	}
+
+	sbi_ecall_console_puts("dchan_bench: pong done\n");
+}
+
+static void dchan_ping(unsigned long chan, struct dchan_bench_shmem *shm)
+{
+	unsigned long i, start, delta;
+	unsigned long min = -1UL, max = 0, total = 0;
+
+	dchan_wait(&shm->ready, DCHAN_BENCH_READY);
+
+	for (i = 1; i <= DCHAN_BENCH_ITERATIONS; i++) {
+		start = read_time();
+		shm->ping = i;
+		dchan_ring(chan);
+		dchan_wait(&shm->pong, i);
+		delta = read_time() - start;
+
+		if (delta < min)
+			min = delta;
+		if (max < delta)
+			max = delta;
+		total += delta;
+	}
+
+	sbi_ecall_console_puts("dchan_bench: round trip ticks min=");
+	print_ulong(min);
+	sbi_ecall_console_puts(" avg=");
+	print_ulong(total / DCHAN_BENCH_ITERATIONS);
+	sbi_ecall_console_puts(" max=");
+	print_ulong(max);
+	sbi_ecall_console_puts("\n");
+}
+
+void test_main(unsigned long a0, unsigned long a1)
+{
+	struct sbiret ret;
+	unsigned long chan = a1 & DCHAN_BENCH_ARG1_CHAN_MASK;
+
+	ret = SBI_ECALL(SBI_EXT_DCHAN, SBI_EXT_DCHAN_GET_SIZE, chan, 0, 0);
+	if (ret.error || ret.value < sizeof(struct dchan_bench_shmem)) {
+		sbi_ecall_console_puts("dchan_bench: channel not usable\n");
+		goto done;
+	}
+
+	ret = SBI_ECALL(SBI_EXT_DCHAN, SBI_EXT_DCHAN_GET_ADDR, chan, 0, 0);
+	if (ret.error)
+		goto done;
+
+	/* Doorbells are taken as wakeups from wfi() without traps */
+	csr_clear(CSR_SSTATUS, SSTATUS_SIE);
+	csr_set(CSR_SIE, MIP_SSIP);
+
+	if (a1 & DCHAN_BENCH_ARG1_PONG)
+		dchan_pong(chan, (struct dchan_bench_shmem *)ret.value);
+	else
+		dchan_ping(chan, (struct dchan_bench_shmem *)ret.value);
+
+done:
+	while (1)
+		wfi();
+}
@@ -0,0 +1,14 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __ECALL_REPLAY_H__
+#define __ECALL_REPLAY_H__
+
+/** Maximum number of HARTs (and HART id) replaying SBI calls */
+#define ECALL_REPLAY_MAX_HARTS		8
+
+/** Size of per-HART stack as power of 2 */
+#define ECALL_REPLAY_STACK_SHIFT	13
+
+#endif
@@ -0,0 +1,446 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+/*
+ * Offline replay of recorded SBI calls
+ *
+ * A record buffer dumped from a system running with the SBI call
+ * recorder is loaded in memory described by a "opensbi,record-replay"
+ * compatible DT node under /reserved-memory. Each ring is replayed on
+ * the HART which recorded it with the original inter-arrival timing and
+ * the latency of each replayed SBI call is accumulated per extension and
+ * function ID.
+ */
+
+#include <libfdt.h>
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_record.h>
+#include "ecall_replay.h"
+
+/* Maximum number of distinct SBI calls in the report */
+#define REPLAY_MAX_CALLS		32
+
+/* Number of log2 buckets of latency histogram */
+#define REPLAY_HIST_BUCKETS		16
+
+/* Timer ticks given to HARTs for getting ready */
+#define REPLAY_START_DELAY		100000
+
+struct sbiret {
+	long error;
+	unsigned long value;
+};
+
+#define SBI_ECALL(__ext, __fid, __a0, __a1, __a2, __a3, __a4, __a5)          \
+	({                                                                    \
+		struct sbiret __ret;                                          \
+		register unsigned long a0 asm("a0") = (unsigned long)(__a0);  \
+		register unsigned long a1 asm("a1") = (unsigned long)(__a1);  \
+		register unsigned long a2 asm("a2") = (unsigned long)(__a2);  \
+		register unsigned long a3 asm("a3") = (unsigned long)(__a3);  \
+		register unsigned long a4 asm("a4") = (unsigned long)(__a4);  \
+		register unsigned long a5 asm("a5") = (unsigned long)(__a5);  \
+		register unsigned long a6 asm("a6") = (unsigned long)(__fid); \
+		register unsigned long a7 asm("a7") = (unsigned long)(__ext); \
+		asm volatile("ecall"                                          \
+			     : "+r"(a0), "+r"(a1)                             \
+			     : "r"(a2), "r"(a3), "r"(a4), "r"(a5), "r"(a6),   \
+			       "r"(a7)                                        \
+			     : "memory");                                     \
+		__ret.error = a0;                                             \
+		__ret.value = a1;                                             \
+		__ret;                                                        \
+	})
+
+#define sbi_ecall_console_putc(c) \
+	SBI_ECALL(SBI_EXT_0_1_CONSOLE_PUTCHAR, 0, (c), 0, 0, 0, 0, 0)
+
+struct replay_stat {
+	unsigned long extid;
+	unsigned long funcid;
+	unsigned long count;
+	unsigned long min;
+	unsigned long max;
+	unsigned long total;
+	unsigned long hist[REPLAY_HIST_BUCKETS];
+};
+
+struct replay_hart {
+	const struct sbi_record_ring *ring;
+	unsigned long first;
+	unsigned long count;
+	unsigned long replayed;
+	unsigned long skipped;
+	unsigned long max_late;
+	unsigned long dropped;
+	struct replay_stat stats[REPLAY_MAX_CALLS];
+};
+
+static struct replay_hart replay_harts[ECALL_REPLAY_MAX_HARTS];
+static struct replay_stat replay_total[REPLAY_MAX_CALLS];
+static u32 replay_entries;
+static u64 replay_time0;
+static volatile unsigned long replay_start;
+static unsigned long replay_go;
+static unsigned long replay_done;
+
+void _start_secondary(void);
+
+static void console_puts(const char *str)
+{
+	while (str && *str)
+		sbi_ecall_console_putc(*str++);
+}
+
+static void console_putdec(unsigned long val)
+{
+	int i = 0;
+	char buf[24];
+
+	do {
+		buf[i++] = '0' + (val % 10);
+		val /= 10;
+	} while (val);
+
+	while (i)
+		sbi_ecall_console_putc(buf[--i]);
+}
+
+static void console_puthex(unsigned long val)
+{
+	int i;
+	unsigned long d;
+
+	console_puts("0x");
+	for (i = sizeof(val) * 8 - 4; i >= 0; i -= 4) {
+		d = (val >> i) & 0xf;
+		sbi_ecall_console_putc((d < 10) ? '0' + d : 'a' + d - 10);
+	}
+}
+
+static inline unsigned long read_time(void)
+{
+	unsigned long t;
+
+	__asm__ __volatile__("rdtime %0" : "=r"(t));
+	return t;
+}
+
+/*
+ * Only SBI calls without side effects outside the replaying HARTs and
+ * without pointers to memory of the recorded system are replayed.
+ */
+static int replay_allowed(unsigned long extid, unsigned long funcid)
+{
+	switch (extid) {
+	case SBI_EXT_0_1_SET_TIMER:
+	case SBI_EXT_0_1_CLEAR_IPI:
+	case SBI_EXT_BASE:
+	case SBI_EXT_TIME:
+	case SBI_EXT_IPI:
+	case SBI_EXT_RFENCE:
+		return 1;
+	case SBI_EXT_HSM:
+		return (funcid == SBI_EXT_HSM_HART_GET_STATUS) ? 1 : 0;
+	default:
+		return 0;
+	}
+}
+
+static unsigned long hist_bucket(unsigned long ticks)
+{
+	unsigned long b = 0;
+
+	while (ticks && b < (REPLAY_HIST_BUCKETS - 1)) {
+		ticks >>= 1;
+		b++;
+	}
+
+	return b;
+}
+
+static struct replay_stat *stat_find(struct replay_stat *stats,
+				     unsigned long extid,
+				     unsigned long funcid)
+{
+	int i;
+
+	for (i = 0; i < REPLAY_MAX_CALLS; i++) {
+		if (!stats[i].count) {
+			stats[i].extid = extid;
+			stats[i].funcid = funcid;
+			stats[i].min = -1UL;
+			return &stats[i];
+		}
+		if (stats[i].extid == extid && stats[i].funcid == funcid)
+			return &stats[i];
+	}
+
+	return 0;
+}
+
+static void stat_merge(struct replay_stat *dst, const struct replay_stat *src)
+{
+	int i;
+
+	if (!dst->count || src->min < dst->min)
+		dst->min = src->min;
+	if (dst->max < src->max)
+		dst->max = src->max;
+	dst->count += src->count;
+	dst->total += src->total;
+	for (i = 0; i < REPLAY_HIST_BUCKETS; i++)
+		dst->hist[i] += src->hist[i];
+}
+
+static void replay_ring(struct replay_hart *rh)
+{
+	struct replay_stat *st;
+	const struct sbi_record *rec;
+	unsigned long i, due, now, lat;
+
+	/* Pairs with the release store so replay_start is visible */
+	while (!__atomic_load_n(&replay_go, __ATOMIC_ACQUIRE))
+		;
+
+	for (i = 0; i < rh->count; i++) {
+		rec = &rh->ring->records[(rh->first + i) & (replay_entries - 1)];
+
+		/* Keep original inter-arrival timing */
+		due = replay_start + (unsigned long)(rec->time - replay_time0);
+		while ((long)(due - read_time()) > 0)
+			;
+		now = read_time();
+		if (rh->max_late < now - due)
+			rh->max_late = now - due;
+
+		if (!replay_allowed(rec->extid, rec->funcid)) {
+			rh->skipped++;
+			continue;
+		}
+
+		now = read_time();
+		SBI_ECALL(rec->extid, rec->funcid,
+			  rec->args[0], rec->args[1], rec->args[2],
+			  rec->args[3], rec->args[4], rec->args[5]);
+		lat = read_time() - now;
+
+		rh->replayed++;
+		st = stat_find(rh->stats, rec->extid, rec->funcid);
+		if (!st) {
+			rh->dropped++;
+			continue;
+		}
+		if (lat < st->min)
+			st->min = lat;
+		if (st->max < lat)
+			st->max = lat;
+		st->total += lat;
+		st->hist[hist_bucket(lat)]++;
+		st->count++;
+	}
+
+	__atomic_add_fetch(&replay_done, 1, __ATOMIC_SEQ_CST);
+}
+
+static const struct sbi_record_header *replay_find_buffer(void *fdt,
+							 unsigned long *size)
+{
+	const fdt32_t *reg;
+	u64 addr = 0, sz = 0;
+	int i, len, rmem, node, ac, sc;
+
+	rmem = fdt_path_offset(fdt, "/reserved-memory");
+	if (rmem < 0)
+		return 0;
+
+	node = fdt_node_offset_by_compatible(fdt, rmem,
+					     "opensbi,record-replay");
+	if (node < 0)
+		return 0;
+
+	ac = fdt_address_cells(fdt, rmem);
+	sc = fdt_size_cells(fdt, rmem);
+	reg = fdt_getprop(fdt, node, "reg", &len);
+	if (ac < 1 || sc < 1 || !reg || len < (ac + sc) * 4)
+		return 0;
+
+	for (i = 0; i < ac; i++)
+		addr = (addr << 32) | fdt32_to_cpu(reg[i]);
+	for (i = 0; i < sc; i++)
+		sz = (sz << 32) | fdt32_to_cpu(reg[ac + i]);
+
+	*size = sz;
+	return (const struct sbi_record_header *)(unsigned long)addr;
+}
+
+/* The dumped buffer is checked like any other untrusted input */
+static int replay_check_buffer(const struct sbi_record_header *hdr,
+			       unsigned long size)
+{
+	unsigned long ring_bytes;
+
+	if (size < sizeof(*hdr) || hdr->magic != SBI_RECORD_MAGIC ||
+	    hdr->version != SBI_RECORD_VERSION ||
+	    hdr->record_size != sizeof(struct sbi_record))
+		return -1;
+
+	if (!hdr->ring_count || ECALL_REPLAY_MAX_HARTS < hdr->ring_count ||
+	    hdr->ring_entries < 2 ||
+	    (hdr->ring_entries & (hdr->ring_entries - 1)) ||
+	    hdr->ring_offset < sizeof(*hdr) || (hdr->ring_offset & 0x7) ||
+	    (hdr->ring_size & 0x7))
+		return -1;
+
+	ring_bytes = sizeof(struct sbi_record_ring) +
+		     (unsigned long)hdr->ring_entries * sizeof(struct sbi_record);
+	if (hdr->ring_size < ring_bytes ||
+	    size < hdr->ring_offset +
+		   (unsigned long)hdr->ring_count * hdr->ring_size)
+		return -1;
+
+	return 0;
+}
+
+static void replay_report(u32 harts)
+{
+	u32 h;
+	int i, b;
+	struct replay_hart *rh;
+	struct replay_stat *st;
+	unsigned long replayed = 0, skipped = 0, dropped = 0, max_late = 0;
+
+	for (h = 0; h < harts; h++) {
+		rh = &replay_harts[h];
+		replayed += rh->replayed;
+		skipped += rh->skipped;
+		dropped += rh->dropped;
+		if (max_late < rh->max_late)
+			max_late = rh->max_late;
+		for (i = 0; i < REPLAY_MAX_CALLS && rh->stats[i].count; i++) {
+			st = stat_find(replay_total, rh->stats[i].extid,
+				       rh->stats[i].funcid);
+			if (st)
+				stat_merge(st, &rh->stats[i]);
+		}
+	}
+
+	console_puts("ecall_replay: replayed=");
+	console_putdec(replayed);
+	console_puts(" skipped=");
+	console_putdec(skipped);
+	console_puts(" unreported=");
+	console_putdec(dropped);
+	console_puts(" max_late_ticks=");
+	console_putdec(max_late);
+	console_puts("\n");
+
+	for (i = 0; i < REPLAY_MAX_CALLS && replay_total[i].count; i++) {
+		st = &replay_total[i];
+		console_puts("ext=");
+		console_puthex(st->extid);
+		console_puts(" fid=");
+		console_putdec(st->funcid);
+		console_puts(" count=");
+		console_putdec(st->count);
+		console_puts(" min=");
+		console_putdec(st->min);
+		console_puts(" avg=");
+		console_putdec(st->total / st->count);
+		console_puts(" max=");
+		console_putdec(st->max);
+		console_puts("\n  hist(ticks<2^n):");
+		for (b = 0; b < REPLAY_HIST_BUCKETS; b++) {
+			if (!st->hist[b])
+				continue;
+			console_puts(" ");
+			console_putdec(b);
+			console_puts(":");
+			console_putdec(st->hist[b]);
+		}
+		console_puts("\n");
+	}
+}
+
+void replay_secondary(unsigned long hartid, unsigned long index)
+{
+	replay_ring(&replay_harts[index]);
+
+	while (1)
+		wfi();
+}
+
+void replay_main(unsigned long hartid, unsigned long fdt)
+{
+	u32 i;
+	long rc;
+	u64 head;
+	unsigned long size, started = 0;
+	struct replay_hart *rh, *self = 0;
+	const struct sbi_record_header *hdr;
+
+	console_puts("\necall_replay: starting\n");
+
+	hdr = replay_find_buffer((void *)fdt, &size);
+	if (!hdr || replay_check_buffer(hdr, size)) {
+		console_puts("ecall_replay: no valid record buffer\n");
+		goto done;
+	}
+	replay_entries = hdr->ring_entries;
+
+	/* Replay window of each ring and earliest recorded time */
+	replay_time0 = -1ULL;
+	for (i = 0; i < hdr->ring_count; i++) {
+		rh = &replay_harts[i];
+		rh->ring = (const void *)hdr + hdr->ring_offset +
+			   (unsigned long)i * hdr->ring_size;
+		head = rh->ring->head;
+		rh->count = (head < replay_entries) ? head : replay_entries;
+		rh->first = head - rh->count;
+		if (rh->count && rh->ring->records[rh->first &
+				(replay_entries - 1)].time < replay_time0)
+			replay_time0 = rh->ring->records[rh->first &
+				(replay_entries - 1)].time;
+	}
+
+	/* Start other HARTs on the HART ids which recorded the rings */
+	for (i = 0; i < hdr->ring_count; i++) {
+		rh = &replay_harts[i];
+		if (rh->ring->hartid == hartid) {
+			self = rh;
+			started++;
+			continue;
+		}
+
+		rc = -1;
+		if (rh->ring->hartid < ECALL_REPLAY_MAX_HARTS)
+			rc = SBI_ECALL(SBI_EXT_HSM, SBI_EXT_HSM_HART_START,
+				       rh->ring->hartid, _start_secondary, i,
+				       0, 0, 0).error;
+		if (rc) {
+			console_puts("ecall_replay: can't start HART ");
+			console_putdec(rh->ring->hartid);
+			console_puts("\n");
+			rh->count = 0;
+			continue;
+		}
+		started++;
+	}
+
+	replay_start = read_time() + REPLAY_START_DELAY;
+	__atomic_store_n(&replay_go, 1, __ATOMIC_RELEASE);
+
+	if (self)
+		replay_ring(self);
+
+	while (__atomic_load_n(&replay_done, __ATOMIC_SEQ_CST) < started)
+		;
+
+	replay_report(hdr->ring_count);
+
+done:
+	while (1)
+		wfi();
+}
@@ -17,3 +17,36 @@ test-y += test_main.o
 
 %/test.dep: $(foreach dep,$(test-y:.o=.dep),%/$(dep))
 	$(call merge_deps,$@,$^)
+
+firmware-bins-$(FW_PAYLOAD_BENCH) += payloads/dchan_bench.bin
+
+dchan_bench-y += test_head.o
+dchan_bench-y += dchan_bench_main.o
+
+%/dchan_bench.o: $(foreach obj,$(dchan_bench-y),%/$(obj))
+	$(call merge_objs,$@,$^)
+
+%/dchan_bench.dep: $(foreach dep,$(dchan_bench-y:.o=.dep),%/$(dep))
+	$(call merge_deps,$@,$^)
+
+firmware-bins-$(FW_PAYLOAD_BENCH) += payloads/ecall_replay.bin
+
+ecall_replay-y += ecall_replay_head.o
+ecall_replay-y += ecall_replay_main.o
+
+%/ecall_replay.o: $(foreach obj,$(ecall_replay-y),%/$(obj))
+	$(call merge_objs,$@,$^)
+
+%/ecall_replay.dep: $(foreach dep,$(ecall_replay-y:.o=.dep),%/$(dep))
+	$(call merge_deps,$@,$^)
+
+firmware-bins-$(FW_PAYLOAD_BENCH) += payloads/susp_bench.bin
+
+susp_bench-y += test_head.o
+susp_bench-y += susp_bench_main.o
+
+%/susp_bench.o: $(foreach obj,$(susp_bench-y),%/$(obj))
+	$(call merge_objs,$@,$^)
+
+%/susp_bench.dep: $(foreach dep,$(susp_bench-y:.o=.dep),%/$(dep))
+	$(call merge_deps,$@,$^)
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+/*
+ * System suspend resume latency benchmark
+ *
+ * The payload repeatedly suspends the system with the S-mode timer
+ * programmed as wake up source and resumes at _start_warm, which calls
+ * test_main() again without clearing BSS. The resume latency is the
+ * number of timer ticks between expiry of the S-mode timer and the
+ * payload running again. All other HARTs must be stopped so the payload
+ * is meant to run on a single HART.
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_types.h>
+
+#define SUSP_BENCH_ITERATIONS		100
+#define SUSP_BENCH_SLEEP_TICKS		10000
+
+struct sbiret {
+	long error;
+	unsigned long value;
+};
+
+#define SBI_ECALL(__ext, __fid, __a0, __a1, __a2)                             \
+	({                                                                    \
+		struct sbiret __ret;                                          \
+		register unsigned long a0 asm("a0") = (unsigned long)(__a0);  \
+		register unsigned long a1 asm("a1") = (unsigned long)(__a1);  \
+		register unsigned long a2 asm("a2") = (unsigned long)(__a2);  \
+		register unsigned long a6 asm("a6") = (unsigned long)(__fid); \
+		register unsigned long a7 asm("a7") = (unsigned long)(__ext); \
+		asm volatile("ecall"                                          \
+			     : "+r"(a0), "+r"(a1)                             \
+			     : "r"(a2), "r"(a6), "r"(a7)                      \
+			     : "memory");                                     \
+		__ret.error = a0;                                             \
+		__ret.value = a1;                                             \
+		__ret;                                                        \
+	})
+
+#define sbi_ecall_console_putc(c) \
+	SBI_ECALL(SBI_EXT_0_1_CONSOLE_PUTCHAR, 0, (c), 0, 0)
+
+/* Resume entry of test_head.S */
+extern char _start_warm[];
+
+/* Kept across suspend because _start_warm does not clear BSS */
+static unsigned long iterations;
+static u64 wake_deadline;
+static u64 lat_min = -1ULL, lat_max, lat_total;
+
+static void sbi_ecall_console_puts(const char *str)
+{
+	while (str && *str)
+		sbi_ecall_console_putc(*str++);
+}
+
+static void print_ulong(unsigned long val)
+{
+	int i = 0;
+	char buf[24];
+
+	do {
+		buf[i++] = '0' + (val % 10);
+		val /= 10;
+	} while (val);
+
+	while (i)
+		sbi_ecall_console_putc(buf[--i]);
+}
+
+#if __riscv_xlen == 32
+static u64 read_time(void)
+{
+	u32 lo, hi, tmp;
+
+	__asm__ __volatile__("1:\n"
+			     "rdtimeh %0\n"
+			     "rdtime %1\n"
+			     "rdtimeh %2\n"
+			     "bne %0, %2, 1b"
+			     : "=&r"(hi), "=&r"(lo), "=&r"(tmp));
+	return ((u64)hi << 32) | lo;
+}
+
+static void set_timer(u64 stime)
+{
+	SBI_ECALL(SBI_EXT_TIME, SBI_EXT_TIME_SET_TIMER,
+		  (u32)stime, (u32)(stime >> 32), 0);
+}
+#else
+static u64 read_time(void)
+{
+	unsigned long t;
+
+	__asm__ __volatile__("rdtime %0" : "=r"(t));
+	return t;
+}
+
+static void set_timer(u64 stime)
+{
+	SBI_ECALL(SBI_EXT_TIME, SBI_EXT_TIME_SET_TIMER, stime, 0, 0);
+}
+#endif
+
+static void susp_bench_report(void)
+{
+	sbi_ecall_console_puts("susp_bench: resume latency ticks min=");
+	print_ulong(lat_min);
+	sbi_ecall_console_puts(" avg=");
+	print_ulong(lat_total / SUSP_BENCH_ITERATIONS);
+	sbi_ecall_console_puts(" max=");
+	print_ulong(lat_max);
+	sbi_ecall_console_puts("\n");
+}
+
+void test_main(unsigned long a0, unsigned long a1)
+{
+	u64 delta;
+	struct sbiret ret;
+
+	if (iterations) {
+		delta = read_time() - wake_deadline;
+		if (delta < lat_min)
+			lat_min = delta;
+		if (lat_max < delta)
+			lat_max = delta;
+		lat_total += delta;
+
+		/* Clear the pending S-mode timer interrupt */
+		set_timer(-1ULL);
+	}
+
+	if (iterations == SUSP_BENCH_ITERATIONS) {
+		susp_bench_report();
+		goto done;
+	}
+	iterations++;
+
+	/* Timer interrupt wakes up the system without trapping */
+	csr_clear(CSR_SSTATUS, SSTATUS_SIE);
+	csr_set(CSR_SIE, MIP_STIP);
+	wake_deadline = read_time() + SUSP_BENCH_SLEEP_TICKS;
+	set_timer(wake_deadline);
+
+	ret = SBI_ECALL(SBI_EXT_SUSP, SBI_EXT_SUSP_SYSTEM_SUSPEND,
+			SBI_SUSP_SLEEP_TYPE_SUSPEND, _start_warm, 0);
+	sbi_ecall_console_puts("susp_bench: system suspend failed error=");
+	print_ulong(-ret.error);
+	sbi_ecall_console_puts("\n");
+
+done:
+	while (1)
+		wfi();
+}
@@ -157,8 +157,21 @@ void csr_write_num(int csr_num, unsigned long val);
 		__asm__ __volatile__("wfi" ::: "memory"); \
 	} while (0)
 
-/* Get current HART id */
-#define current_hartid()	((unsigned int)csr_read(CSR_MHARTID))
+/*
+ * Zicbom cache block operations encoded using .insn so that older
+ * toolchains without Zicbom support can still build OpenSBI.
+ */
+#define __cbo_op(__op, __addr)                                          \
+	do {                                                            \
+		__asm__ __volatile__(".insn i 0x0f, 2, x0, %0, " #__op  \
+				     :                                  \
+				     : "r"(__addr)                      \
+				     : "memory");                       \
+	} while (0)
+
+#define cbo_inval(addr)		__cbo_op(0, addr)
+#define cbo_clean(addr)		__cbo_op(1, addr)
+#define cbo_flush(addr)		__cbo_op(2, addr)
 
 /* determine CPU extension, return non-zero support */
 int misa_extension_imp(char ext);
@@ -176,6 +189,8 @@ int misa_xlen(void);
 /* Get RISC-V ISA string representation */
 void misa_string(int xlen, char *out, unsigned int out_sz);
 
+int pmp_disable(unsigned int n);
+
 int pmp_set(unsigned int n, unsigned long prot, unsigned long addr,
 	    unsigned long log2len);
 
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_CACHE_H__
+#define __SBI_CACHE_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Cache block size assumed when the platform does not provide one */
+#define SBI_CACHE_BLOCK_SIZE_DEFAULT		64
+
+/* clang-format on */
+
+/** Cache maintenance operation types */
+enum sbi_cache_op_type {
+	/** Write back dirty cache blocks */
+	SBI_CACHE_CLEAN = 0,
+	/** Discard cache blocks without write back */
+	SBI_CACHE_INVAL,
+	/** Write back and then discard cache blocks */
+	SBI_CACHE_FLUSH,
+	SBI_CACHE_OP_MAX
+};
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_ECALL_CACHE
+
+unsigned long sbi_cache_block_size(void);
+
+int sbi_cache_op(u32 type, unsigned long addr, unsigned long size);
+
+int sbi_cache_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline int sbi_cache_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
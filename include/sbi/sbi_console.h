@@ -14,6 +14,15 @@
 
 #define __printf(a, b) __attribute__((format(printf, a, b)))
 
+/** Console output modes */
+enum sbi_console_mode {
+	/** Messages are written to the console device in one go */
+	SBI_CONSOLE_MODE_BUFFERED = 0,
+	/** Each character is written to the console device right away */
+	SBI_CONSOLE_MODE_UNBUFFERED,
+	SBI_CONSOLE_MODE_MAX
+};
+
 bool sbi_isprintable(char ch);
 
 int sbi_getc(void);
@@ -32,6 +41,10 @@ int __printf(1, 2) sbi_printf(const char *format, ...);
 
 int __printf(1, 2) sbi_dprintf(const char *format, ...);
 
+u32 sbi_console_get_mode(void);
+
+int sbi_console_set_mode(u32 mode);
+
 struct sbi_scratch;
 
 int sbi_console_init(struct sbi_scratch *scratch);
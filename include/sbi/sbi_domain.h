@@ -78,6 +78,33 @@ struct sbi_domain {
 	unsigned long next_mode;
 	/** Is domain allowed to reset the system */
 	bool system_reset_allowed;
+	/** Address of SBI shared page of this domain (zero if not used) */
+	unsigned long shared_page;
+	/**
+	 * HARTs of other domains time-shared with this domain (NULL if none)
+	 * Note: These are added to assigned HARTs by the domain scheduler
+	 */
+	const struct sbi_hartmask *shared_harts;
+	/** Time slice of this domain on time-shared HARTs (timer ticks) */
+	unsigned long time_budget;
+};
+
+/** Maximum number of inter-domain channels */
+#define SBI_DOMAIN_MAX_CHANNELS			16
+
+/** Representation of OpenSBI inter-domain shared memory channel */
+struct sbi_domain_channel {
+	/**
+	 * Logical index of this channel
+	 * Note: This set by sbi_domain_channel_register()
+	 */
+	u32 index;
+	/** Name of this channel */
+	char name[64];
+	/** Shared memory of this channel (flags are ignored) */
+	struct sbi_domain_memregion region;
+	/** Domains connected by this channel */
+	struct sbi_domain *peers[2];
 };
 
 /** HART id to domain table */
@@ -98,6 +125,10 @@ extern struct sbi_domain *domidx_to_domain_table[];
 #define sbi_index_to_domain(__index) \
 	domidx_to_domain_table[__index]
 
+/** Get pointer to ROOT domain (always the first registered domain) */
+#define sbi_domain_root_ptr() \
+	sbi_index_to_domain(0)
+
 /** Iterate over each domain */
 #define sbi_domain_for_each(__i, __d) \
 	for ((__i) = 0; ((__d) = sbi_index_to_domain(__i)); (__i)++)
@@ -140,6 +171,50 @@ bool sbi_domain_check_addr(const struct sbi_domain *dom,
 			   unsigned long addr, unsigned long mode,
 			   unsigned long access_flags);
 
+/**
+ * Check whether we can access every address of specified range for
+ * given mode and memory region flags under a domain
+ * @param dom pointer to domain
+ * @param addr the start of the range to be checked
+ * @param size the size of the range to be checked
+ * @param mode the privilege mode of access
+ * @param access_flags bitmask of domain access types (enum sbi_domain_access)
+ * @return TRUE if access allowed otherwise FALSE
+ */
+bool sbi_domain_check_addr_range(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long size,
+				 unsigned long mode,
+				 unsigned long access_flags);
+
+/**
+ * Register an inter-domain channel
+ *
+ * This has to be called from platform domains_init() because channels
+ * are validated by sbi_domain_finalize().
+ *
+ * @param chan pointer to channel
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_domain_channel_register(struct sbi_domain_channel *chan);
+
+/**
+ * Get an inter-domain channel
+ * @param index the channel index
+ * @return pointer to channel or NULL if no such channel
+ */
+struct sbi_domain_channel *sbi_domain_channel_get(u32 index);
+
+/**
+ * Get the peer of a domain on an inter-domain channel
+ * @param chan pointer to channel
+ * @param dom pointer to domain
+ * @return pointer to the other domain of the channel or NULL if the
+ * domain is not connected by the channel
+ */
+struct sbi_domain *sbi_domain_channel_peer(
+				const struct sbi_domain_channel *chan,
+				const struct sbi_domain *dom);
+
 /** Dump domain details on the console */
 void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix);
 
@@ -0,0 +1,104 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_DOMAIN_SCHED_H__
+#define __SBI_DOMAIN_SCHED_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Maximum number of domains time-sharing a HART (including owner) */
+#define SBI_DOMAIN_SCHED_MAX_SLOTS		4
+
+/** Maximum number of domain contexts across all HARTs */
+#define SBI_DOMAIN_SCHED_MAX_CONTEXTS		16
+
+/** Time slice (timer ticks) of domains without time budget */
+#define SBI_DOMAIN_SCHED_DEFAULT_BUDGET		100000
+
+/* clang-format on */
+
+struct sbi_domain;
+struct sbi_scratch;
+struct sbi_trap_regs;
+
+#ifdef CONFIG_SBI_DOMAIN_SCHED
+
+/**
+ * Check whether a domain owns a HART
+ *
+ * Domains time-sharing a HART with its owner can't start or stop it.
+ *
+ * @param dom pointer to domain
+ * @param hartid the HART ID
+ * @return TRUE if HART is not time-shared or domain owns it
+ */
+bool sbi_domain_sched_is_owner(const struct sbi_domain *dom, u32 hartid);
+
+/**
+ * Check whether a HART is time-shared by more than one domain
+ *
+ * Per-HART SBI state (SSE events, firmware time shared memory, etc)
+ * is not switched with the domain so it is refused on such HARTs.
+ *
+ * @param hartid the HART ID
+ * @return TRUE if HART is time-shared
+ */
+bool sbi_domain_sched_is_shared(u32 hartid);
+
+/** Give up rest of the time slice of current domain on current HART */
+int sbi_domain_sched_yield(void);
+
+/** Mark S-mode IPI pending for a domain on a remote HART */
+void sbi_domain_sched_ipi_update(struct sbi_scratch *remote_scratch,
+				 const struct sbi_domain *dom);
+
+/**
+ * Consume S-mode IPI of the domain running on current HART
+ * @return TRUE if S-mode software interrupt has to be raised
+ */
+bool sbi_domain_sched_ipi_process(struct sbi_scratch *scratch);
+
+/** Switch domain on budget expiry or yield just before returning to S-mode */
+void sbi_domain_sched_trap_exit(struct sbi_trap_regs *regs);
+
+int sbi_domain_sched_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline bool sbi_domain_sched_is_owner(const struct sbi_domain *dom,
+					     u32 hartid)
+{
+	return TRUE;
+}
+
+static inline bool sbi_domain_sched_is_shared(u32 hartid)
+{
+	return FALSE;
+}
+
+static inline void sbi_domain_sched_ipi_update(struct sbi_scratch *remote_scratch,
+					       const struct sbi_domain *dom)
+{
+}
+
+static inline bool sbi_domain_sched_ipi_process(struct sbi_scratch *scratch)
+{
+	return TRUE;
+}
+
+static inline void sbi_domain_sched_trap_exit(struct sbi_trap_regs *regs)
+{
+}
+
+static inline int sbi_domain_sched_init(struct sbi_scratch *scratch,
+					bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
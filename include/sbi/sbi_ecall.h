@@ -38,6 +38,18 @@ extern struct sbi_ecall_extension ecall_ipi;
 extern struct sbi_ecall_extension ecall_vendor;
 extern struct sbi_ecall_extension ecall_hsm;
 extern struct sbi_ecall_extension ecall_srst;
+extern struct sbi_ecall_extension ecall_susp;
+extern struct sbi_ecall_extension ecall_cache;
+extern struct sbi_ecall_extension ecall_stack;
+extern struct sbi_ecall_extension ecall_perf_profile;
+extern struct sbi_ecall_extension ecall_shpage;
+extern struct sbi_ecall_extension ecall_fwtime;
+extern struct sbi_ecall_extension ecall_trace;
+extern struct sbi_ecall_extension ecall_mprof;
+extern struct sbi_ecall_extension ecall_sse;
+extern struct sbi_ecall_extension ecall_dsched;
+extern struct sbi_ecall_extension ecall_dchan;
+extern struct sbi_ecall_extension ecall_tune;
 
 u16 sbi_ecall_version_major(void);
 
@@ -47,8 +59,12 @@ unsigned long sbi_ecall_get_impid(void);
 
 void sbi_ecall_set_impid(unsigned long impid);
 
+struct sbi_dlist *sbi_ecall_get_extensions_head(void);
+
 struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid);
 
+int sbi_ecall_probe_extension(unsigned long extid, unsigned long *out_val);
+
 int sbi_ecall_register_extension(struct sbi_ecall_extension *ext);
 
 void sbi_ecall_unregister_extension(struct sbi_ecall_extension *ext);
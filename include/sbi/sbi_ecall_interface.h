@@ -28,6 +28,18 @@
 #define SBI_EXT_RFENCE				0x52464E43
 #define SBI_EXT_HSM				0x48534D
 #define SBI_EXT_SRST				0x53525354
+#define SBI_EXT_SUSP				0x53555350
+#define SBI_EXT_CACHE				0x08434D4F
+#define SBI_EXT_STACK				0x0853544B
+#define SBI_EXT_PERF_PROFILE			0x08505246
+#define SBI_EXT_SHPAGE				0x08534850
+#define SBI_EXT_FWTIME				0x08465754
+#define SBI_EXT_TRACE				0x08545243
+#define SBI_EXT_MPROF				0x084D5052
+#define SBI_EXT_SSE				0x535345
+#define SBI_EXT_DSCHED				0x08445343
+#define SBI_EXT_DCHAN				0x08444348
+#define SBI_EXT_TUNE				0x0854554E
 
 /* SBI function IDs for BASE extension*/
 #define SBI_EXT_BASE_GET_SPEC_VERSION		0x0
@@ -62,6 +74,7 @@
 #define SBI_HSM_HART_STATUS_STOPPED		0x1
 #define SBI_HSM_HART_STATUS_START_PENDING	0x2
 #define SBI_HSM_HART_STATUS_STOP_PENDING	0x3
+#define SBI_HSM_HART_STATUS_SUSPENDED		0x4
 
 /* SBI function IDs for SRST extension */
 #define SBI_EXT_SRST_RESET			0x0
@@ -74,9 +87,122 @@
 #define SBI_SRST_RESET_REASON_NONE	0x0
 #define SBI_SRST_RESET_REASON_SYSFAIL	0x1
 
+/* SBI function IDs for SUSP extension */
+#define SBI_EXT_SUSP_SYSTEM_SUSPEND		0x0
+
+#define SBI_SUSP_SLEEP_TYPE_SUSPEND		0x0
+#define SBI_SUSP_SLEEP_TYPE_LAST		SBI_SUSP_SLEEP_TYPE_SUSPEND
+#define SBI_SUSP_PLATFORM_SLEEP_START		0x80000000
+
+/* SBI function IDs for CACHE extension */
+#define SBI_EXT_CACHE_GET_BLOCK_SIZE		0x0
+#define SBI_EXT_CACHE_CLEAN			0x1
+#define SBI_EXT_CACHE_INVAL			0x2
+#define SBI_EXT_CACHE_FLUSH			0x3
+
+/* SBI function IDs for STACK extension */
+#define SBI_EXT_STACK_GET_SIZE			0x0
+#define SBI_EXT_STACK_GET_USAGE			0x1
+
+/* SBI function IDs for PERF_PROFILE extension */
+#define SBI_EXT_PERF_PROFILE_GET_COUNT		0x0
+#define SBI_EXT_PERF_PROFILE_GET_NAME		0x1
+#define SBI_EXT_PERF_PROFILE_GET_CURRENT	0x2
+#define SBI_EXT_PERF_PROFILE_SWITCH		0x3
+
+/* SBI function IDs for SHPAGE extension */
+#define SBI_EXT_SHPAGE_SET_SHMEM		0x0
+#define SBI_EXT_SHPAGE_GET_SHMEM		0x1
+
+/* SBI function IDs for FWTIME extension */
+#define SBI_EXT_FWTIME_SET_SHMEM		0x0
+
+/* SBI function IDs for TRACE extension */
+#define SBI_EXT_TRACE_GET_BUFFER		0x0
+#define SBI_EXT_TRACE_GET_MASK			0x1
+#define SBI_EXT_TRACE_SET_MASK			0x2
+
+/* SBI function IDs for MPROF extension */
+#define SBI_EXT_MPROF_SET_SHMEM			0x0
+#define SBI_EXT_MPROF_START			0x1
+#define SBI_EXT_MPROF_STOP			0x2
+
+/* SBI function IDs for SSE extension */
+#define SBI_EXT_SSE_READ_ATTRS			0x0
+#define SBI_EXT_SSE_WRITE_ATTRS			0x1
+#define SBI_EXT_SSE_REGISTER			0x2
+#define SBI_EXT_SSE_UNREGISTER			0x3
+#define SBI_EXT_SSE_ENABLE			0x4
+#define SBI_EXT_SSE_DISABLE			0x5
+#define SBI_EXT_SSE_COMPLETE			0x6
+#define SBI_EXT_SSE_INJECT			0x7
+#define SBI_EXT_SSE_HART_UNMASK			0x8
+#define SBI_EXT_SSE_HART_MASK			0x9
+
+/* SBI function IDs for DSCHED extension */
+#define SBI_EXT_DSCHED_YIELD			0x0
+
+/* SBI function IDs for DCHAN extension */
+#define SBI_EXT_DCHAN_GET_ADDR			0x0
+#define SBI_EXT_DCHAN_GET_SIZE			0x1
+#define SBI_EXT_DCHAN_RING			0x2
+
+/* SBI function IDs for TUNE extension */
+#define SBI_EXT_TUNE_FIND_PARAM			0x0
+#define SBI_EXT_TUNE_GET_PARAM			0x1
+#define SBI_EXT_TUNE_SET_PARAM			0x2
+#define SBI_EXT_TUNE_GET_PARAM_MIN		0x3
+#define SBI_EXT_TUNE_GET_PARAM_MAX		0x4
+
+/* SBI SSE event attributes */
+#define SBI_SSE_ATTR_STATUS			0x0
+#define SBI_SSE_ATTR_PRIO			0x1
+#define SBI_SSE_ATTR_CONFIG			0x2
+#define SBI_SSE_ATTR_PREFERRED_HART		0x3
+#define SBI_SSE_ATTR_ENTRY_PC			0x4
+#define SBI_SSE_ATTR_ENTRY_ARG			0x5
+#define SBI_SSE_ATTR_INTERRUPTED_SEPC		0x6
+#define SBI_SSE_ATTR_INTERRUPTED_FLAGS		0x7
+#define SBI_SSE_ATTR_INTERRUPTED_A6		0x8
+#define SBI_SSE_ATTR_INTERRUPTED_A7		0x9
+#define SBI_SSE_ATTR_MAX			0xA
+
+#define SBI_SSE_ATTR_STATUS_STATE_OFFSET	0
+#define SBI_SSE_ATTR_STATUS_STATE_MASK		0x3
+#define SBI_SSE_ATTR_STATUS_PENDING_OFFSET	2
+#define SBI_SSE_ATTR_STATUS_INJECT_OFFSET	3
+
+#define SBI_SSE_ATTR_CONFIG_ONESHOT		(1 << 0)
+
+#define SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPP	(1 << 0)
+#define SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPIE	(1 << 1)
+#define SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPV	(1 << 2)
+#define SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPVP	(1 << 3)
+
+/* SBI SSE event states */
+#define SBI_SSE_STATE_UNUSED			0
+#define SBI_SSE_STATE_REGISTERED		1
+#define SBI_SSE_STATE_ENABLED			2
+#define SBI_SSE_STATE_RUNNING			3
+
+/* SBI SSE event IDs */
+#define SBI_SSE_EVENT_LOCAL_HIGH_PRIO_RAS	0x00000000
+#define SBI_SSE_EVENT_LOCAL_DOUBLE_TRAP		0x00000001
+#define SBI_SSE_EVENT_GLOBAL_HIGH_PRIO_RAS	0x00008000
+#define SBI_SSE_EVENT_LOCAL_PMU_OVERFLOW	0x00010000
+#define SBI_SSE_EVENT_LOCAL_LOW_PRIO_RAS	0x00100000
+#define SBI_SSE_EVENT_GLOBAL_LOW_PRIO_RAS	0x00108000
+#define SBI_SSE_EVENT_LOCAL_SOFTWARE		0xffff0000
+#define SBI_SSE_EVENT_GLOBAL_SOFTWARE		0xffff8000
+
+#define SBI_SSE_EVENT_GLOBAL_BIT		(1 << 15)
+#define SBI_SSE_EVENT_PLATFORM_BIT		(1 << 14)
+
 #define SBI_SPEC_VERSION_MAJOR_OFFSET		24
 #define SBI_SPEC_VERSION_MAJOR_MASK		0x7f
 #define SBI_SPEC_VERSION_MINOR_MASK		0xffffff
+#define SBI_EXT_EXPERIMENTAL_START		0x08000000
+#define SBI_EXT_EXPERIMENTAL_END		0x08FFFFFF
 #define SBI_EXT_VENDOR_START			0x09000000
 #define SBI_EXT_VENDOR_END			0x09FFFFFF
 #define SBI_EXT_FIRMWARE_START			0x0A000000
@@ -90,8 +216,13 @@
 #define SBI_ERR_DENIED				-4
 #define SBI_ERR_INVALID_ADDRESS			-5
 #define SBI_ERR_ALREADY_AVAILABLE		-6
+#define SBI_ERR_ALREADY_STARTED			-7
+#define SBI_ERR_ALREADY_STOPPED			-8
+#define SBI_ERR_NO_SHMEM			-9
+#define SBI_ERR_INVALID_STATE			-10
+#define SBI_ERR_BAD_RANGE			-11
 
-#define SBI_LAST_ERR				SBI_ERR_ALREADY_AVAILABLE
+#define SBI_LAST_ERR				SBI_ERR_BAD_RANGE
 
 /* clang-format on */
 
@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_FWTIME_H__
+#define __SBI_FWTIME_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Categories of time spent by a HART in OpenSBI */
+#define SBI_FWTIME_ECALL			0
+#define SBI_FWTIME_EMULATION			1
+#define SBI_FWTIME_IPI				2
+#define SBI_FWTIME_SYNC_WAIT			3
+#define SBI_FWTIME_OTHER			4
+#define SBI_FWTIME_DOMAIN_SWITCH		5
+#define SBI_FWTIME_MAX				6
+
+/** Pseudo category used while a HART is not executing in OpenSBI */
+#define SBI_FWTIME_NONE				SBI_FWTIME_MAX
+
+/** Alignment of firmware time shared memory */
+#define SBI_FWTIME_SHMEM_ALIGN			64
+
+/** Address passed to SBI_EXT_FWTIME_SET_SHMEM for disabling */
+#define SBI_FWTIME_SHMEM_DISABLE		(-1UL)
+
+/* clang-format on */
+
+/**
+ * Per-HART shared memory updated by OpenSBI before returning to the
+ * lower privilege mode. Readers must retry whenever seq is odd or seq
+ * changed while reading cycles[].
+ */
+struct sbi_fwtime_shmem {
+	/** Sequence counter (odd while OpenSBI updates the memory) */
+	u32 seq;
+	/** Number of valid entries in cycles[] */
+	u32 count;
+	/** Cycles (MCYCLE) spent in OpenSBI indexed by category */
+	u64 cycles[SBI_FWTIME_MAX];
+};
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_ECALL_FWTIME
+
+/**
+ * Start accounting time of current HART to a category
+ * @param cat the new category (SBI_FWTIME_xxx)
+ * @return category to be passed to sbi_fwtime_exit()
+ */
+u32 sbi_fwtime_enter(u32 cat);
+
+/** Go back to category returned by sbi_fwtime_enter() */
+void sbi_fwtime_exit(u32 prev_cat);
+
+/** Get category of a trap based on MCAUSE */
+u32 sbi_fwtime_trap_category(unsigned long mcause);
+
+/** Set (or disable) firmware time shared memory of current HART */
+int sbi_fwtime_set_shmem(unsigned long addr);
+
+int sbi_fwtime_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline u32 sbi_fwtime_enter(u32 cat)
+{
+	return SBI_FWTIME_NONE;
+}
+
+static inline void sbi_fwtime_exit(u32 prev_cat)
+{
+}
+
+static inline u32 sbi_fwtime_trap_category(unsigned long mcause)
+{
+	return SBI_FWTIME_NONE;
+}
+
+static inline int sbi_fwtime_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
@@ -25,8 +25,35 @@ enum sbi_hart_features {
 	SBI_HART_HAS_LAST_FEATURE = SBI_HART_HAS_TIME,
 };
 
+/** ISA extensions of a hart */
+enum sbi_hart_extensions {
+	/** Single letter (MISA) extensions, see SBI_HART_EXT_MISA() */
+	SBI_HART_EXT_MISA_BASE = 0,
+	/** HART has Zbb basic bit manipulation instructions */
+	SBI_HART_EXT_ZBB = SBI_HART_EXT_MISA_BASE + 26,
+	/** HART has Svinval fine-grained address translation cache invalidation */
+	SBI_HART_EXT_SVINVAL,
+	/** HART has Sstc supervisor timer compare */
+	SBI_HART_EXT_SSTC,
+	/** HART has Zicbom cache block management instructions */
+	SBI_HART_EXT_ZICBOM,
+	/** HART has Zawrs wait-on-reservation-set instructions */
+	SBI_HART_EXT_ZAWRS,
+	/** HART has Smaia advanced interrupt architecture */
+	SBI_HART_EXT_SMAIA,
+	/** HART has Sscofpmf counter overflow and mode-based filtering */
+	SBI_HART_EXT_SSCOFPMF,
+
+	/** Maximum index of Hart extensions */
+	SBI_HART_EXT_MAX,
+};
+
+/** Hart extension index of a single letter (MISA) extension */
+#define SBI_HART_EXT_MISA(__ext)	(SBI_HART_EXT_MISA_BASE + ((__ext) - 'A'))
+
 struct sbi_scratch;
 
+int sbi_hart_reinit(struct sbi_scratch *scratch);
 int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot);
 
 extern void (*sbi_hart_expected_trap)(void);
@@ -42,9 +69,17 @@ unsigned int sbi_hart_pmp_count(struct sbi_scratch *scratch);
 unsigned long sbi_hart_pmp_granularity(struct sbi_scratch *scratch);
 unsigned int sbi_hart_pmp_addrbits(struct sbi_scratch *scratch);
 int sbi_hart_pmp_configure(struct sbi_scratch *scratch);
+void sbi_hart_pmp_unconfigure(struct sbi_scratch *scratch);
 bool sbi_hart_has_feature(struct sbi_scratch *scratch, unsigned long feature);
 void sbi_hart_get_features_str(struct sbi_scratch *scratch,
 			       char *features_str, int nfstr);
+bool sbi_hart_has_extension(struct sbi_scratch *scratch,
+			    enum sbi_hart_extensions ext);
+void sbi_hart_update_extension(struct sbi_scratch *scratch,
+			       enum sbi_hart_extensions ext, bool enable);
+const char *sbi_hart_extension_name(enum sbi_hart_extensions ext);
+void sbi_hart_get_extensions_str(struct sbi_scratch *scratch,
+				 char *extensions_str, int nestr);
 
 void __attribute__((noreturn)) sbi_hart_hang(void);
 
@@ -18,6 +18,7 @@
 #define SBI_HART_STARTING	2
 #define SBI_HART_STARTED	3
 #define SBI_HART_UNKNOWN	4
+#define SBI_HART_SUSPENDED	5
 
 struct sbi_domain;
 struct sbi_scratch;
@@ -34,5 +35,9 @@ int sbi_hsm_hart_state_to_status(int state);
 int sbi_hsm_hart_started_mask(const struct sbi_domain *dom,
 			      ulong hbase, ulong *out_hmask);
 void sbi_hsm_prepare_next_jump(struct sbi_scratch *scratch, u32 hartid);
+bool sbi_hsm_hart_others_stopped(u32 hartid);
+int sbi_hsm_hart_suspend(struct sbi_scratch *scratch, u32 hartid);
+void sbi_hsm_hart_resume(struct sbi_scratch *scratch, u32 hartid);
+bool sbi_hsm_hart_suspended(struct sbi_scratch *scratch);
 
 #endif
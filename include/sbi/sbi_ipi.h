@@ -16,8 +16,11 @@
 
 #define SBI_IPI_EVENT_MAX			__riscv_xlen
 
+#define SBI_IPI_CALL_FIFO_NUM_ENTRIES		8
+
 /* clang-format on */
 
+struct sbi_domain;
 struct sbi_scratch;
 
 /** IPI event operations or callbacks */
@@ -49,20 +52,62 @@ struct sbi_ipi_event_ops {
 	void (* process)(struct sbi_scratch *scratch);
 };
 
+/** Function called on target HARTs by sbi_ipi_call() */
+typedef void (*sbi_ipi_call_fn)(void *arg);
+
 int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data);
 
+/**
+ * Call a function on a set of HARTs
+ *
+ * The call is queued on every started HART in the mask and the function
+ * runs from the IPI handler of that HART. If the current HART is in the
+ * mask then it calls the function directly after signalling other HARTs
+ * (and waiting for them when wait is TRUE).
+ *
+ * Note: Without wait, the data pointed by arg must stay valid until all
+ * target HARTs have called the function.
+ *
+ * @param hmask mask of target HARTs relative to hbase
+ * @param hbase first HART id of the mask (-1UL for all started HARTs)
+ * @param fn function to call
+ * @param arg argument passed to the function
+ * @param wait return only after all target HARTs called the function
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_ipi_call(ulong hmask, ulong hbase, sbi_ipi_call_fn fn, void *arg,
+		 bool wait);
+
 int sbi_ipi_event_create(const struct sbi_ipi_event_ops *ops);
 
 void sbi_ipi_event_destroy(u32 event);
 
 int sbi_ipi_send_smode(ulong hmask, ulong hbase);
 
+/**
+ * Raise S-mode software interrupt of a domain on a set of its HARTs
+ *
+ * Same as sbi_ipi_send_smode() except that the HART mask is relative
+ * to the given domain instead of the domain of current HART.
+ *
+ * @param dom the target domain
+ * @param hmask mask of target HARTs relative to hbase
+ * @param hbase first HART id of the mask (-1UL for all started HARTs)
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_ipi_send_smode_domain(const struct sbi_domain *dom,
+			      ulong hmask, ulong hbase);
+
 void sbi_ipi_clear_smode(void);
 
 int sbi_ipi_send_halt(ulong hmask, ulong hbase);
 
 void sbi_ipi_process(void);
 
+void sbi_ipi_process_pending(void);
+
 int sbi_ipi_init(struct sbi_scratch *scratch, bool cold_boot);
 
 void sbi_ipi_exit(struct sbi_scratch *scratch);
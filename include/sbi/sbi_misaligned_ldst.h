@@ -14,6 +14,17 @@
 
 struct sbi_trap_regs;
 
+/** Check whether misaligned loads and stores are emulated */
+bool sbi_misaligned_get_emulate(void);
+
+/**
+ * Enable or disable emulation of misaligned loads and stores
+ *
+ * Misaligned loads and stores are redirected to S-mode (or U-mode)
+ * when emulation is disabled.
+ */
+void sbi_misaligned_set_emulate(bool emulate);
+
 int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 				struct sbi_trap_regs *regs);
 
@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_MPROF_H__
+#define __SBI_MPROF_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Magic value of profiler shared memory header ("SBMP") */
+#define SBI_MPROF_MAGIC				0x504d4253
+
+/** Layout version of profiler shared memory */
+#define SBI_MPROF_VERSION			0x1
+
+/** Offset of first per-HART histogram from start of shared memory */
+#define SBI_MPROF_HIST_OFFSET			64
+
+/** Address passed to SBI_EXT_MPROF_SET_SHMEM for disabling */
+#define SBI_MPROF_SHMEM_DISABLE			(-1UL)
+
+/** Sampling sources */
+#define SBI_MPROF_MODE_NONE			0
+#define SBI_MPROF_MODE_TIMER			1
+#define SBI_MPROF_MODE_COUNTER			2
+
+/** Programmable HPM counter used for overflow based sampling */
+#define SBI_MPROF_COUNTER			3
+
+/* clang-format on */
+
+/** Per-HART histogram of M-mode program counter samples */
+struct sbi_mprof_hist {
+	/** Number of samples taken */
+	u64 samples;
+	/** Number of samples outside the firmware */
+	u64 dropped;
+	/** HART id of the HART taking the samples */
+	u32 hartid;
+	u32 reserved;
+	/** Sample counts indexed by (PC - fw_start) >> bucket_shift */
+	u32 buckets[];
+};
+
+/** Header at the start of profiler shared memory */
+struct sbi_mprof_header {
+	/** Magic value (SBI_MPROF_MAGIC) */
+	u32 magic;
+	/** Layout version (SBI_MPROF_VERSION) */
+	u32 version;
+	/** Number of histograms (indexed by HART index) */
+	u32 hist_count;
+	/** Offset of first histogram from start of shared memory */
+	u32 hist_offset;
+	/** Size of each histogram in bytes */
+	u32 hist_size;
+	/** Number of buckets in each histogram (power of 2) */
+	u32 bucket_count;
+	/** Log2 of number of bytes covered by each bucket */
+	u32 bucket_shift;
+	/** Sampling source (SBI_MPROF_MODE_xxx) */
+	u32 mode;
+	/** Start address of firmware */
+	u64 fw_start;
+	/** Size of firmware */
+	u64 fw_size;
+	/** Sampling period (timer ticks or counter events) */
+	u64 period;
+	u64 reserved;
+};
+
+struct sbi_scratch;
+struct sbi_trap_regs;
+
+#ifdef CONFIG_SBI_MPROF
+
+/** Allow sampling interrupts while handling a trap from lower modes */
+void sbi_mprof_window_begin(struct sbi_trap_regs *regs);
+
+/** Disallow sampling interrupts allowed by sbi_mprof_window_begin() */
+void sbi_mprof_window_end(void);
+
+/** Take sample on M-mode timer interrupt (returns TRUE if consumed) */
+bool sbi_mprof_timer_process(struct sbi_trap_regs *regs);
+
+/** Take sample on counter overflow interrupt (returns TRUE if consumed) */
+bool sbi_mprof_overflow_process(struct sbi_trap_regs *regs);
+
+/** Set (or disable) profiler shared memory */
+int sbi_mprof_set_shmem(unsigned long addr, unsigned long size);
+
+/**
+ * Start sampling on all HARTs
+ * @return sampling source (SBI_MPROF_MODE_xxx) or negative error code
+ */
+int sbi_mprof_start(unsigned long period, unsigned long event);
+
+/** Stop sampling on all HARTs */
+int sbi_mprof_stop(void);
+
+int sbi_mprof_init(struct sbi_scratch *scratch, bool cold_boot);
+
+void sbi_mprof_exit(struct sbi_scratch *scratch);
+
+#else
+
+static inline void sbi_mprof_window_begin(struct sbi_trap_regs *regs)
+{
+}
+
+static inline void sbi_mprof_window_end(void)
+{
+}
+
+static inline bool sbi_mprof_timer_process(struct sbi_trap_regs *regs)
+{
+	return FALSE;
+}
+
+static inline bool sbi_mprof_overflow_process(struct sbi_trap_regs *regs)
+{
+	return FALSE;
+}
+
+static inline int sbi_mprof_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+static inline void sbi_mprof_exit(struct sbi_scratch *scratch)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_PERF_PROFILE_H__
+#define __SBI_PERF_PROFILE_H__
+
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Maximum number of performance profiles */
+#define SBI_PERF_PROFILE_MAX			8
+
+/** Maximum number of CSRs controlled by one performance profile */
+#define SBI_PERF_PROFILE_CSR_MAX		8
+
+/* clang-format on */
+
+/** Bits of a performance CSR controlled by a profile */
+struct sbi_perf_csr {
+	/** CSR number (only M-mode custom read/write CSRs) */
+	u32 csr;
+	/** Bits of the CSR owned by the profile */
+	unsigned long mask;
+	/** Value of the owned bits */
+	unsigned long value;
+};
+
+/**
+ * Named set of vendor performance CSR settings (prefetchers,
+ * write-around, non-blocking load/store, branch prediction hints, etc)
+ *
+ * Note: Switching profiles only updates bits owned by the new profile
+ * so all profiles of a platform should own the same bits.
+ */
+struct sbi_perf_profile {
+	/** Name of the profile */
+	char name[32];
+	/** Number of valid entries in csrs[] */
+	u32 csr_count;
+	/** CSR settings applied in order */
+	struct sbi_perf_csr csrs[SBI_PERF_PROFILE_CSR_MAX];
+};
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_ECALL_PERF_PROFILE
+
+/** Check whether a CSR can be controlled by a performance profile */
+bool sbi_perf_profile_csr_valid(u32 csr);
+
+/** Register a copy of a performance profile and return its index */
+int sbi_perf_profile_register(const struct sbi_perf_profile *prof);
+
+/** Select profile applied on HARTs not switched at runtime */
+int sbi_perf_profile_set_default(u32 index);
+
+/** Get number of registered performance profiles */
+u32 sbi_perf_profile_count(void);
+
+/** Get registered performance profile based on index */
+const struct sbi_perf_profile *sbi_perf_profile_get(u32 index);
+
+/** Get index of the performance profile active on a HART */
+int sbi_perf_profile_current(struct sbi_scratch *scratch);
+
+/** Switch performance profile of a set of HARTs */
+int sbi_perf_profile_switch(u32 index, ulong hmask, ulong hbase);
+
+int sbi_perf_profile_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+/* Profiles registered by platform support are ignored */
+static inline int sbi_perf_profile_register(const struct sbi_perf_profile *prof)
+{
+	return 0;
+}
+
+static inline u32 sbi_perf_profile_count(void)
+{
+	return 0;
+}
+
+static inline const struct sbi_perf_profile *sbi_perf_profile_get(u32 index)
+{
+	return NULL;
+}
+
+static inline int sbi_perf_profile_current(struct sbi_scratch *scratch)
+{
+	return SBI_ENOTSUPP;
+}
+
+static inline int sbi_perf_profile_init(struct sbi_scratch *scratch,
+					bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
@@ -40,6 +40,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <sbi/riscv_barrier.h>
 #include <sbi/sbi_ecall_interface.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_scratch.h>
@@ -58,9 +59,11 @@ enum sbi_platform_features {
 	SBI_PLATFORM_HAS_MFAULTS_DELEGATION = (1 << 2),
 	/** Platform has custom secondary hart booting support */
 	SBI_PLATFORM_HAS_HART_SECONDARY_BOOT = (1 << 3),
+	/** Platform has HARTs with same IDs but different features */
+	SBI_PLATFORM_HAS_HETEROGENEOUS_HARTS = (1 << 4),
 
 	/** Last index of Platform features*/
-	SBI_PLATFORM_HAS_LAST_FEATURE = SBI_PLATFORM_HAS_HART_SECONDARY_BOOT,
+	SBI_PLATFORM_HAS_LAST_FEATURE = SBI_PLATFORM_HAS_HETEROGENEOUS_HARTS,
 };
 
 /** Default feature set for a platform */
@@ -91,6 +94,17 @@ struct sbi_platform_operations {
 	 */
 	int (*misa_get_xlen)(void);
 
+	/**
+	 * Populate ISA extensions of current HART which can't be
+	 * discovered by probing (e.g. from device tree).
+	 */
+	int (*extensions_init)(void);
+	/**
+	 * Get a key describing the type of current HART beyond what
+	 * MVENDORID, MARCHID and MIMPID tell (e.g. from device tree).
+	 */
+	unsigned long (*hart_features_key)(void);
+
 	/** Initialize (or populate) domains for the platform */
 	int (*domains_init)(void);
 	/** Get domain pointer for given HART id */
@@ -98,6 +112,8 @@ struct sbi_platform_operations {
 
 	/** Write a character to the platform console output */
 	void (*console_putc)(char ch);
+	/** Write a buffer of characters to the platform console output */
+	void (*console_puts)(const char *str, unsigned long len);
 	/** Read a character from the platform console input */
 	int (*console_getc)(void);
 	/** Initialize the platform console */
@@ -131,6 +147,11 @@ struct sbi_platform_operations {
 	/** Exit platform timer for current HART */
 	void (*timer_exit)(void);
 
+	/** Get cache block size used for cache maintenance */
+	unsigned long (*cache_block_size)(void);
+	/** Cache maintenance on physical address range for current HART */
+	int (*cache_op)(u32 type, unsigned long addr, unsigned long size);
+
 	/** Bringup the given hart */
 	int (*hart_start)(u32 hartid, ulong saddr);
 	/**
@@ -144,6 +165,15 @@ struct sbi_platform_operations {
 	/** Reset the platform */
 	void (*system_reset)(u32 reset_type, u32 reset_reason);
 
+	/** Check whether sleep type is supported by the platform */
+	int (*system_suspend_check)(u32 sleep_type);
+	/**
+	 * Suspend the platform. This call doesn't return if the platform
+	 * resumes at the given M-mode resume address (after losing HART
+	 * state) and returns 0 if the platform resumes right after it.
+	 */
+	int (*system_suspend)(u32 sleep_type, ulong mmode_resume_addr);
+
 	/** platform specific SBI extension implementation probe function */
 	int (*vendor_ext_check)(long extid);
 	/** platform specific SBI extension implementation provider */
@@ -222,6 +252,9 @@ struct sbi_platform {
 /** Check whether the platform supports custom secondary hart booting support */
 #define sbi_platform_has_hart_secondary_boot(__p) \
 	((__p)->features & SBI_PLATFORM_HAS_HART_SECONDARY_BOOT)
+/** Platform has HARTs with same IDs but different features */
+#define sbi_platform_has_heterogeneous_harts(__p) \
+	((__p)->features & SBI_PLATFORM_HAS_HETEROGENEOUS_HARTS)
 
 /**
  * Get HART index for the given HART
@@ -453,6 +486,38 @@ static inline int sbi_platform_misa_xlen(const struct sbi_platform *plat)
 	return -1;
 }
 
+/**
+ * Populate ISA extensions of current HART
+ *
+ * @param plat pointer to struct sbi_platform
+ *
+ * @return 0 on success and negative error code on failure
+ */
+static inline int sbi_platform_extensions_init(const struct sbi_platform *plat)
+{
+	if (plat && sbi_platform_ops(plat)->extensions_init)
+		return sbi_platform_ops(plat)->extensions_init();
+	return 0;
+}
+
+/**
+ * Get a key describing the type of current HART
+ *
+ * HARTs with the same key (along with same MVENDORID, MARCHID and
+ * MIMPID) are expected to have the same features.
+ *
+ * @param plat pointer to struct sbi_platform
+ *
+ * @return platform specific key (0 if not provided by platform)
+ */
+static inline unsigned long
+sbi_platform_hart_features_key(const struct sbi_platform *plat)
+{
+	if (plat && sbi_platform_ops(plat)->hart_features_key)
+		return sbi_platform_ops(plat)->hart_features_key();
+	return 0;
+}
+
 /**
  * Initialize (or populate) domains for the platform
  *
@@ -496,6 +561,33 @@ static inline void sbi_platform_console_putc(const struct sbi_platform *plat,
 		sbi_platform_ops(plat)->console_putc(ch);
 }
 
+/**
+ * Write a buffer of characters to the platform console output
+ *
+ * Platforms without a bulk write hook get one console_putc()
+ * call per character.
+ *
+ * @param plat pointer to struct sbi_platform
+ * @param str pointer to characters to write
+ * @param len number of characters to write
+ */
+static inline void sbi_platform_console_puts(const struct sbi_platform *plat,
+					     const char *str,
+					     unsigned long len)
+{
+	unsigned long i;
+
+	if (!plat)
+		return;
+
+	if (sbi_platform_ops(plat)->console_puts) {
+		sbi_platform_ops(plat)->console_puts(str, len);
+	} else if (sbi_platform_ops(plat)->console_putc) {
+		for (i = 0; i < len; i++)
+			sbi_platform_ops(plat)->console_putc(str[i]);
+	}
+}
+
 /**
  * Read a character from the platform console input
  *
@@ -554,14 +646,19 @@ static inline void sbi_platform_irqchip_exit(const struct sbi_platform *plat)
 /**
  * Send IPI to a target HART
  *
+ * Memory writes before this function (such as IPI data) are ordered
+ * before the IPI so the platform ipi_send() can use relaxed MMIO.
+ *
  * @param plat pointer to struct sbi_platform
  * @param target_hart HART ID of IPI target
  */
 static inline void sbi_platform_ipi_send(const struct sbi_platform *plat,
 					 u32 target_hart)
 {
-	if (plat && sbi_platform_ops(plat)->ipi_send)
+	if (plat && sbi_platform_ops(plat)->ipi_send) {
+		wmb();
 		sbi_platform_ops(plat)->ipi_send(target_hart);
+	}
 }
 
 /**
@@ -670,6 +767,40 @@ static inline void sbi_platform_timer_exit(const struct sbi_platform *plat)
 		sbi_platform_ops(plat)->timer_exit();
 }
 
+/**
+ * Get platform cache block size used for cache maintenance
+ *
+ * @param plat pointer to struct sbi_platform
+ *
+ * @return cache block size in bytes (0 if not provided by platform)
+ */
+static inline unsigned long
+sbi_platform_cache_block_size(const struct sbi_platform *plat)
+{
+	if (plat && sbi_platform_ops(plat)->cache_block_size)
+		return sbi_platform_ops(plat)->cache_block_size();
+	return 0;
+}
+
+/**
+ * Do platform specific cache maintenance on physical address range
+ *
+ * @param plat pointer to struct sbi_platform
+ * @param type type of cache maintenance (enum sbi_cache_op_type)
+ * @param addr start physical address (cache block aligned)
+ * @param size size of the range in bytes
+ *
+ * @return 0 on success and negative error code on failure
+ */
+static inline int sbi_platform_cache_op(const struct sbi_platform *plat,
+					u32 type, unsigned long addr,
+					unsigned long size)
+{
+	if (plat && sbi_platform_ops(plat)->cache_op)
+		return sbi_platform_ops(plat)->cache_op(type, addr, size);
+	return SBI_ENOTSUPP;
+}
+
 /**
  * Check whether reset type and reason supported by the platform
  *
@@ -705,6 +836,45 @@ static inline void sbi_platform_system_reset(const struct sbi_platform *plat,
 		sbi_platform_ops(plat)->system_reset(reset_type, reset_reason);
 }
 
+/**
+ * Check whether sleep type is supported by the platform
+ *
+ * @param plat pointer to struct sbi_platform
+ * @param sleep_type type of system suspend
+ *
+ * @return 0 if sleep type not supported and 1 if supported
+ */
+static inline int sbi_platform_system_suspend_check(
+					const struct sbi_platform *plat,
+					u32 sleep_type)
+{
+	if (plat && sbi_platform_ops(plat)->system_suspend_check)
+		return sbi_platform_ops(plat)->system_suspend_check(sleep_type);
+	return 0;
+}
+
+/**
+ * Suspend the platform
+ *
+ * Platforms losing HART state while suspended don't return from this
+ * function and resume at the given M-mode resume address instead.
+ *
+ * @param plat pointer to struct sbi_platform
+ * @param sleep_type type of system suspend
+ * @param mmode_resume_addr M-mode address to resume at
+ *
+ * @return 0 on wake up and negative error code on failure
+ */
+static inline int sbi_platform_system_suspend(const struct sbi_platform *plat,
+					      u32 sleep_type,
+					      ulong mmode_resume_addr)
+{
+	if (plat && sbi_platform_ops(plat)->system_suspend)
+		return sbi_platform_ops(plat)->system_suspend(sleep_type,
+							mmode_resume_addr);
+	return SBI_ENOTSUPP;
+}
+
 /**
  * Check if a vendor extension is implemented or not.
  *
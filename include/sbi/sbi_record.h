@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_RECORD_H__
+#define __SBI_RECORD_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Magic value of record buffer header ("SBRC") */
+#define SBI_RECORD_MAGIC			0x43524253
+
+/** Layout version of record buffer */
+#define SBI_RECORD_VERSION			0x1
+
+/** Offset of first per-HART ring from start of record buffer */
+#define SBI_RECORD_RING_OFFSET			64
+
+/* clang-format on */
+
+/** Fixed size record of one SBI call */
+struct sbi_record {
+	/** Timer value when the SBI call was taken */
+	u64 time;
+	/** Extension ID (a7) */
+	u32 extid;
+	/** Function ID (a6) */
+	u32 funcid;
+	/** Arguments (a0 to a5) including HART masks */
+	u64 args[6];
+};
+
+/** Per-HART ring of SBI call records */
+struct sbi_record_ring {
+	/** Number of records written so far (next record is head % entries) */
+	u64 head;
+	/** HART id of the HART writing this ring */
+	u32 hartid;
+	u32 reserved;
+	/** Records of the ring */
+	struct sbi_record records[];
+};
+
+/** Header at the start of record buffer */
+struct sbi_record_header {
+	/** Magic value (SBI_RECORD_MAGIC) */
+	u32 magic;
+	/** Layout version (SBI_RECORD_VERSION) */
+	u32 version;
+	/** Number of rings (indexed by HART index) */
+	u32 ring_count;
+	/** Number of records in each ring (power of 2) */
+	u32 ring_entries;
+	/** Offset of first ring from start of record buffer */
+	u32 ring_offset;
+	/** Size of each ring in bytes */
+	u32 ring_size;
+	/** Size of each record in bytes */
+	u32 record_size;
+	u32 reserved;
+};
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_RECORD
+
+/** Is SBI call recording enabled */
+extern bool sbi_record_enabled;
+
+void __sbi_record_ecall(unsigned long extid, unsigned long funcid,
+			const unsigned long *args);
+
+/** Add SBI call to the record ring of current HART */
+#define sbi_record_ecall(__extid, __funcid, __args)			\
+do {									\
+	if (sbi_record_enabled)						\
+		__sbi_record_ecall(__extid, __funcid, __args);		\
+} while (0)
+
+/**
+ * Setup memory of record buffer
+ *
+ * Note: This must be called in the cold boot path before sbi_record_init()
+ */
+int sbi_record_configure(unsigned long addr, unsigned long size);
+
+int sbi_record_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+#define sbi_record_ecall(__extid, __funcid, __args)	\
+do {							\
+} while (0)
+
+static inline int sbi_record_configure(unsigned long addr, unsigned long size)
+{
+	return 0;
+}
+
+static inline int sbi_record_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
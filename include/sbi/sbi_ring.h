@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_RING_H__
+#define __SBI_RING_H__
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_types.h>
+
+/**
+ * Common header at the start of a buffer of per-HART rings
+ *
+ * Note: Buffer specific headers (such as struct sbi_trace_header) start
+ * with the same fields and can only add fields after them.
+ */
+struct sbi_ring_header {
+	/** Magic value of the buffer */
+	u32 magic;
+	/** Layout version of the buffer */
+	u32 version;
+	/** Number of rings (indexed by HART index) */
+	u32 ring_count;
+	/** Number of records in each ring (power of 2) */
+	u32 ring_entries;
+	/** Offset of first ring from start of buffer */
+	u32 ring_offset;
+	/** Size of each ring in bytes */
+	u32 ring_size;
+	/** Size of each record in bytes */
+	u32 record_size;
+	u32 reserved;
+};
+
+/** Per-HART ring of fixed size records */
+struct sbi_ring {
+	/** Number of records written so far (next record is head % entries) */
+	u64 head;
+	/** HART id of the HART writing this ring */
+	u32 hartid;
+	u32 reserved;
+	/** Records of the ring */
+	u8 records[];
+};
+
+/** Layout of a ring buffer as set up by OpenSBI */
+struct sbi_ring_buffer {
+	/** Header of the buffer (NULL until set up) */
+	struct sbi_ring_header *hdr;
+	/*
+	 * Copies of the layout because S-mode might overwrite the header
+	 */
+	u32 ring_count;
+	u32 ring_entries;
+	unsigned long ring_offset;
+	unsigned long ring_size;
+	unsigned long record_size;
+};
+
+/**
+ * Setup a buffer of per-HART rings
+ *
+ * The buffer is split into one ring per HART index holding the largest
+ * power of 2 number of records. The header is published (magic written)
+ * only after the rings are initialized.
+ *
+ * @param rb pointer to ring buffer state
+ * @param scratch pointer to scratch space of current HART
+ * @param addr start of the buffer
+ * @param size size of the buffer
+ * @param ring_offset offset of first ring from start of buffer
+ * @param record_size size of each record in bytes
+ * @param magic magic value of the header
+ * @param version layout version of the header
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_ring_buffer_setup(struct sbi_ring_buffer *rb,
+			  struct sbi_scratch *scratch,
+			  unsigned long addr, unsigned long size,
+			  unsigned long ring_offset, unsigned long record_size,
+			  u32 magic, u32 version);
+
+/**
+ * Get next record of the ring of current HART
+ *
+ * On success, M-mode interrupts stay disabled until the record is
+ * committed using sbi_ring_buffer_commit().
+ *
+ * @param rb pointer to ring buffer state
+ * @param mstatus where the MSTATUS value to be restored is saved
+ *
+ * @return pointer to the record or NULL if current HART has no ring
+ */
+static inline void *sbi_ring_buffer_begin(struct sbi_ring_buffer *rb,
+					  unsigned long *mstatus)
+{
+	struct sbi_ring *ring;
+	u32 hartindex = current_hartindex();
+
+	if (!rb->hdr || rb->ring_count <= hartindex)
+		return NULL;
+	ring = (void *)rb->hdr + rb->ring_offset + hartindex * rb->ring_size;
+
+	/* Nested interrupts must not interleave with this record */
+	*mstatus = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);
+
+	return &ring->records[(ring->head & (rb->ring_entries - 1)) *
+			      rb->record_size];
+}
+
+/**
+ * Make the record returned by sbi_ring_buffer_begin() visible
+ *
+ * @param rb pointer to ring buffer state
+ * @param mstatus MSTATUS value saved by sbi_ring_buffer_begin()
+ */
+static inline void sbi_ring_buffer_commit(struct sbi_ring_buffer *rb,
+					  unsigned long mstatus)
+{
+	struct sbi_ring *ring = (void *)rb->hdr + rb->ring_offset +
+				current_hartindex() * rb->ring_size;
+
+	/* Record must be visible before the new head */
+	smp_wmb();
+	ring->head++;
+
+	csr_set(CSR_MSTATUS, mstatus & MSTATUS_MIE);
+}
+
+#endif
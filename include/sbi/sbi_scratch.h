@@ -34,8 +34,14 @@
 #define SBI_SCRATCH_TMP0_OFFSET			(8 * __SIZEOF_POINTER__)
 /** Offset of options member in sbi_scratch */
 #define SBI_SCRATCH_OPTIONS_OFFSET		(9 * __SIZEOF_POINTER__)
+/** Offset of fw_decomp_cycles member in sbi_scratch */
+#define SBI_SCRATCH_FW_DECOMP_CYCLES_OFFSET	(10 * __SIZEOF_POINTER__)
+/** Offset of hartid member in sbi_scratch */
+#define SBI_SCRATCH_HARTID_OFFSET		(11 * __SIZEOF_POINTER__)
+/** Offset of hartindex member in sbi_scratch */
+#define SBI_SCRATCH_HARTINDEX_OFFSET		(12 * __SIZEOF_POINTER__)
 /** Offset of extra space in sbi_scratch */
-#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(10 * __SIZEOF_POINTER__)
+#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(13 * __SIZEOF_POINTER__)
 /** Maximum size of sbi_scratch (4KB) */
 #define SBI_SCRATCH_SIZE			(0x1000)
 
@@ -67,6 +73,12 @@ struct sbi_scratch {
 	unsigned long tmp0;
 	/** Options for OpenSBI library */
 	unsigned long options;
+	/** Cycles spent by firmware decompressing the next booting stage */
+	unsigned long fw_decomp_cycles;
+	/** HART id of the HART owning this scratch space */
+	unsigned long hartid;
+	/** HART index of the HART owning this scratch space */
+	unsigned long hartindex;
 } __packed;
 
 /** Possible options for OpenSBI library */
@@ -75,11 +87,28 @@ enum sbi_scratch_options {
 	SBI_SCRATCH_NO_BOOT_PRINTS = (1 << 0),
 	/** Enable runtime debug prints */
 	SBI_SCRATCH_DEBUG_PRINTS = (1 << 1),
+	/** Paint HART stacks at boot to track their high-water mark */
+	SBI_SCRATCH_STACK_PAINT = (1 << 2),
 };
 
-/** Get pointer to sbi_scratch for current HART */
-#define sbi_scratch_thishart_ptr() \
-	((struct sbi_scratch *)csr_read(CSR_MSCRATCH))
+/**
+ * Get pointer to sbi_scratch for current HART
+ *
+ * Note: The TP register always points to sbi_scratch of current HART
+ * while executing in M-mode (setup by warm boot and trap entry).
+ */
+#define sbi_scratch_thishart_ptr()					\
+	({								\
+		struct sbi_scratch *__s;				\
+		__asm__ ("mv %0, tp" : "=r"(__s));			\
+		__s;							\
+	})
+
+/** Get HART id of current HART */
+#define current_hartid()	((u32)sbi_scratch_thishart_ptr()->hartid)
+
+/** Get HART index of current HART */
+#define current_hartindex()	((u32)sbi_scratch_thishart_ptr()->hartindex)
 
 /** Get Arg1 of next booting stage for current HART */
 #define sbi_scratch_thishart_arg1_ptr() \
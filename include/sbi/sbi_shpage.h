@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_SHPAGE_H__
+#define __SBI_SHPAGE_H__
+
+#include <sbi/sbi_types.h>
+#include <sbi/sbi_hartmask.h>
+
+/* clang-format off */
+
+/** Size and alignment of SBI shared page */
+#define SBI_SHPAGE_SIZE				0x1000
+
+/** Magic value of SBI shared page ("SBSP") */
+#define SBI_SHPAGE_MAGIC			0x50534253
+
+/** Layout version of SBI shared page */
+#define SBI_SHPAGE_VERSION			0x1
+
+/** Address passed to SBI_EXT_SHPAGE_SET_SHMEM for disabling */
+#define SBI_SHPAGE_DISABLE			(-1UL)
+
+/** Maximum number of SBI extension probe results */
+#define SBI_SHPAGE_PROBE_MAX			32
+
+/** Number of 64bit words in HART mask of SBI shared page */
+#define SBI_SHPAGE_HARTMASK_WORDS		\
+	((SBI_HARTMASK_MAX_BITS + 63) / 64)
+
+/** HART state word of HARTs not assigned to the domain */
+#define SBI_SHPAGE_HART_STATE_NONE		0xffffffffU
+
+/* clang-format on */
+
+/** Probe result of an SBI extension */
+struct sbi_shpage_probe {
+	/** SBI extension ID */
+	u64 extid;
+	/** Value returned by SBI_EXT_BASE_PROBE_EXT */
+	u64 value;
+};
+
+/**
+ * Layout of SBI shared page
+ *
+ * The page is updated only by OpenSBI and it is read-only for the
+ * supervisor software of the domain. Readers must retry whenever
+ * seq is odd or seq changed while reading other fields.
+ */
+struct sbi_shpage {
+	/** Magic value (SBI_SHPAGE_MAGIC) */
+	u32 magic;
+	/** Layout version (SBI_SHPAGE_VERSION) */
+	u32 version;
+	/** Sequence counter (odd while OpenSBI updates the page) */
+	u32 seq;
+	/** Index of the domain owning the page */
+	u32 domain_index;
+	/** Value returned by SBI_EXT_BASE_GET_SPEC_VERSION */
+	u64 spec_version;
+	/** Value returned by SBI_EXT_BASE_GET_IMP_ID */
+	u64 impl_id;
+	/** Value returned by SBI_EXT_BASE_GET_IMP_VERSION */
+	u64 impl_version;
+	/** Value returned by SBI_EXT_BASE_GET_MVENDORID */
+	u64 mvendorid;
+	/** Value returned by SBI_EXT_BASE_GET_MARCHID */
+	u64 marchid;
+	/** Value returned by SBI_EXT_BASE_GET_MIMPID */
+	u64 mimpid;
+	/** HARTs assigned to the domain (HART id N is bit N % 64 of word N / 64) */
+	u64 domain_harts[SBI_SHPAGE_HARTMASK_WORDS];
+	/** Number of valid entries in probe[] */
+	u32 probe_count;
+	/** Number of valid entries in hart_state[] */
+	u32 hart_count;
+	/** Probe results of SBI extensions */
+	struct sbi_shpage_probe probe[SBI_SHPAGE_PROBE_MAX];
+	/**
+	 * HSM status (SBI_HSM_HART_STATUS_xxx) indexed by HART id or
+	 * SBI_SHPAGE_HART_STATE_NONE for HARTs not assigned to the domain
+	 */
+	u32 hart_state[SBI_HARTMASK_MAX_BITS];
+};
+
+_Static_assert(sizeof(struct sbi_shpage) <= SBI_SHPAGE_SIZE,
+	       "struct sbi_shpage must fit in SBI_SHPAGE_SIZE");
+
+struct sbi_domain;
+
+#ifdef CONFIG_SBI_ECALL_SHPAGE
+
+/** Set (or disable) SBI shared page of a domain */
+int sbi_shpage_set(struct sbi_domain *dom, unsigned long addr);
+
+/** Get address of SBI shared page of a domain (SBI_SHPAGE_DISABLE if none) */
+unsigned long sbi_shpage_get(const struct sbi_domain *dom);
+
+/** Refresh HSM state word of a HART in SBI shared page of its domain */
+void sbi_shpage_hart_state_update(u32 hartid);
+
+/** Populate SBI shared pages of all domains */
+int sbi_shpage_init(void);
+
+#else
+
+static inline void sbi_shpage_hart_state_update(u32 hartid)
+{
+}
+
+static inline int sbi_shpage_init(void)
+{
+	return 0;
+}
+
+#endif
+
+#endif
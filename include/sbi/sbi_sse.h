@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_SSE_H__
+#define __SBI_SSE_H__
+
+#include <sbi/sbi_types.h>
+
+struct sbi_scratch;
+struct sbi_trap_regs;
+
+#ifdef CONFIG_SBI_SSE
+
+/** Copy attributes of an event to S-mode memory */
+int sbi_sse_read_attrs(u32 event_id, u32 base_attr_id, u32 attr_count,
+		       unsigned long phys_lo, unsigned long phys_hi);
+
+/** Update attributes of an event from S-mode memory */
+int sbi_sse_write_attrs(u32 event_id, u32 base_attr_id, u32 attr_count,
+			unsigned long phys_lo, unsigned long phys_hi);
+
+/** Register S-mode handler of an event on current HART */
+int sbi_sse_register(u32 event_id, unsigned long entry_pc,
+		     unsigned long entry_arg);
+
+/** Unregister S-mode handler of an event on current HART */
+int sbi_sse_unregister(u32 event_id);
+
+/** Allow delivery of an event on current HART */
+int sbi_sse_enable(u32 event_id);
+
+/** Stop delivery of an event on current HART */
+int sbi_sse_disable(u32 event_id);
+
+/**
+ * Complete the event running on current HART
+ *
+ * The interrupted context is resumed by sbi_sse_trap_exit() with
+ * the given a0 and a1 values.
+ */
+int sbi_sse_complete(unsigned long a0, unsigned long a1);
+
+/** Make an event pending on the given HART */
+int sbi_sse_inject(u32 event_id, unsigned long hartid);
+
+/** Start delivering events on current HART */
+int sbi_sse_hart_unmask(void);
+
+/** Stop delivering events on current HART */
+int sbi_sse_hart_mask(void);
+
+/** Check whether an event handler is running on current HART */
+bool sbi_sse_hart_running(void);
+
+/** Make PMU overflow event pending on counter overflow (returns TRUE if consumed) */
+bool sbi_sse_overflow_process(void);
+
+/** Complete or deliver events just before returning to lower modes */
+void sbi_sse_trap_exit(struct sbi_trap_regs *regs);
+
+int sbi_sse_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline bool sbi_sse_hart_running(void)
+{
+	return FALSE;
+}
+
+static inline bool sbi_sse_overflow_process(void)
+{
+	return FALSE;
+}
+
+static inline void sbi_sse_trap_exit(struct sbi_trap_regs *regs)
+{
+}
+
+static inline int sbi_sse_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_STACK_H__
+#define __SBI_STACK_H__
+
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Pattern written to unused stack words when painting is enabled */
+#define SBI_STACK_PAINT_PATTERN		((unsigned long)0x5354434b5354434bULL)
+
+/* clang-format on */
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_ECALL_STACK
+
+unsigned long sbi_stack_size(struct sbi_scratch *scratch);
+
+int sbi_stack_usage(struct sbi_scratch *scratch, unsigned long *used);
+
+int sbi_stack_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline unsigned long sbi_stack_size(struct sbi_scratch *scratch)
+{
+	return 0;
+}
+
+static inline int sbi_stack_usage(struct sbi_scratch *scratch,
+				  unsigned long *used)
+{
+	return SBI_ENOTSUPP;
+}
+
+static inline int sbi_stack_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
@@ -16,4 +16,32 @@ bool sbi_system_reset_supported(u32 reset_type, u32 reset_reason);
 
 void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason);
 
+/** Emulate system suspend to RAM (for platforms without suspend support) */
+void sbi_system_suspend_test_enable(void);
+
+bool sbi_system_suspend_supported(u32 sleep_type);
+
+/**
+ * Suspend the system
+ *
+ * All HARTs other than the current HART have to be stopped. On success
+ * the function does not return and the current HART resumes at the given
+ * address in the privilege mode of the caller with a0 set to the HART id
+ * and a1 set to the opaque value.
+ *
+ * @param sleep_type type of system suspend (SBI_SUSP_SLEEP_TYPE_xxx)
+ * @param resume_addr address to resume at
+ * @param opaque value passed in a1 on resume
+ *
+ * @return negative error code on failure
+ */
+int sbi_system_suspend(u32 sleep_type, ulong resume_addr, ulong opaque);
+
+/**
+ * Restore M-mode state saved by sbi_system_suspend()
+ *
+ * @param resume_start timer value when current HART entered resume path
+ */
+void sbi_system_resume(u64 resume_start);
+
 #endif
@@ -32,9 +32,29 @@ void sbi_timer_set_delta_upper(ulong delta_upper);
 /** Start timer event for current HART */
 void sbi_timer_event_start(u64 next_event);
 
-/** Process timer event for current HART */
+/** Stop timer event for current HART */
+void sbi_timer_event_stop(void);
+
+/** Process timer event (and deadline) for current HART */
 void sbi_timer_process(void);
 
+/** Get timer event of current HART which is not yet processed */
+bool sbi_timer_event_pending(u64 *next_event);
+
+/**
+ * Start M-mode deadline for current HART
+ *
+ * The deadline shares the M-mode timer with the timer event and is
+ * cleared by sbi_timer_process() once expired.
+ */
+void sbi_timer_deadline_start(u64 deadline);
+
+/** Get M-mode deadline of current HART which is not yet expired */
+bool sbi_timer_deadline_pending(u64 *deadline);
+
+/** Reprogram timer event of current HART after M-mode timer was borrowed */
+void sbi_timer_event_restore(void);
+
 /* Initialize timer */
 int sbi_timer_init(struct sbi_scratch *scratch, bool cold_boot);
 
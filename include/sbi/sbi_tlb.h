@@ -22,6 +22,8 @@
 
 #define SBI_TLB_FIFO_NUM_ENTRIES		8
 
+#define SBI_TLB_FIFO_MAX_ENTRIES		16
+
 enum sbi_tlb_info_types {
 	SBI_TLB_FLUSH_VMA,
 	SBI_TLB_FLUSH_VMA_ASID,
@@ -40,6 +42,8 @@ struct sbi_tlb_info {
 	unsigned long asid;
 	unsigned long vmid;
 	unsigned long type;
+	/* Flush sequence number of the target HART at enqueue time */
+	unsigned long seq;
 	struct sbi_hartmask smask;
 };
 
@@ -50,6 +54,7 @@ do { \
 	(__p)->asid = (__asid); \
 	(__p)->vmid = (__vmid); \
 	(__p)->type = (__type); \
+	(__p)->seq = 0; \
 	SBI_HARTMASK_INIT_EXCEPT(&(__p)->smask, (__src)); \
 } while (0)
 
@@ -57,6 +62,23 @@ do { \
 
 int sbi_tlb_request(ulong hmask, ulong hbase, struct sbi_tlb_info *tinfo);
 
+/** Get size (bytes) above which remote range flushes become full flushes */
+unsigned long sbi_tlb_get_range_flush_limit(void);
+
+/** Set size (bytes) above which remote range flushes become full flushes */
+int sbi_tlb_set_range_flush_limit(unsigned long limit);
+
+/** Get number of entries in the TLB request FIFO of each HART */
+u32 sbi_tlb_get_fifo_entries(void);
+
+/**
+ * Set number of entries in the TLB request FIFO of each HART
+ *
+ * The FIFOs are allocated by sbi_tlb_init() in cold boot so the number
+ * of entries can only be changed before that.
+ */
+int sbi_tlb_set_fifo_entries(u32 entries);
+
 int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot);
 
 #endif
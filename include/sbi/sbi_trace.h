@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_TRACE_H__
+#define __SBI_TRACE_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Magic value of trace buffer header ("SBTR") */
+#define SBI_TRACE_MAGIC				0x52544253
+
+/** Layout version of trace buffer */
+#define SBI_TRACE_VERSION			0x1
+
+/** Offset of first per-HART ring from start of trace buffer */
+#define SBI_TRACE_RING_OFFSET			64
+
+/** Trace categories (bit positions of trace mask) */
+#define SBI_TRACE_CAT_TRAP			0
+#define SBI_TRACE_CAT_ECALL			1
+#define SBI_TRACE_CAT_IPI			2
+#define SBI_TRACE_CAT_TLB			3
+#define SBI_TRACE_CAT_HSM			4
+#define SBI_TRACE_CAT_TIMER			5
+#define SBI_TRACE_CAT_DOMAIN			6
+#define SBI_TRACE_CAT_MAX			7
+
+/** Mask of all trace categories */
+#define SBI_TRACE_MASK_ALL			((1UL << SBI_TRACE_CAT_MAX) - 1)
+
+#define SBI_TRACE_EVENT(__cat, __num)		(((__cat) << 8) | (__num))
+#define SBI_TRACE_EVENT_MASK(__event)		(1UL << ((__event) >> 8))
+
+/** Trace events (record arguments are listed as arg0, arg1, arg2, arg3) */
+/* -, previous mode, mcause, mepc */
+#define SBI_TRACE_TRAP_ENTRY			SBI_TRACE_EVENT(SBI_TRACE_CAT_TRAP, 0)
+/* -, -, -, mepc */
+#define SBI_TRACE_TRAP_EXIT			SBI_TRACE_EVENT(SBI_TRACE_CAT_TRAP, 1)
+/* -, function ID, extension ID, error */
+#define SBI_TRACE_ECALL				SBI_TRACE_EVENT(SBI_TRACE_CAT_ECALL, 0)
+/* remote HART id, event, -, - */
+#define SBI_TRACE_IPI_SEND			SBI_TRACE_EVENT(SBI_TRACE_CAT_IPI, 0)
+/* -, -, event bitmap, - */
+#define SBI_TRACE_IPI_RECV			SBI_TRACE_EVENT(SBI_TRACE_CAT_IPI, 1)
+/* remote HART id, flush type, start, size */
+#define SBI_TRACE_TLB_ENQUEUE			SBI_TRACE_EVENT(SBI_TRACE_CAT_TLB, 0)
+/* remote HART id, flush type, start, size */
+#define SBI_TRACE_TLB_COALESCE			SBI_TRACE_EVENT(SBI_TRACE_CAT_TLB, 1)
+/* -, flush type, start, size */
+#define SBI_TRACE_TLB_PROCESS			SBI_TRACE_EVENT(SBI_TRACE_CAT_TLB, 2)
+/* -, flush type, start, size */
+#define SBI_TRACE_TLB_SKIP			SBI_TRACE_EVENT(SBI_TRACE_CAT_TLB, 3)
+/* HART id, new state, -, - */
+#define SBI_TRACE_HSM_STATE			SBI_TRACE_EVENT(SBI_TRACE_CAT_HSM, 0)
+/* -, sleep type, -, - */
+#define SBI_TRACE_SYSTEM_SUSPEND		SBI_TRACE_EVENT(SBI_TRACE_CAT_HSM, 1)
+/* -, -, suspended time (ticks), resume latency (ticks) */
+#define SBI_TRACE_SYSTEM_RESUME			SBI_TRACE_EVENT(SBI_TRACE_CAT_HSM, 2)
+/* -, -, next event time, - */
+#define SBI_TRACE_TIMER_START			SBI_TRACE_EVENT(SBI_TRACE_CAT_TIMER, 0)
+/* new domain index, old domain index, latency (ticks), switch cost (ticks) */
+#define SBI_TRACE_DOMAIN_SWITCH			SBI_TRACE_EVENT(SBI_TRACE_CAT_DOMAIN, 0)
+
+/* clang-format on */
+
+/** Fixed size trace record */
+struct sbi_trace_record {
+	/** Timer value when the record was written */
+	u64 time;
+	/** Trace event (SBI_TRACE_xxx) */
+	u32 event;
+	/** Event specific arguments */
+	u32 arg0;
+	u32 arg1;
+	u32 reserved;
+	u64 arg2;
+	u64 arg3;
+};
+
+/** Per-HART ring of trace records */
+struct sbi_trace_ring {
+	/** Number of records written so far (next record is head % entries) */
+	u64 head;
+	/** HART id of the HART writing this ring */
+	u32 hartid;
+	u32 reserved;
+	/** Records of the ring */
+	struct sbi_trace_record records[];
+};
+
+/** Header at the start of trace buffer */
+struct sbi_trace_header {
+	/** Magic value (SBI_TRACE_MAGIC) */
+	u32 magic;
+	/** Layout version (SBI_TRACE_VERSION) */
+	u32 version;
+	/** Number of rings (indexed by HART index) */
+	u32 ring_count;
+	/** Number of records in each ring (power of 2) */
+	u32 ring_entries;
+	/** Offset of first ring from start of trace buffer */
+	u32 ring_offset;
+	/** Size of each ring in bytes */
+	u32 ring_size;
+	/** Size of each record in bytes */
+	u32 record_size;
+	u32 reserved;
+	/** Enabled trace categories */
+	u64 mask;
+};
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_TRACE
+
+/** Enabled trace categories */
+extern unsigned long sbi_trace_mask;
+
+void __sbi_trace(u32 event, u32 arg0, u32 arg1, u64 arg2, u64 arg3);
+
+/** Add record to the trace ring of current HART */
+#define sbi_trace(__event, __arg0, __arg1, __arg2, __arg3)		\
+do {									\
+	if (sbi_trace_mask & SBI_TRACE_EVENT_MASK(__event))		\
+		__sbi_trace(__event, __arg0, __arg1, __arg2, __arg3);	\
+} while (0)
+
+/** Get address of trace buffer (zero if not available) */
+unsigned long sbi_trace_get_buffer(void);
+
+/** Get enabled trace categories */
+unsigned long sbi_trace_get_mask(void);
+
+/** Enable a set of trace categories (disables remaining categories) */
+int sbi_trace_set_mask(unsigned long mask);
+
+/**
+ * Setup memory of trace buffer
+ *
+ * Note: This must be called in the cold boot path before sbi_trace_init()
+ */
+int sbi_trace_configure(unsigned long addr, unsigned long size,
+			unsigned long mask);
+
+int sbi_trace_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+#define sbi_trace(__event, __arg0, __arg1, __arg2, __arg3)	\
+do {								\
+} while (0)
+
+static inline int sbi_trace_configure(unsigned long addr, unsigned long size,
+				      unsigned long mask)
+{
+	return 0;
+}
+
+static inline int sbi_trace_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
@@ -202,6 +202,26 @@ struct sbi_trap_info {
 	unsigned long tinst;
 };
 
+/** State saved while M-mode interrupts are enabled around a long wait */
+struct sbi_trap_nested {
+	/** Interrupts were enabled by sbi_trap_nested_begin() */
+	bool enabled;
+	/** Saved MIE CSR bits other than MSIE, MTIE and LCOFIE */
+	unsigned long mie;
+	/** Saved MEPC CSR */
+	unsigned long mepc;
+	/** Saved MSTATUS CSR */
+	unsigned long mstatus;
+	/** Saved MSTATUSH CSR (only for 32-bit) */
+	unsigned long mstatusH;
+};
+
+void sbi_trap_nested_begin(struct sbi_trap_nested *nst);
+
+void sbi_trap_nested_end(struct sbi_trap_nested *nst);
+
+int sbi_trap_enter_smode(struct sbi_trap_regs *regs, unsigned long target);
+
 int sbi_trap_redirect(struct sbi_trap_regs *regs,
 		      struct sbi_trap_info *trap);
 
@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __SBI_TUNE_H__
+#define __SBI_TUNE_H__
+
+#include <sbi/sbi_types.h>
+
+/* clang-format off */
+
+/** Maximum length of a tuning parameter name (including NUL) */
+#define SBI_TUNE_NAME_MAX			32
+
+/* clang-format on */
+
+/** Tuning parameter IDs (ABI of the TUNE extension) */
+enum sbi_tune_param_id {
+	/** Size (bytes) above which remote range flushes are full flushes */
+	SBI_TUNE_TLB_RANGE_FLUSH_LIMIT = 0,
+	/** Number of entries in the TLB request FIFO of each HART */
+	SBI_TUNE_TLB_FIFO_ENTRIES,
+	/** Console output mode (enum sbi_console_mode) */
+	SBI_TUNE_CONSOLE_MODE,
+	/** Emulate (1) or redirect to S-mode (0) misaligned loads/stores */
+	SBI_TUNE_MISALIGNED_EMULATION,
+	/** Print debug messages (1) or not (0) */
+	SBI_TUNE_DEBUG_PRINTS,
+	/** Access trapped context without MPRV (1) if translation is off */
+	SBI_TUNE_UNPRIV_DIRECT_ACCESS,
+	SBI_TUNE_PARAM_MAX
+};
+
+/**
+ * Find a tuning parameter by name
+ *
+ * @param name parameter name (such as "tlb-range-flush-limit")
+ * @return parameter ID on success and SBI_ENOENT if not found
+ */
+int sbi_tune_find(const char *name);
+
+/** Get name of a tuning parameter or NULL for unknown parameter ID */
+const char *sbi_tune_name(u32 id);
+
+/**
+ * Get value of a tuning parameter
+ *
+ * @param id parameter ID
+ * @param out_val pointer to store the current value
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_tune_get(u32 id, unsigned long *out_val);
+
+/**
+ * Get range of valid values of a tuning parameter
+ *
+ * @param id parameter ID
+ * @param out_min pointer to store the minimum value (or NULL)
+ * @param out_max pointer to store the maximum value (or NULL)
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_tune_get_range(u32 id, unsigned long *out_min, unsigned long *out_max);
+
+/**
+ * Set value of a tuning parameter
+ *
+ * The value is checked against the range of the parameter. Parameters
+ * used to size firmware data structures can only be set during cold
+ * boot before the corresponding subsystem is initialized.
+ *
+ * @param id parameter ID
+ * @param val new value
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_tune_set(u32 id, unsigned long val);
+
+#endif
@@ -38,4 +38,21 @@ DECLARE_UNPRIVILEGED_LOAD_FUNCTION(ulong)
 
 ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap);
 
+/** Check whether accesses with translation off bypass MPRV */
+bool sbi_unpriv_get_direct(void);
+
+/** Enable (or disable) direct accesses with translation off */
+void sbi_unpriv_set_direct(bool direct);
+
+/**
+ * Forget translation state of the previous trap
+ *
+ * The translation mode of the trapped context is looked up on the first
+ * unprivileged access of a trap and reused by later accesses of the same
+ * trap, so this must be called on every trap entry.
+ */
+void sbi_unpriv_trap_enter(struct sbi_scratch *scratch);
+
+int sbi_unpriv_init(struct sbi_scratch *scratch, bool cold_boot);
+
 #endif
@@ -26,6 +26,17 @@ void fdt_iterate_each_domain(void *fdt, void *opaque,
 			     void (*fn)(void *fdt, int domain_offset,
 					void *opaque));
 
+/**
+ * Iterate over each inter-domain channel in device tree
+ *
+ * @param fdt device tree blob
+ * @param opaque private pointer for each iteration
+ * @param fn callback function for each iteration
+ */
+void fdt_iterate_each_channel(void *fdt, void *opaque,
+			      void (*fn)(void *fdt, int channel_offset,
+					 void *opaque));
+
 /**
  * Iterate over each memregion of a domain in device tree
  *
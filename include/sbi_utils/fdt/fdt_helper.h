@@ -39,6 +39,14 @@ int fdt_parse_hart_id(void *fdt, int cpu_offset, u32 *hartid);
 
 int fdt_parse_max_hart_id(void *fdt, u32 *max_hartid);
 
+int fdt_parse_isa_extensions(void *fdt, u32 hartid,
+			     unsigned long *extensions);
+
+int fdt_parse_hart_type_key(void *fdt, u32 hartid, unsigned long *key);
+
+int fdt_parse_reserved_memory(void *fdt, const char *compat, int *node,
+			      unsigned long *addr, unsigned long *size);
+
 int fdt_parse_shakti_uart_node(void *fdt, int nodeoffset,
 			       struct platform_uart_data *uart);
 
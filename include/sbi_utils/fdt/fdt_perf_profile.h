@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_perf_profile.h - Flat Device Tree performance profile helper routines
+ */
+
+#ifndef __FDT_PERF_PROFILE_H__
+#define __FDT_PERF_PROFILE_H__
+
+#include <sbi/sbi_types.h>
+
+#ifdef CONFIG_SBI_ECALL_PERF_PROFILE
+
+/**
+ * Register performance CSR profiles described in device tree
+ *
+ * Profiles are described by "opensbi,perf-profile,instance" compatible
+ * DT nodes under the "opensbi,perf-profile,config" compatible DT node
+ * of /chosen. It is recommended that platform support call this function
+ * in the cold boot path of their early_init() platform operation.
+ *
+ * @param fdt device tree blob
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int fdt_perf_profiles_populate(void *fdt);
+
+#else
+
+static inline int fdt_perf_profiles_populate(void *fdt)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __FDT_PERF_PROFILE_H__ */
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_record.h - Flat Device Tree SBI call record buffer helper routines
+ */
+
+#ifndef __FDT_RECORD_H__
+#define __FDT_RECORD_H__
+
+#include <sbi/sbi_types.h>
+
+#ifdef CONFIG_SBI_RECORD
+
+/**
+ * Setup SBI call record buffer described in device tree
+ *
+ * The record buffer is described by a "opensbi,record-buffer" compatible
+ * DT node under /reserved-memory. It is recommended that platform support
+ * call this function in the cold boot path of their early_init() platform
+ * operation.
+ *
+ * @param fdt device tree blob
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int fdt_record_init(void *fdt);
+
+#else
+
+static inline int fdt_record_init(void *fdt)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __FDT_RECORD_H__ */
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_trace.h - Flat Device Tree firmware trace buffer helper routines
+ */
+
+#ifndef __FDT_TRACE_H__
+#define __FDT_TRACE_H__
+
+#include <sbi/sbi_types.h>
+
+#ifdef CONFIG_SBI_TRACE
+
+/**
+ * Setup firmware trace buffer described in device tree
+ *
+ * The trace buffer is described by a "opensbi,trace-buffer" compatible
+ * DT node under /reserved-memory. The optional "opensbi,trace-mask"
+ * DT property of this node selects the trace categories enabled at
+ * boot time. It is recommended that platform support call this function
+ * in the cold boot path of their early_init() platform operation.
+ *
+ * @param fdt device tree blob
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int fdt_trace_init(void *fdt);
+
+#else
+
+static inline int fdt_trace_init(void *fdt)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __FDT_TRACE_H__ */
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_tune.h - Flat Device Tree firmware tuning parameter helper routines
+ */
+
+#ifndef __FDT_TUNE_H__
+#define __FDT_TUNE_H__
+
+#include <sbi/sbi_types.h>
+
+#ifdef CONFIG_SBI_ECALL_TUNE
+
+/**
+ * Apply firmware tuning parameters described in device tree
+ *
+ * Each tuning parameter is a u32 or u64 DT property of the
+ * /chosen/opensbi-config DT node named after the parameter (such as
+ * "tlb-range-flush-limit"). Some parameters size firmware data structures
+ * so it is recommended that platform support call this function in the
+ * cold boot path of their early_init() platform operation.
+ *
+ * @param fdt device tree blob
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int fdt_tune_init(void *fdt);
+
+#else
+
+static inline int fdt_tune_init(void *fdt)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __FDT_TUNE_H__ */
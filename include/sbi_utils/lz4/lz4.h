@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+#include <sbi/sbi_types.h>
+
+/**
+ * Decompress a LZ4 legacy frame (as produced by "lz4 -l")
+ *
+ * @param dst destination buffer
+ * @param dst_size size of destination buffer
+ * @param src LZ4 legacy frame
+ * @param src_size size of LZ4 legacy frame
+ * @param out_size number of decompressed bytes (can be NULL)
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int lz4_decompress(void *dst, size_t dst_size,
+		   const void *src, size_t src_size, size_t *out_size);
+
+/**
+ * Decompress a LZ4 legacy frame into memory which may overlap the frame
+ *
+ * The frame must be followed by the decompressed size as a 32-bit
+ * little-endian word and it must be inside the window reserved for
+ * decompression which starts at the destination address. The frame is
+ * first moved to the end of the window so that the decompressed data
+ * never overtakes the unread compressed data. Nothing outside the window
+ * is written.
+ *
+ * @param dst destination address (start of the window)
+ * @param window_size size of the window reserved for decompression
+ * @param src LZ4 legacy frame followed by decompressed size
+ * @param src_size size of LZ4 legacy frame including decompressed size
+ * @param out_size number of decompressed bytes (can be NULL)
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int lz4_decompress_inplace(void *dst, size_t window_size,
+			   const void *src, size_t src_size, size_t *out_size);
+
+#endif
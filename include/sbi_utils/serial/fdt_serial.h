@@ -16,11 +16,14 @@ struct fdt_serial {
 	const struct fdt_match *match_table;
 	int (*init)(void *fdt, int nodeoff, const struct fdt_match *match);
 	void (*putc)(char ch);
+	void (*puts)(const char *str, unsigned long len);
 	int (*getc)(void);
 };
 
 void fdt_serial_putc(char ch);
 
+void fdt_serial_puts(const char *str, unsigned long len);
+
 int fdt_serial_getc(void);
 
 int fdt_serial_init(void);
@@ -12,6 +12,8 @@
 
 void htif_putc(char ch);
 
+void htif_puts(const char *str, unsigned long len);
+
 int htif_getc(void);
 
 int htif_system_reset_check(u32 type, u32 reason);
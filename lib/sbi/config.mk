@@ -0,0 +1,55 @@
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+
+# Build time configuration of libsbi
+#
+# Options can be set to "y" or "n" either in the platform config.mk or
+# on the make command line, for example:
+#   make PLATFORM=<platform_subdir> CONFIG_SBI_ECALL_LEGACY=n CONFIG_SBI_TRACE=y
+
+# SBI extensions (BASE extension is always present)
+CONFIG_SBI_ECALL_TIME ?= y
+CONFIG_SBI_ECALL_RFENCE ?= y
+CONFIG_SBI_ECALL_IPI ?= y
+CONFIG_SBI_ECALL_HSM ?= y
+CONFIG_SBI_ECALL_SRST ?= y
+CONFIG_SBI_ECALL_SUSP ?= y
+CONFIG_SBI_ECALL_LEGACY ?= y
+CONFIG_SBI_ECALL_VENDOR ?= y
+CONFIG_SBI_ECALL_DCHAN ?= y
+
+# Features along with their SBI extension (disabling one of these
+# leaves out the whole feature and not just the SBI extension)
+CONFIG_SBI_ECALL_CACHE ?= y
+CONFIG_SBI_ECALL_STACK ?= y
+CONFIG_SBI_ECALL_PERF_PROFILE ?= y
+CONFIG_SBI_ECALL_SHPAGE ?= y
+CONFIG_SBI_ECALL_FWTIME ?= y
+CONFIG_SBI_ECALL_TUNE ?= y
+
+# Share detected HART features among HARTs with same mvendorid, marchid,
+# mimpid and platform key such as the device tree compatible and riscv,isa
+# (see also SBI_PLATFORM_HAS_HETEROGENEOUS_HARTS)
+CONFIG_SBI_HART_FEATURES_SHARING ?= y
+
+# Trap emulation, disabled traps are redirected to S-mode
+CONFIG_SBI_EMULATE_ILLEGAL_INSN ?= y
+CONFIG_SBI_EMULATE_MISALIGNED ?= y
+
+# Debug and profiling features (disabled by default)
+
+# Per-HART firmware event tracer along with TRACE extension
+CONFIG_SBI_TRACE ?= n
+
+# Per-HART recorder of SBI calls for offline replay
+CONFIG_SBI_RECORD ?= n
+
+# Sampling profiler of M-mode code along with MPROF extension
+CONFIG_SBI_MPROF ?= n
+
+# Supervisor Software Events along with SSE extension
+CONFIG_SBI_SSE ?= n
+
+# Time-sliced sharing of HARTs between domains along with DSCHED extension
+CONFIG_SBI_DOMAIN_SCHED ?= n
@@ -14,30 +14,53 @@ libsbi-objs-y += riscv_locks.o
 
 libsbi-objs-y += sbi_bitmap.o
 libsbi-objs-y += sbi_bitops.o
+libsbi-objs-$(CONFIG_SBI_ECALL_CACHE) += sbi_cache.o
 libsbi-objs-y += sbi_console.o
 libsbi-objs-y += sbi_domain.o
+libsbi-objs-$(CONFIG_SBI_DOMAIN_SCHED) += sbi_domain_sched.o
 libsbi-objs-y += sbi_ecall.o
 libsbi-objs-y += sbi_ecall_base.o
-libsbi-objs-y += sbi_ecall_hsm.o
-libsbi-objs-y += sbi_ecall_legacy.o
+libsbi-objs-$(CONFIG_SBI_ECALL_CACHE) += sbi_ecall_cache.o
+libsbi-objs-$(CONFIG_SBI_ECALL_DCHAN) += sbi_ecall_dchan.o
+libsbi-objs-$(CONFIG_SBI_ECALL_FWTIME) += sbi_ecall_fwtime.o
+libsbi-objs-$(CONFIG_SBI_ECALL_HSM) += sbi_ecall_hsm.o
+libsbi-objs-$(CONFIG_SBI_ECALL_LEGACY) += sbi_ecall_legacy.o
+libsbi-objs-$(CONFIG_SBI_ECALL_PERF_PROFILE) += sbi_ecall_perf_profile.o
 libsbi-objs-y += sbi_ecall_replace.o
-libsbi-objs-y += sbi_ecall_vendor.o
-libsbi-objs-y += sbi_emulate_csr.o
+libsbi-objs-$(CONFIG_SBI_ECALL_SHPAGE) += sbi_ecall_shpage.o
+libsbi-objs-$(CONFIG_SBI_ECALL_STACK) += sbi_ecall_stack.o
+libsbi-objs-$(CONFIG_SBI_SSE) += sbi_ecall_sse.o
+libsbi-objs-$(CONFIG_SBI_DOMAIN_SCHED) += sbi_ecall_dsched.o
+libsbi-objs-$(CONFIG_SBI_MPROF) += sbi_ecall_mprof.o
+libsbi-objs-$(CONFIG_SBI_TRACE) += sbi_ecall_trace.o
+libsbi-objs-$(CONFIG_SBI_ECALL_TUNE) += sbi_ecall_tune.o
+libsbi-objs-$(CONFIG_SBI_ECALL_VENDOR) += sbi_ecall_vendor.o
+libsbi-objs-$(CONFIG_SBI_EMULATE_ILLEGAL_INSN) += sbi_emulate_csr.o
 libsbi-objs-y += sbi_fifo.o
+libsbi-objs-$(CONFIG_SBI_ECALL_FWTIME) += sbi_fwtime.o
 libsbi-objs-y += sbi_hart.o
 libsbi-objs-y += sbi_math.o
+libsbi-objs-$(CONFIG_SBI_ECALL_PERF_PROFILE) += sbi_perf_profile.o
 libsbi-objs-y += sbi_hfence.o
 libsbi-objs-y += sbi_hsm.o
-libsbi-objs-y += sbi_illegal_insn.o
+libsbi-objs-$(CONFIG_SBI_EMULATE_ILLEGAL_INSN) += sbi_illegal_insn.o
 libsbi-objs-y += sbi_init.o
 libsbi-objs-y += sbi_ipi.o
-libsbi-objs-y += sbi_misaligned_ldst.o
+libsbi-objs-$(CONFIG_SBI_EMULATE_MISALIGNED) += sbi_misaligned_ldst.o
+libsbi-objs-$(CONFIG_SBI_MPROF) += sbi_mprof.o
 libsbi-objs-y += sbi_platform.o
+libsbi-objs-$(CONFIG_SBI_RECORD) += sbi_record.o
+libsbi-objs-y += sbi_ring.o
 libsbi-objs-y += sbi_scratch.o
+libsbi-objs-$(CONFIG_SBI_ECALL_SHPAGE) += sbi_shpage.o
+libsbi-objs-$(CONFIG_SBI_SSE) += sbi_sse.o
+libsbi-objs-$(CONFIG_SBI_ECALL_STACK) += sbi_stack.o
 libsbi-objs-y += sbi_string.o
 libsbi-objs-y += sbi_system.o
 libsbi-objs-y += sbi_timer.o
 libsbi-objs-y += sbi_tlb.o
+libsbi-objs-$(CONFIG_SBI_TRACE) += sbi_trace.o
 libsbi-objs-y += sbi_trap.o
+libsbi-objs-$(CONFIG_SBI_ECALL_TUNE) += sbi_tune.o
 libsbi-objs-y += sbi_unpriv.o
 libsbi-objs-y += sbi_expected_trap.o
@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/sbi_cache.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+
+/* Granularity used for checking domain access of a cache range */
+#define CACHE_CHECK_GRANULE	(1UL << 12)
+
+static unsigned long cache_block_size;
+
+unsigned long sbi_cache_block_size(void)
+{
+	return cache_block_size;
+}
+
+static bool cache_range_allowed(unsigned long addr, unsigned long size)
+{
+	unsigned long pos, end = addr + size - 1;
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	/* Caller must be able to write each page of the range */
+	for (pos = addr; pos <= end; pos += CACHE_CHECK_GRANULE) {
+		if (!sbi_domain_check_addr(dom, pos, PRV_S, SBI_DOMAIN_WRITE))
+			return FALSE;
+		if (pos + CACHE_CHECK_GRANULE < pos)
+			break;
+	}
+
+	return sbi_domain_check_addr(dom, end, PRV_S, SBI_DOMAIN_WRITE);
+}
+
+static void cache_zicbom_op(u32 type, unsigned long start, unsigned long end)
+{
+	unsigned long pos;
+
+	switch (type) {
+	case SBI_CACHE_CLEAN:
+		for (pos = start; pos < end; pos += cache_block_size)
+			cbo_clean(pos);
+		break;
+	case SBI_CACHE_INVAL:
+		for (pos = start; pos < end; pos += cache_block_size)
+			cbo_inval(pos);
+		break;
+	case SBI_CACHE_FLUSH:
+		for (pos = start; pos < end; pos += cache_block_size)
+			cbo_flush(pos);
+		break;
+	default:
+		break;
+	}
+
+	mb();
+}
+
+int sbi_cache_op(u32 type, unsigned long addr, unsigned long size)
+{
+	unsigned long start, end;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	if (type >= SBI_CACHE_OP_MAX)
+		return SBI_EINVAL;
+	if (!size)
+		return 0;
+	if ((addr + size - 1) < addr)
+		return SBI_EINVAL;
+
+	/* Operate on whole cache blocks covering the range */
+	start = addr & ~(cache_block_size - 1);
+	end = ((addr + size - 1) | (cache_block_size - 1)) + 1;
+	if (end <= start)
+		return SBI_EINVAL;
+
+	/* Whole cache blocks are affected so check the rounded range */
+	if (!cache_range_allowed(start, end - start))
+		return SBI_EINVALID_ADDR;
+
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_ZICBOM)) {
+		cache_zicbom_op(type, start, end);
+		return 0;
+	}
+
+	return sbi_platform_cache_op(sbi_platform_ptr(scratch),
+				     type, start, end - start);
+}
+
+int sbi_cache_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	unsigned long bsize;
+
+	if (!cold_boot)
+		return 0;
+
+	bsize = sbi_platform_cache_block_size(sbi_platform_ptr(scratch));
+	if (!bsize)
+		bsize = SBI_CACHE_BLOCK_SIZE_DEFAULT;
+	if (bsize & (bsize - 1))
+		return SBI_EINVAL;
+	cache_block_size = bsize;
+
+	return 0;
+}
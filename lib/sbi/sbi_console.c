@@ -9,12 +9,41 @@
 
 #include <sbi/riscv_locks.h>
 #include <sbi/sbi_console.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_scratch.h>
+#include <sbi/sbi_trap.h>
 
 static const struct sbi_platform *console_plat = NULL;
 static spinlock_t console_out_lock	       = SPIN_LOCK_INITIALIZER;
 
+/*
+ * Output buffer protected by console_out_lock. Complete messages are
+ * handed to the platform in one go so that consoles with a bulk write
+ * path (such as HTIF) issue one transaction per message.
+ */
+#define CONSOLE_TBUF_MAX 256
+static char console_tbuf[CONSOLE_TBUF_MAX];
+static u32 console_tbuf_len;
+static u32 console_mode = SBI_CONSOLE_MODE_BUFFERED;
+
+/*
+ * Another HART might be printing a long message so take IPIs and timer
+ * interrupts while waiting. Interrupts are disabled again before taking
+ * the lock because the nested handling might print.
+ */
+static void console_out_lock_acquire(void)
+{
+	struct sbi_trap_nested nst;
+
+	while (!spin_trylock(&console_out_lock)) {
+		sbi_trap_nested_begin(&nst);
+		while (spin_lock_check(&console_out_lock))
+			;
+		sbi_trap_nested_end(&nst);
+	}
+}
+
 bool sbi_isprintable(char c)
 {
 	if (((31 < c) && (c < 127)) || (c == '\f') || (c == '\r') ||
@@ -36,13 +65,38 @@ void sbi_putc(char ch)
 	sbi_platform_console_putc(console_plat, ch);
 }
 
+static void console_tbuf_flush(void)
+{
+	if (!console_tbuf_len)
+		return;
+
+	sbi_platform_console_puts(console_plat, console_tbuf,
+				  console_tbuf_len);
+	console_tbuf_len = 0;
+}
+
+static void console_tbuf_putc(char ch)
+{
+	/* Keep room for the '\r' inserted before '\n' */
+	if (console_tbuf_len > (CONSOLE_TBUF_MAX - 2))
+		console_tbuf_flush();
+
+	if (ch == '\n')
+		console_tbuf[console_tbuf_len++] = '\r';
+	console_tbuf[console_tbuf_len++] = ch;
+
+	if (console_mode == SBI_CONSOLE_MODE_UNBUFFERED)
+		console_tbuf_flush();
+}
+
 void sbi_puts(const char *str)
 {
-	spin_lock(&console_out_lock);
+	console_out_lock_acquire();
 	while (*str) {
-		sbi_putc(*str);
+		console_tbuf_putc(*str);
 		str++;
 	}
+	console_tbuf_flush();
 	spin_unlock(&console_out_lock);
 }
 
@@ -83,7 +137,7 @@ static void printc(char **out, u32 *out_len, char ch)
 			}
 		}
 	} else {
-		sbi_putc(ch);
+		console_tbuf_putc(ch);
 	}
 }
 
@@ -367,10 +421,11 @@ int sbi_printf(const char *format, ...)
 	va_list args;
 	int retval;
 
-	spin_lock(&console_out_lock);
+	console_out_lock_acquire();
 	va_start(args, format);
 	retval = print(NULL, NULL, format, args);
 	va_end(args);
+	console_tbuf_flush();
 	spin_unlock(&console_out_lock);
 
 	return retval;
@@ -383,13 +438,31 @@ int sbi_dprintf(const char *format, ...)
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
 	va_start(args, format);
-	if (scratch->options & SBI_SCRATCH_DEBUG_PRINTS)
+	if (scratch->options & SBI_SCRATCH_DEBUG_PRINTS) {
+		console_out_lock_acquire();
 		retval = print(NULL, NULL, format, args);
+		console_tbuf_flush();
+		spin_unlock(&console_out_lock);
+	}
 	va_end(args);
 
 	return retval;
 }
 
+u32 sbi_console_get_mode(void)
+{
+	return console_mode;
+}
+
+int sbi_console_set_mode(u32 mode)
+{
+	if (SBI_CONSOLE_MODE_MAX <= mode)
+		return SBI_EINVAL;
+
+	console_mode = mode;
+	return 0;
+}
+
 int sbi_console_init(struct sbi_scratch *scratch)
 {
 	console_plat = sbi_platform_ptr(scratch);
@@ -22,6 +22,9 @@ struct sbi_domain *domidx_to_domain_table[SBI_DOMAIN_MAX_INDEX] = { 0 };
 
 static u32 domain_count = 0;
 
+static u32 channel_count = 0;
+static struct sbi_domain_channel *channel_table[SBI_DOMAIN_MAX_CHANNELS] = { 0 };
+
 static struct sbi_hartmask root_hmask = { 0 };
 
 #define ROOT_FW_REGION		0
@@ -111,6 +114,41 @@ bool sbi_domain_check_addr(const struct sbi_domain *dom,
 	return (mode == PRV_M) ? TRUE : FALSE;
 }
 
+bool sbi_domain_check_addr_range(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long size,
+				 unsigned long mode,
+				 unsigned long access_flags)
+{
+	unsigned long next, rstart, rend, end = addr + size;
+	struct sbi_domain_memregion *reg;
+
+	if (!dom || end < addr)
+		return FALSE;
+
+	while (addr < end) {
+		if (!sbi_domain_check_addr(dom, addr, mode, access_flags))
+			return FALSE;
+
+		/* Permissions only change at the nearest region boundary */
+		next = 0;
+		sbi_domain_for_each_memregion(dom, reg) {
+			rstart = reg->base;
+			rend = (reg->order < __riscv_xlen) ?
+				rstart + ((1UL << reg->order) - 1) : -1UL;
+			if (addr < rstart && (!next || rstart < next))
+				next = rstart;
+			if (rstart <= addr && addr <= rend && rend != -1UL &&
+			    (!next || (rend + 1) < next))
+				next = rend + 1;
+		}
+		if (!next)
+			break;
+		addr = next;
+	}
+
+	return TRUE;
+}
+
 /* Check if region complies with constraints */
 static bool is_region_valid(const struct sbi_domain_memregion *reg)
 {
@@ -274,6 +312,127 @@ static int sanitize_domain(const struct sbi_platform *plat,
 	return 0;
 }
 
+static bool is_domain_discovered(const struct sbi_domain *dom)
+{
+	u32 i;
+	const struct sbi_domain *tdom;
+
+	sbi_domain_for_each(i, tdom) {
+		if (tdom == dom)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/** Check if domain can read and write whole channel memory */
+static bool is_channel_accessible(const struct sbi_domain *dom,
+				  const struct sbi_domain_memregion *creg)
+{
+	struct sbi_domain_memregion *reg;
+	unsigned long rstart, rend, cstart, cend;
+	unsigned long rw = SBI_DOMAIN_MEMREGION_READABLE |
+			   SBI_DOMAIN_MEMREGION_WRITEABLE;
+
+	cstart = creg->base;
+	cend = creg->base + (BIT(creg->order) - 1);
+
+	/*
+	 * Regions are sorted so regions inside the channel memory are
+	 * checked before the region covering whole channel memory.
+	 */
+	sbi_domain_for_each_memregion(dom, reg) {
+		rstart = reg->base;
+		rend = (reg->order < __riscv_xlen) ?
+			rstart + ((1UL << reg->order) - 1) : -1UL;
+		if (rend < cstart || cend < rstart)
+			continue;
+
+		if ((reg->flags & rw) != rw ||
+		    (reg->flags & SBI_DOMAIN_MEMREGION_MMIO))
+			return FALSE;
+
+		if (rstart <= cstart && cend <= rend)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static int sanitize_channel(const struct sbi_domain_channel *chan)
+{
+	u32 i;
+	const struct sbi_domain_memregion *reg = &chan->region;
+
+	/* Check shared memory */
+	if (!is_region_valid(reg) || __riscv_xlen <= reg->order) {
+		sbi_printf("%s: %s has invalid region base=0x%lx "
+			   "order=%lu\n", __func__, chan->name,
+			   reg->base, reg->order);
+		return SBI_EINVAL;
+	}
+
+	/* Check peers */
+	for (i = 0; i < array_size(chan->peers); i++) {
+		if (!is_domain_discovered(chan->peers[i])) {
+			sbi_printf("%s: %s peer%d is not a discovered "
+				   "domain\n", __func__, chan->name, i);
+			return SBI_EINVAL;
+		}
+
+		if (!is_channel_accessible(chan->peers[i], reg)) {
+			sbi_printf("%s: %s region is not read-write for "
+				   "%s\n", __func__, chan->name,
+				   chan->peers[i]->name);
+			return SBI_EINVAL;
+		}
+	}
+	if (chan->peers[0] == chan->peers[1]) {
+		sbi_printf("%s: %s connects %s with itself\n",
+			   __func__, chan->name, chan->peers[0]->name);
+		return SBI_EINVAL;
+	}
+
+	return 0;
+}
+
+int sbi_domain_channel_register(struct sbi_domain_channel *chan)
+{
+	if (!chan)
+		return SBI_EINVAL;
+
+	if (SBI_DOMAIN_MAX_CHANNELS <= channel_count)
+		return SBI_ENOSPC;
+
+	chan->index = channel_count++;
+	channel_table[chan->index] = chan;
+
+	return 0;
+}
+
+struct sbi_domain_channel *sbi_domain_channel_get(u32 index)
+{
+	if (channel_count <= index)
+		return NULL;
+
+	return channel_table[index];
+}
+
+struct sbi_domain *sbi_domain_channel_peer(
+				const struct sbi_domain_channel *chan,
+				const struct sbi_domain *dom)
+{
+	if (!chan || !dom)
+		return NULL;
+
+	if (chan->peers[0] == dom)
+		return chan->peers[1];
+	if (chan->peers[1] == dom)
+		return chan->peers[0];
+
+	return NULL;
+}
+
 void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix)
 {
 	u32 i, k;
@@ -354,17 +513,57 @@ void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix)
 
 	sbi_printf("Domain%d SysReset    %s: %s\n",
 		   dom->index, suffix, (dom->system_reset_allowed) ? "yes" : "no");
+
+	if (dom->shared_page)
+#if __riscv_xlen == 32
+		sbi_printf("Domain%d Shared Page %s: 0x%08lx\n",
+#else
+		sbi_printf("Domain%d Shared Page %s: 0x%016lx\n",
+#endif
+			   dom->index, suffix, dom->shared_page);
+
+	if (dom->shared_harts) {
+		k = 0;
+		sbi_printf("Domain%d Shared HARTs%s: ", dom->index, suffix);
+		sbi_hartmask_for_each_hart(i, dom->shared_harts)
+			sbi_printf("%s%d", (k++) ? "," : "", i);
+		sbi_printf("\n");
+
+		sbi_printf("Domain%d Time Budget %s: %lu ticks\n",
+			   dom->index, suffix, dom->time_budget);
+	}
 }
 
 void sbi_domain_dump_all(const char *suffix)
 {
 	u32 i;
+	unsigned long rstart, rend;
 	const struct sbi_domain *dom;
+	const struct sbi_domain_channel *chan;
 
 	sbi_domain_for_each(i, dom) {
 		sbi_domain_dump(dom, suffix);
 		sbi_printf("\n");
 	}
+
+	for (i = 0; i < channel_count; i++) {
+		chan = channel_table[i];
+		rstart = chan->region.base;
+		rend = rstart + ((1UL << chan->region.order) - 1);
+
+		sbi_printf("Channel%d Name       %s: %s\n",
+			   chan->index, suffix, chan->name);
+#if __riscv_xlen == 32
+		sbi_printf("Channel%d Region     %s: 0x%08lx-0x%08lx\n",
+#else
+		sbi_printf("Channel%d Region     %s: 0x%016lx-0x%016lx\n",
+#endif
+			   chan->index, suffix, rstart, rend);
+		sbi_printf("Channel%d Peers      %s: %s,%s\n",
+			   chan->index, suffix, chan->peers[0]->name,
+			   chan->peers[1]->name);
+		sbi_printf("\n");
+	}
 }
 
 int sbi_domain_finalize(struct sbi_scratch *scratch, u32 cold_hartid)
@@ -454,6 +653,17 @@ int sbi_domain_finalize(struct sbi_scratch *scratch, u32 cold_hartid)
 		}
 	}
 
+	/* Validate inter-domain channels */
+	for (i = 0; i < channel_count; i++) {
+		rc = sanitize_channel(channel_table[i]);
+		if (rc) {
+			sbi_printf("%s: sanity checks failed for channel"
+				   " %s (error %d)\n", __func__,
+				   channel_table[i]->name, rc);
+			return rc;
+		}
+	}
+
 	/* Startup boot HART of domains */
 	sbi_domain_for_each(i, dom) {
 		/* Domain boot HART */
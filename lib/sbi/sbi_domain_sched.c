@@ -0,0 +1,552 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_csr_detect.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fwtime.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_hartmask.h>
+#include <sbi/sbi_hfence.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
+#include <sbi/sbi_trap.h>
+
+#ifdef __riscv_flen
+#if __riscv_flen == 64
+#define FP_SIZE			"8"
+#define FP_LOAD			"fld"
+#define FP_STORE		"fsd"
+#else
+#define FP_SIZE			"4"
+#define FP_LOAD			"flw"
+#define FP_STORE		"fsw"
+#endif
+#define FP_SAVE(__n)		FP_STORE " f" #__n ", " #__n "*" FP_SIZE "(%0)\n"
+#define FP_RESTORE(__n)		FP_LOAD " f" #__n ", " #__n "*" FP_SIZE "(%0)\n"
+#endif
+
+/* Bits of SIE and SIP owned by the running domain */
+#define SCHED_SIE_MASK		(MIP_SSIP | MIP_STIP | MIP_SEIP)
+#define SCHED_SIP_MASK		(MIP_SSIP | MIP_STIP)
+
+/** S-mode state of a domain on a time-shared HART */
+struct domain_sched_ctx {
+	/** Domain of this context */
+	struct sbi_domain *dom;
+	/** Time slice in timer ticks */
+	u64 budget;
+	/** Has the domain entered S-mode on the HART */
+	bool booted;
+	/** S-mode IPI sent to the domain while switched out */
+	atomic_t ssip;
+	/** Register state when switched out */
+	struct sbi_trap_regs regs;
+	/** S-mode CSRs when switched out */
+	unsigned long stvec;
+	unsigned long sscratch;
+	unsigned long sepc;
+	unsigned long scause;
+	unsigned long stval;
+	unsigned long satp;
+	unsigned long scounteren;
+	unsigned long sie;
+	unsigned long sip;
+	unsigned long senvcfg;
+	/** Sstc timer compare value when switched out */
+	u64 stimecmp;
+	/** Timer event of the domain when switched out */
+	u64 time_event;
+#ifdef __riscv_flen
+	/** Floating-point state when switched out */
+	u64 fp[32];
+	unsigned long fcsr;
+#endif
+};
+
+/** Per-HART scheduler state */
+struct domain_sched_hart {
+	/** Number of contexts (slot zero is the owner domain) */
+	u32 count;
+	/** Slot of the running context */
+	u32 current;
+	/** Timer value when the running context has to be switched out */
+	u64 budget_end;
+	/** Running context gave up its time slice */
+	bool yield;
+	/** HART has the senvcfg CSR */
+	bool senvcfg;
+	/** HART has the Sstc extension */
+	bool sstc;
+	struct domain_sched_ctx *ctx[SBI_DOMAIN_SCHED_MAX_SLOTS];
+};
+
+static unsigned long sched_hart_off;
+
+static u32 sched_ctx_count;
+static struct domain_sched_ctx sched_ctx_pool[SBI_DOMAIN_SCHED_MAX_CONTEXTS];
+
+static struct domain_sched_hart *sched_hart_ptr(struct sbi_scratch *scratch)
+{
+	if (!sched_hart_off)
+		return NULL;
+
+	return sbi_scratch_offset_ptr(scratch, sched_hart_off);
+}
+
+bool sbi_domain_sched_is_owner(const struct sbi_domain *dom, u32 hartid)
+{
+	struct sbi_scratch *scratch;
+	struct domain_sched_hart *sh;
+
+	if (SBI_HARTMASK_MAX_BITS <= hartid)
+		return TRUE;
+	scratch = sbi_hartid_to_scratch(hartid);
+	if (!scratch)
+		return TRUE;
+	sh = sched_hart_ptr(scratch);
+	if (!sh || sh->count < 2)
+		return TRUE;
+
+	return (sh->ctx[0]->dom == dom) ? TRUE : FALSE;
+}
+
+bool sbi_domain_sched_is_shared(u32 hartid)
+{
+	struct sbi_scratch *scratch;
+	struct domain_sched_hart *sh;
+
+	if (SBI_HARTMASK_MAX_BITS <= hartid)
+		return FALSE;
+	scratch = sbi_hartid_to_scratch(hartid);
+	if (!scratch)
+		return FALSE;
+	sh = sched_hart_ptr(scratch);
+
+	return (sh && sh->count > 1) ? TRUE : FALSE;
+}
+
+int sbi_domain_sched_yield(void)
+{
+	struct domain_sched_hart *sh =
+			sched_hart_ptr(sbi_scratch_thishart_ptr());
+
+	if (sh && sh->count > 1)
+		sh->yield = TRUE;
+
+	return 0;
+}
+
+void sbi_domain_sched_ipi_update(struct sbi_scratch *remote_scratch,
+				 const struct sbi_domain *dom)
+{
+	u32 i;
+	struct domain_sched_hart *sh = sched_hart_ptr(remote_scratch);
+
+	if (!sh || sh->count < 2)
+		return;
+
+	for (i = 0; i < sh->count; i++) {
+		if (sh->ctx[i]->dom == dom) {
+			atomic_write(&sh->ctx[i]->ssip, 1);
+			break;
+		}
+	}
+}
+
+bool sbi_domain_sched_ipi_process(struct sbi_scratch *scratch)
+{
+	struct domain_sched_hart *sh = sched_hart_ptr(scratch);
+
+	if (!sh || sh->count < 2)
+		return TRUE;
+
+	return atomic_xchg(&sh->ctx[sh->current]->ssip, 0) ? TRUE : FALSE;
+}
+
+#ifdef __riscv_flen
+static void sched_fp_save(struct domain_sched_ctx *ctx)
+{
+	__asm__ __volatile__(
+		FP_SAVE(0) FP_SAVE(1) FP_SAVE(2) FP_SAVE(3)
+		FP_SAVE(4) FP_SAVE(5) FP_SAVE(6) FP_SAVE(7)
+		FP_SAVE(8) FP_SAVE(9) FP_SAVE(10) FP_SAVE(11)
+		FP_SAVE(12) FP_SAVE(13) FP_SAVE(14) FP_SAVE(15)
+		FP_SAVE(16) FP_SAVE(17) FP_SAVE(18) FP_SAVE(19)
+		FP_SAVE(20) FP_SAVE(21) FP_SAVE(22) FP_SAVE(23)
+		FP_SAVE(24) FP_SAVE(25) FP_SAVE(26) FP_SAVE(27)
+		FP_SAVE(28) FP_SAVE(29) FP_SAVE(30) FP_SAVE(31)
+		: : "r"(ctx->fp) : "memory");
+	ctx->fcsr = csr_read(CSR_FCSR);
+}
+
+static void sched_fp_restore(const struct domain_sched_ctx *ctx)
+{
+	__asm__ __volatile__(
+		FP_RESTORE(0) FP_RESTORE(1) FP_RESTORE(2) FP_RESTORE(3)
+		FP_RESTORE(4) FP_RESTORE(5) FP_RESTORE(6) FP_RESTORE(7)
+		FP_RESTORE(8) FP_RESTORE(9) FP_RESTORE(10) FP_RESTORE(11)
+		FP_RESTORE(12) FP_RESTORE(13) FP_RESTORE(14) FP_RESTORE(15)
+		FP_RESTORE(16) FP_RESTORE(17) FP_RESTORE(18) FP_RESTORE(19)
+		FP_RESTORE(20) FP_RESTORE(21) FP_RESTORE(22) FP_RESTORE(23)
+		FP_RESTORE(24) FP_RESTORE(25) FP_RESTORE(26) FP_RESTORE(27)
+		FP_RESTORE(28) FP_RESTORE(29) FP_RESTORE(30) FP_RESTORE(31)
+		: : "r"(ctx->fp) : "memory");
+	csr_write(CSR_FCSR, ctx->fcsr);
+}
+
+static void sched_fp_switch(struct domain_sched_ctx *out,
+			    struct domain_sched_ctx *in)
+{
+	unsigned long mstatus;
+	bool out_fp = (out->regs.mstatus & MSTATUS_FS) ? TRUE : FALSE;
+	bool in_fp = (in->regs.mstatus & MSTATUS_FS) ? TRUE : FALSE;
+
+	if (!out_fp && !in_fp)
+		return;
+
+	/* FP registers are accessible only while MSTATUS.FS is not Off */
+	mstatus = csr_read_set(CSR_MSTATUS, MSTATUS_FS);
+
+	if (out_fp)
+		sched_fp_save(out);
+
+	/* Registers of outgoing domain must not leak to incoming domain */
+	if (!in_fp) {
+		sbi_memset(in->fp, 0, sizeof(in->fp));
+		in->fcsr = 0;
+	}
+	sched_fp_restore(in);
+
+	csr_write(CSR_MSTATUS, mstatus);
+}
+#else
+static void sched_fp_switch(struct domain_sched_ctx *out,
+			    struct domain_sched_ctx *in)
+{
+}
+#endif
+
+#if __riscv_xlen == 32
+static u64 sched_stimecmp_read(void)
+{
+	u32 lo, hi;
+
+	do {
+		hi = csr_read(CSR_STIMECMPH);
+		lo = csr_read(CSR_STIMECMP);
+	} while (hi != csr_read(CSR_STIMECMPH));
+
+	return ((u64)hi << 32) | lo;
+}
+
+static void sched_stimecmp_write(u64 val)
+{
+	/* Avoid a spurious timer interrupt while writing the halves */
+	csr_write(CSR_STIMECMP, -1UL);
+	csr_write(CSR_STIMECMPH, (u32)(val >> 32));
+	csr_write(CSR_STIMECMP, (u32)val);
+}
+#else
+static u64 sched_stimecmp_read(void)
+{
+	return csr_read(CSR_STIMECMP);
+}
+
+static void sched_stimecmp_write(u64 val)
+{
+	csr_write(CSR_STIMECMP, val);
+}
+#endif
+
+/*
+ * S-mode external interrupts are routed to the owner domain only. Other
+ * domains run with them neither delegated nor enabled so a pending one
+ * stays pending until the owner domain is switched in.
+ */
+static void sched_sei_route(bool owner)
+{
+	if (owner) {
+		csr_set(CSR_MIDELEG, MIP_SEIP);
+	} else {
+		csr_clear(CSR_MIE, MIP_SEIP);
+		csr_clear(CSR_MIDELEG, MIP_SEIP);
+	}
+}
+
+static void sched_ctx_save(struct domain_sched_hart *sh,
+			   struct domain_sched_ctx *ctx,
+			   struct sbi_trap_regs *regs)
+{
+	u64 next_event;
+
+	sbi_memcpy(&ctx->regs, regs, sizeof(*regs));
+
+	ctx->stvec = csr_read(CSR_STVEC);
+	ctx->sscratch = csr_read(CSR_SSCRATCH);
+	ctx->sepc = csr_read(CSR_SEPC);
+	ctx->scause = csr_read(CSR_SCAUSE);
+	ctx->stval = csr_read(CSR_STVAL);
+	ctx->satp = csr_read(CSR_SATP);
+	ctx->scounteren = csr_read(CSR_SCOUNTEREN);
+	ctx->sie = csr_read(CSR_SIE) & SCHED_SIE_MASK;
+	ctx->sip = csr_read_clear(CSR_MIP, SCHED_SIP_MASK) & SCHED_SIP_MASK;
+	if (ctx->sip & MIP_SSIP)
+		atomic_write(&ctx->ssip, 1);
+	if (sh->senvcfg)
+		ctx->senvcfg = csr_read(CSR_SENVCFG);
+	if (sh->sstc) {
+		ctx->stimecmp = sched_stimecmp_read();
+		sched_stimecmp_write(-1ULL);
+	}
+
+	ctx->time_event = -1ULL;
+	if (sbi_timer_event_pending(&next_event))
+		ctx->time_event = next_event;
+	sbi_timer_event_stop();
+}
+
+static void sched_ctx_boot(struct domain_sched_ctx *ctx,
+			   const struct sbi_trap_regs *regs, u32 hartid)
+{
+	struct sbi_domain *dom = ctx->dom;
+
+	/* Same as sbi_hart_switch_mode() for an S-mode next stage */
+	sbi_memset(&ctx->regs, 0, sizeof(ctx->regs));
+	ctx->regs.a0 = hartid;
+	ctx->regs.a1 = dom->next_arg1;
+	ctx->regs.mepc = dom->next_addr;
+	ctx->regs.mstatus = regs->mstatus & ~(MSTATUS_SIE | MSTATUS_SPIE |
+					      MSTATUS_SPP | MSTATUS_MPIE |
+					      MSTATUS_SUM | MSTATUS_MXR);
+	ctx->regs.mstatus = INSERT_FIELD(ctx->regs.mstatus,
+					 MSTATUS_MPP, PRV_S);
+#if __riscv_xlen == 32
+	ctx->regs.mstatusH = regs->mstatusH & ~MSTATUSH_MPV;
+#else
+	ctx->regs.mstatus &= ~MSTATUS_MPV;
+#endif
+
+	ctx->stvec = dom->next_addr;
+	ctx->sscratch = 0;
+	ctx->sepc = 0;
+	ctx->scause = 0;
+	ctx->stval = 0;
+	ctx->satp = 0;
+	ctx->scounteren = 0;
+	ctx->sie = 0;
+	ctx->sip = 0;
+	ctx->senvcfg = 0;
+	ctx->stimecmp = -1ULL;
+	ctx->time_event = -1ULL;
+#ifdef __riscv_flen
+	sbi_memset(ctx->fp, 0, sizeof(ctx->fp));
+	ctx->fcsr = 0;
+#endif
+	ctx->booted = TRUE;
+}
+
+static void sched_ctx_restore(struct domain_sched_hart *sh,
+			      struct domain_sched_ctx *ctx,
+			      struct sbi_trap_regs *regs)
+{
+	sbi_memcpy(regs, &ctx->regs, sizeof(*regs));
+
+	csr_write(CSR_STVEC, ctx->stvec);
+	csr_write(CSR_SSCRATCH, ctx->sscratch);
+	csr_write(CSR_SEPC, ctx->sepc);
+	csr_write(CSR_SCAUSE, ctx->scause);
+	csr_write(CSR_STVAL, ctx->stval);
+	csr_write(CSR_SATP, ctx->satp);
+	csr_write(CSR_SCOUNTEREN, ctx->scounteren);
+	if (sh->senvcfg)
+		csr_write(CSR_SENVCFG, ctx->senvcfg);
+	if (sh->sstc)
+		sched_stimecmp_write(ctx->stimecmp);
+	sched_sei_route(ctx == sh->ctx[0]);
+	csr_clear(CSR_SIE, SCHED_SIE_MASK);
+	csr_set(CSR_SIE, ctx->sie);
+
+	/* Starting timer event clears STIP so restore SIP afterwards */
+	if (ctx->time_event != -1ULL)
+		sbi_timer_event_start(ctx->time_event);
+	if (atomic_xchg(&ctx->ssip, 0))
+		ctx->sip |= MIP_SSIP;
+	csr_set(CSR_MIP, ctx->sip);
+}
+
+static void sched_switch(struct sbi_scratch *scratch,
+			 struct domain_sched_hart *sh,
+			 struct sbi_trap_regs *regs, u64 now)
+{
+	u64 latency;
+	u32 hartid = current_hartid();
+	u32 fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_DOMAIN_SWITCH);
+	u32 prev = sh->current, next = (sh->current + 1) % sh->count;
+	struct domain_sched_ctx *out = sh->ctx[prev], *in = sh->ctx[next];
+
+	latency = (sh->yield || now < sh->budget_end) ?
+		  0 : now - sh->budget_end;
+
+	sched_ctx_save(sh, out, regs);
+	if (!in->booted)
+		sched_ctx_boot(in, regs, hartid);
+	sched_fp_switch(out, in);
+
+	/* Memory of outgoing domain must not be accessible any more */
+	hartid_to_domain_table[hartid] = in->dom;
+	sbi_hart_pmp_unconfigure(scratch);
+	sbi_hart_pmp_configure(scratch);
+
+	sched_ctx_restore(sh, in, regs);
+	__asm__ __volatile__("sfence.vma" : : : "memory");
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H')))
+		__sbi_hfence_gvma_all();
+
+	sh->current = next;
+	sh->yield = FALSE;
+	sh->budget_end = sbi_timer_value() + in->budget;
+	sbi_timer_deadline_start(sh->budget_end);
+
+	sbi_trace(SBI_TRACE_DOMAIN_SWITCH, in->dom->index, out->dom->index,
+		  latency, sbi_timer_value() - now);
+	sbi_fwtime_exit(fwtime_prev);
+}
+
+void sbi_domain_sched_trap_exit(struct sbi_trap_regs *regs)
+{
+	u64 now;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	struct domain_sched_hart *sh = sched_hart_ptr(scratch);
+
+	if (!sh || sh->count < 2)
+		return;
+
+	/* Domains are switched only when returning to S-mode or U-mode */
+	if (((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) == PRV_M)
+		return;
+
+	now = sbi_timer_value();
+	if (!sh->yield && now < sh->budget_end)
+		return;
+
+	sched_switch(scratch, sh, regs, now);
+}
+
+static int sched_ctx_add(struct sbi_scratch *scratch,
+			 struct sbi_domain *dom, bool booted)
+{
+	struct domain_sched_ctx *ctx;
+	struct domain_sched_hart *sh = sched_hart_ptr(scratch);
+
+	if (SBI_DOMAIN_SCHED_MAX_SLOTS <= sh->count ||
+	    SBI_DOMAIN_SCHED_MAX_CONTEXTS <= sched_ctx_count)
+		return SBI_ENOSPC;
+
+	ctx = &sched_ctx_pool[sched_ctx_count++];
+	ctx->dom = dom;
+	ctx->budget = (dom->time_budget) ?
+		      dom->time_budget : SBI_DOMAIN_SCHED_DEFAULT_BUDGET;
+	ctx->booted = booted;
+	ATOMIC_INIT(&ctx->ssip, 0);
+	sh->ctx[sh->count++] = ctx;
+
+	return 0;
+}
+
+static int sched_populate(void)
+{
+	int rc;
+	u32 i, hartid;
+	struct sbi_scratch *scratch;
+	struct sbi_domain *dom, *owner;
+
+	sbi_domain_for_each(i, dom) {
+		if (!dom->shared_harts)
+			continue;
+
+		if (dom->next_mode != PRV_S) {
+			sbi_printf("%s: %s can't time-share HARTs because"
+				   " next mode is not S-mode\n",
+				   __func__, dom->name);
+			continue;
+		}
+
+		sbi_hartmask_for_each_hart(hartid, dom->shared_harts) {
+			/* Only HARTs owned by another domain are shared */
+			owner = sbi_hartid_to_domain(hartid);
+			scratch = sbi_hartid_to_scratch(hartid);
+			if (!owner || owner == dom || !scratch)
+				continue;
+
+			/* Owner domain always occupies slot zero */
+			if (!sched_hart_ptr(scratch)->count) {
+				rc = sched_ctx_add(scratch, owner, TRUE);
+				if (rc)
+					return rc;
+			}
+
+			rc = sched_ctx_add(scratch, dom, FALSE);
+			if (rc) {
+				sbi_printf("%s: no room for %s on HART %d\n",
+					   __func__, dom->name, hartid);
+				return rc;
+			}
+			sbi_hartmask_set_hart(hartid, &dom->assigned_harts);
+		}
+	}
+
+	return 0;
+}
+
+int sbi_domain_sched_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	int rc;
+	struct sbi_trap_info trap;
+	u32 hartid = current_hartid();
+	struct domain_sched_hart *sh;
+
+	if (cold_boot) {
+		sched_hart_off = sbi_scratch_alloc_offset(sizeof(*sh),
+							  "DOMAIN_SCHED");
+		if (!sched_hart_off)
+			return SBI_ENOMEM;
+
+		/* Per-HART state of all HARTs is zeroed by the allocator */
+		rc = sched_populate();
+		if (rc)
+			return rc;
+	} else {
+		if (!sched_hart_off)
+			return SBI_ENOMEM;
+	}
+
+	sh = sched_hart_ptr(scratch);
+	if (sh->count < 2)
+		return 0;
+
+	trap.cause = 0;
+	csr_read_allowed(CSR_SENVCFG, (ulong)&trap);
+	sh->senvcfg = !trap.cause;
+	sh->sstc = sbi_hart_has_extension(scratch, SBI_HART_EXT_SSTC);
+
+	/*
+	 * The HART is (re)started by its owner domain whereas contexts
+	 * of other domains are resumed where they were switched out.
+	 */
+	sh->current = 0;
+	sh->yield = FALSE;
+	hartid_to_domain_table[hartid] = sh->ctx[0]->dom;
+	sh->budget_end = sbi_timer_value() + sh->ctx[0]->budget;
+	sbi_timer_deadline_start(sh->budget_end);
+
+	return 0;
+}
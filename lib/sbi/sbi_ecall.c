@@ -11,6 +11,8 @@
 #include <sbi/sbi_ecall.h>
 #include <sbi/sbi_ecall_interface.h>
 #include <sbi/sbi_error.h>
+#include <sbi/sbi_record.h>
+#include <sbi/sbi_trace.h>
 #include <sbi/sbi_trap.h>
 
 u16 sbi_ecall_version_major(void)
@@ -37,6 +39,11 @@ void sbi_ecall_set_impid(unsigned long impid)
 
 static SBI_LIST_HEAD(ecall_exts_list);
 
+struct sbi_dlist *sbi_ecall_get_extensions_head(void)
+{
+	return &ecall_exts_list;
+}
+
 struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid)
 {
 	struct sbi_ecall_extension *t, *ret = NULL;
@@ -51,6 +58,23 @@ struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid)
 	return ret;
 }
 
+int sbi_ecall_probe_extension(unsigned long extid, unsigned long *out_val)
+{
+	struct sbi_ecall_extension *ext;
+
+	ext = sbi_ecall_find_extension(extid);
+	if (!ext) {
+		*out_val = 0;
+		return 0;
+	}
+
+	if (ext->probe)
+		return ext->probe(extid, out_val);
+
+	*out_val = 1;
+	return 0;
+}
+
 int sbi_ecall_register_extension(struct sbi_ecall_extension *ext)
 {
 	struct sbi_ecall_extension *t;
@@ -110,6 +134,8 @@ int sbi_ecall_handler(struct sbi_trap_regs *regs)
 	args[4] = regs->a4;
 	args[5] = regs->a5;
 
+	sbi_record_ecall(extension_id, func_id, args);
+
 	ext = sbi_ecall_find_extension(extension_id);
 	if (ext && ext->handle) {
 		ret = ext->handle(extension_id, func_id,
@@ -121,6 +147,8 @@ int sbi_ecall_handler(struct sbi_trap_regs *regs)
 		ret = SBI_ENOTSUPP;
 	}
 
+	sbi_trace(SBI_TRACE_ECALL, 0, func_id, extension_id, ret);
+
 	if (ret == SBI_ETRAP) {
 		trap.epc = regs->mepc;
 		sbi_trap_redirect(regs, &trap);
@@ -149,35 +177,78 @@ int sbi_ecall_handler(struct sbi_trap_regs *regs)
 	return 0;
 }
 
+/* The order of below extensions is performance optimized */
+static struct sbi_ecall_extension *ecall_exts[] = {
+#ifdef CONFIG_SBI_ECALL_TIME
+	&ecall_time,
+#endif
+#ifdef CONFIG_SBI_ECALL_RFENCE
+	&ecall_rfence,
+#endif
+#ifdef CONFIG_SBI_ECALL_IPI
+	&ecall_ipi,
+#endif
+	&ecall_base,
+#ifdef CONFIG_SBI_ECALL_HSM
+	&ecall_hsm,
+#endif
+#ifdef CONFIG_SBI_ECALL_SRST
+	&ecall_srst,
+#endif
+#ifdef CONFIG_SBI_ECALL_SUSP
+	&ecall_susp,
+#endif
+#ifdef CONFIG_SBI_ECALL_CACHE
+	&ecall_cache,
+#endif
+#ifdef CONFIG_SBI_ECALL_STACK
+	&ecall_stack,
+#endif
+#ifdef CONFIG_SBI_ECALL_PERF_PROFILE
+	&ecall_perf_profile,
+#endif
+#ifdef CONFIG_SBI_ECALL_SHPAGE
+	&ecall_shpage,
+#endif
+#ifdef CONFIG_SBI_ECALL_FWTIME
+	&ecall_fwtime,
+#endif
+#ifdef CONFIG_SBI_TRACE
+	&ecall_trace,
+#endif
+#ifdef CONFIG_SBI_MPROF
+	&ecall_mprof,
+#endif
+#ifdef CONFIG_SBI_SSE
+	&ecall_sse,
+#endif
+#ifdef CONFIG_SBI_DOMAIN_SCHED
+	&ecall_dsched,
+#endif
+#ifdef CONFIG_SBI_ECALL_DCHAN
+	&ecall_dchan,
+#endif
+#ifdef CONFIG_SBI_ECALL_TUNE
+	&ecall_tune,
+#endif
+#ifdef CONFIG_SBI_ECALL_LEGACY
+	&ecall_legacy,
+#endif
+#ifdef CONFIG_SBI_ECALL_VENDOR
+	&ecall_vendor,
+#endif
+};
+
 int sbi_ecall_init(void)
 {
 	int ret;
+	u32 i;
 
-	/* The order of below registrations is performance optimized */
-	ret = sbi_ecall_register_extension(&ecall_time);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_rfence);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_ipi);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_base);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_hsm);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_srst);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_legacy);
-	if (ret)
-		return ret;
-	ret = sbi_ecall_register_extension(&ecall_vendor);
-	if (ret)
-		return ret;
+	for (i = 0; i < array_size(ecall_exts); i++) {
+		ret = sbi_ecall_register_extension(ecall_exts[i]);
+		if (ret)
+			return ret;
+	}
 
 	return 0;
 }
@@ -14,23 +14,6 @@
 #include <sbi/sbi_version.h>
 #include <sbi/riscv_asm.h>
 
-static int sbi_ecall_base_probe(unsigned long extid, unsigned long *out_val)
-{
-	struct sbi_ecall_extension *ext;
-
-	ext = sbi_ecall_find_extension(extid);
-	if (!ext) {
-		*out_val = 0;
-		return 0;
-	}
-
-	if (ext->probe)
-		return ext->probe(extid, out_val);
-
-	*out_val = 1;
-	return 0;
-}
-
 static int sbi_ecall_base_handler(unsigned long extid, unsigned long funcid,
 				  unsigned long *args, unsigned long *out_val,
 				  struct sbi_trap_info *out_trap)
@@ -61,7 +44,7 @@ static int sbi_ecall_base_handler(unsigned long extid, unsigned long funcid,
 		*out_val = csr_read(CSR_MIMPID);
 		break;
 	case SBI_EXT_BASE_PROBE_EXT:
-		ret = sbi_ecall_base_probe(args[0], out_val);
+		ret = sbi_ecall_probe_extension(args[0], out_val);
 		break;
 	default:
 		ret = SBI_ENOTSUPP;
@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_cache.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+
+static int sbi_ecall_cache_handler(unsigned long extid, unsigned long funcid,
+				   unsigned long *args, unsigned long *out_val,
+				   struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_CACHE_GET_BLOCK_SIZE:
+		*out_val = sbi_cache_block_size();
+		break;
+	case SBI_EXT_CACHE_CLEAN:
+		ret = sbi_cache_op(SBI_CACHE_CLEAN, args[0], args[1]);
+		break;
+	case SBI_EXT_CACHE_INVAL:
+		ret = sbi_cache_op(SBI_CACHE_INVAL, args[0], args[1]);
+		break;
+	case SBI_EXT_CACHE_FLUSH:
+		ret = sbi_cache_op(SBI_CACHE_FLUSH, args[0], args[1]);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+static int sbi_ecall_cache_probe(unsigned long extid, unsigned long *out_val)
+{
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
+
+	/* Either Zicbom or platform cache maintenance is required */
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_ZICBOM) ||
+	    sbi_platform_ops(plat)->cache_op)
+		*out_val = 1;
+	else
+		*out_val = 0;
+
+	return 0;
+}
+
+struct sbi_ecall_extension ecall_cache = {
+	.extid_start = SBI_EXT_CACHE,
+	.extid_end = SBI_EXT_CACHE,
+	.handle = sbi_ecall_cache_handler,
+	.probe = sbi_ecall_cache_probe,
+};
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_ipi.h>
+#include <sbi/sbi_scratch.h>
+
+static int sbi_ecall_dchan_handler(unsigned long extid, unsigned long funcid,
+				   unsigned long *args, unsigned long *out_val,
+				   struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+	struct sbi_domain *peer;
+	struct sbi_domain_channel *chan;
+
+	if (SBI_DOMAIN_MAX_CHANNELS <= args[0])
+		return SBI_EINVAL;
+	chan = sbi_domain_channel_get(args[0]);
+
+	/* Only domains connected by the channel can use it */
+	peer = sbi_domain_channel_peer(chan, sbi_domain_thishart_ptr());
+	if (!peer)
+		return SBI_EINVAL;
+
+	switch (funcid) {
+	case SBI_EXT_DCHAN_GET_ADDR:
+		*out_val = chan->region.base;
+		break;
+	case SBI_EXT_DCHAN_GET_SIZE:
+		*out_val = 1UL << chan->region.order;
+		break;
+	case SBI_EXT_DCHAN_RING:
+		ret = sbi_ipi_send_smode_domain(peer, args[1], args[2]);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_dchan = {
+	.extid_start = SBI_EXT_DCHAN,
+	.extid_end = SBI_EXT_DCHAN,
+	.handle = sbi_ecall_dchan_handler,
+};
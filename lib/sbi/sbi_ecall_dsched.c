@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+
+static int sbi_ecall_dsched_handler(unsigned long extid, unsigned long funcid,
+				    unsigned long *args, unsigned long *out_val,
+				    struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_DSCHED_YIELD:
+		ret = sbi_domain_sched_yield();
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_dsched = {
+	.extid_start = SBI_EXT_DSCHED,
+	.extid_end = SBI_EXT_DSCHED,
+	.handle = sbi_ecall_dsched_handler,
+};
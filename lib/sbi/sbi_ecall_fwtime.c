@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fwtime.h>
+
+static int sbi_ecall_fwtime_handler(unsigned long extid, unsigned long funcid,
+				    unsigned long *args, unsigned long *out_val,
+				    struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_FWTIME_SET_SHMEM:
+		ret = sbi_fwtime_set_shmem(args[0]);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_fwtime = {
+	.extid_start = SBI_EXT_FWTIME,
+	.extid_end = SBI_EXT_FWTIME,
+	.handle = sbi_ecall_fwtime_handler,
+};
@@ -8,6 +8,7 @@
  */
 
 #include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
 #include <sbi/sbi_ecall.h>
 #include <sbi/sbi_ecall_interface.h>
 #include <sbi/sbi_error.h>
@@ -26,12 +27,23 @@ static int sbi_ecall_hsm_handler(unsigned long extid, unsigned long funcid,
 
 	switch (funcid) {
 	case SBI_EXT_HSM_HART_START:
+		/* Only owner domain can start a time-shared HART */
+		if (!sbi_domain_sched_is_owner(sbi_domain_thishart_ptr(),
+					       args[0])) {
+			ret = SBI_EDENIED;
+			break;
+		}
 		smode = csr_read(CSR_MSTATUS);
 		smode = (smode & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
 		ret = sbi_hsm_hart_start(scratch, sbi_domain_thishart_ptr(),
 					 args[0], args[1], smode, args[2]);
 		break;
 	case SBI_EXT_HSM_HART_STOP:
+		if (!sbi_domain_sched_is_owner(sbi_domain_thishart_ptr(),
+					       current_hartid())) {
+			ret = SBI_EDENIED;
+			break;
+		}
 		ret = sbi_hsm_hart_stop(scratch, TRUE);
 		break;
 	case SBI_EXT_HSM_HART_GET_STATUS:
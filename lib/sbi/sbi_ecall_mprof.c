@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_mprof.h>
+#include <sbi/sbi_scratch.h>
+
+static int sbi_ecall_mprof_handler(unsigned long extid, unsigned long funcid,
+				   unsigned long *args, unsigned long *out_val,
+				   struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	/* Sampling interrupts every HART so only the root domain controls it */
+	if (sbi_domain_thishart_ptr() != sbi_domain_root_ptr())
+		return SBI_EDENIED;
+
+	switch (funcid) {
+	case SBI_EXT_MPROF_SET_SHMEM:
+		ret = sbi_mprof_set_shmem(args[0], args[1]);
+		break;
+	case SBI_EXT_MPROF_START:
+		ret = sbi_mprof_start(args[0], args[1]);
+		if (ret >= 0) {
+			*out_val = ret;
+			ret = 0;
+		}
+		break;
+	case SBI_EXT_MPROF_STOP:
+		ret = sbi_mprof_stop();
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_mprof = {
+	.extid_start = SBI_EXT_MPROF,
+	.extid_end = SBI_EXT_MPROF,
+	.handle = sbi_ecall_mprof_handler,
+};
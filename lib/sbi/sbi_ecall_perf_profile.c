@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_perf_profile.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+
+/*
+ * Return bytes of profile name starting at "offset" packed in little
+ * endian order so that names can be read without shared memory.
+ */
+static int perf_profile_get_name(u32 index, unsigned long offset,
+				 unsigned long *out_val)
+{
+	size_t i, len;
+	unsigned long val = 0;
+	const struct sbi_perf_profile *prof = sbi_perf_profile_get(index);
+
+	if (!prof)
+		return SBI_EINVAL;
+
+	len = sbi_strlen(prof->name);
+	for (i = 0; i < sizeof(val) && (offset + i) < len; i++)
+		val |= (unsigned long)(u8)prof->name[offset + i] << (i * 8);
+
+	*out_val = val;
+	return 0;
+}
+
+static int sbi_ecall_perf_profile_handler(unsigned long extid,
+					  unsigned long funcid,
+					  unsigned long *args,
+					  unsigned long *out_val,
+					  struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_PERF_PROFILE_GET_COUNT:
+		*out_val = sbi_perf_profile_count();
+		break;
+	case SBI_EXT_PERF_PROFILE_GET_NAME:
+		ret = perf_profile_get_name(args[0], args[1], out_val);
+		break;
+	case SBI_EXT_PERF_PROFILE_GET_CURRENT:
+		ret = sbi_perf_profile_current(sbi_scratch_thishart_ptr());
+		if (ret >= 0) {
+			*out_val = ret;
+			ret = 0;
+		}
+		break;
+	case SBI_EXT_PERF_PROFILE_SWITCH:
+		/* HART settings are shared by all domains */
+		if (sbi_domain_thishart_ptr() != sbi_domain_root_ptr()) {
+			ret = SBI_EDENIED;
+			break;
+		}
+		ret = sbi_perf_profile_switch(args[0], args[1], args[2]);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+static int sbi_ecall_perf_profile_probe(unsigned long extid,
+					unsigned long *out_val)
+{
+	*out_val = (sbi_perf_profile_count()) ? 1 : 0;
+	return 0;
+}
+
+struct sbi_ecall_extension ecall_perf_profile = {
+	.extid_start = SBI_EXT_PERF_PROFILE,
+	.extid_end = SBI_EXT_PERF_PROFILE,
+	.handle = sbi_ecall_perf_profile_handler,
+	.probe = sbi_ecall_perf_profile_probe,
+};
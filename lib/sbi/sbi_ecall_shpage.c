@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_shpage.h>
+
+static int sbi_ecall_shpage_handler(unsigned long extid, unsigned long funcid,
+				    unsigned long *args, unsigned long *out_val,
+				    struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_SHPAGE_SET_SHMEM:
+		ret = sbi_shpage_set(sbi_domain_thishart_ptr(), args[0]);
+		break;
+	case SBI_EXT_SHPAGE_GET_SHMEM:
+		*out_val = sbi_shpage_get(sbi_domain_thishart_ptr());
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_shpage = {
+	.extid_start = SBI_EXT_SHPAGE,
+	.extid_end = SBI_EXT_SHPAGE,
+	.handle = sbi_ecall_shpage_handler,
+};
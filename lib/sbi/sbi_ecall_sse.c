@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_sse.h>
+
+static int sbi_ecall_sse_handler(unsigned long extid, unsigned long funcid,
+				 unsigned long *args, unsigned long *out_val,
+				 struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	/* SSE state of a HART is not switched with the running domain */
+	if (sbi_domain_sched_is_shared(current_hartid()))
+		return SBI_EDENIED;
+
+	switch (funcid) {
+	case SBI_EXT_SSE_READ_ATTRS:
+		ret = sbi_sse_read_attrs(args[0], args[1], args[2],
+					 args[3], args[4]);
+		break;
+	case SBI_EXT_SSE_WRITE_ATTRS:
+		ret = sbi_sse_write_attrs(args[0], args[1], args[2],
+					  args[3], args[4]);
+		break;
+	case SBI_EXT_SSE_REGISTER:
+		ret = sbi_sse_register(args[0], args[1], args[2]);
+		break;
+	case SBI_EXT_SSE_UNREGISTER:
+		ret = sbi_sse_unregister(args[0]);
+		break;
+	case SBI_EXT_SSE_ENABLE:
+		ret = sbi_sse_enable(args[0]);
+		break;
+	case SBI_EXT_SSE_DISABLE:
+		ret = sbi_sse_disable(args[0]);
+		break;
+	case SBI_EXT_SSE_COMPLETE:
+		/* The handler has restored a0-a5 of interrupted context */
+		ret = sbi_sse_complete(args[0], args[1]);
+		break;
+	case SBI_EXT_SSE_INJECT:
+		ret = sbi_sse_inject(args[0], args[1]);
+		break;
+	case SBI_EXT_SSE_HART_UNMASK:
+		ret = sbi_sse_hart_unmask();
+		break;
+	case SBI_EXT_SSE_HART_MASK:
+		ret = sbi_sse_hart_mask();
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_sse = {
+	.extid_start = SBI_EXT_SSE,
+	.extid_end = SBI_EXT_SSE,
+	.handle = sbi_ecall_sse_handler,
+};
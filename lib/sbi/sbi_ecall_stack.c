@@ -0,0 +1,53 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hartmask.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_stack.h>
+
+static int sbi_ecall_stack_handler(unsigned long extid, unsigned long funcid,
+				   unsigned long *args, unsigned long *out_val,
+				   struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+	struct sbi_scratch *scratch;
+
+	switch (funcid) {
+	case SBI_EXT_STACK_GET_SIZE:
+		*out_val = sbi_stack_size(sbi_scratch_thishart_ptr());
+		break;
+	case SBI_EXT_STACK_GET_USAGE:
+		if (SBI_HARTMASK_MAX_BITS <= args[0])
+			return SBI_EINVAL;
+		scratch = sbi_hartid_to_scratch(args[0]);
+		if (!scratch)
+			return SBI_EINVAL;
+		ret = sbi_stack_usage(scratch, out_val);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+static int sbi_ecall_stack_probe(unsigned long extid, unsigned long *out_val)
+{
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	/* Usage tracking needs painted stacks */
+	*out_val = (scratch->options & SBI_SCRATCH_STACK_PAINT) ? 1 : 0;
+
+	return 0;
+}
+
+struct sbi_ecall_extension ecall_stack = {
+	.extid_start = SBI_EXT_STACK,
+	.extid_end = SBI_EXT_STACK,
+	.handle = sbi_ecall_stack_handler,
+	.probe = sbi_ecall_stack_probe,
+};
@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_trace.h>
+
+static int sbi_ecall_trace_handler(unsigned long extid, unsigned long funcid,
+				   unsigned long *args, unsigned long *out_val,
+				   struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+	unsigned long buf = sbi_trace_get_buffer();
+
+	/* Only domains which can read the trace buffer may control it */
+	if (!buf || !sbi_domain_check_addr(sbi_domain_thishart_ptr(), buf,
+					   PRV_S, SBI_DOMAIN_READ))
+		return SBI_ENOTSUPP;
+
+	switch (funcid) {
+	case SBI_EXT_TRACE_GET_BUFFER:
+		*out_val = buf;
+		break;
+	case SBI_EXT_TRACE_GET_MASK:
+		*out_val = sbi_trace_get_mask();
+		break;
+	case SBI_EXT_TRACE_SET_MASK:
+		ret = sbi_trace_set_mask(args[0]);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+static int sbi_ecall_trace_probe(unsigned long extid, unsigned long *out_val)
+{
+	unsigned long buf = sbi_trace_get_buffer();
+
+	*out_val = (buf && sbi_domain_check_addr(sbi_domain_thishart_ptr(),
+						 buf, PRV_S,
+						 SBI_DOMAIN_READ)) ? 1 : 0;
+	return 0;
+}
+
+struct sbi_ecall_extension ecall_trace = {
+	.extid_start = SBI_EXT_TRACE,
+	.extid_end = SBI_EXT_TRACE,
+	.handle = sbi_ecall_trace_handler,
+	.probe = sbi_ecall_trace_probe,
+};
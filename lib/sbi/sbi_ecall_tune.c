@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_tune.h>
+
+static int sbi_ecall_tune_find(unsigned long addr, unsigned long len,
+			       unsigned long *out_val)
+{
+	int ret;
+	char name[SBI_TUNE_NAME_MAX];
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	if (!len || SBI_TUNE_NAME_MAX <= len)
+		return SBI_EINVAL;
+	if (!sbi_domain_check_addr(dom, addr, PRV_S, SBI_DOMAIN_READ) ||
+	    !sbi_domain_check_addr(dom, addr + len - 1, PRV_S,
+				   SBI_DOMAIN_READ))
+		return SBI_EINVALID_ADDR;
+
+	/* Work on a private copy of the name */
+	sbi_memcpy(name, (const void *)addr, len);
+	name[len] = '\0';
+
+	ret = sbi_tune_find(name);
+	if (ret < 0)
+		return SBI_EINVAL;
+
+	*out_val = ret;
+	return 0;
+}
+
+static int sbi_ecall_tune_handler(unsigned long extid, unsigned long funcid,
+				  unsigned long *args, unsigned long *out_val,
+				  struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	/* Firmware parameters are shared by all domains */
+	if (sbi_domain_thishart_ptr() != sbi_domain_root_ptr())
+		return SBI_EDENIED;
+
+	switch (funcid) {
+	case SBI_EXT_TUNE_FIND_PARAM:
+		ret = sbi_ecall_tune_find(args[0], args[1], out_val);
+		break;
+	case SBI_EXT_TUNE_GET_PARAM:
+		ret = sbi_tune_get(args[0], out_val);
+		break;
+	case SBI_EXT_TUNE_SET_PARAM:
+		ret = sbi_tune_set(args[0], args[1]);
+		break;
+	case SBI_EXT_TUNE_GET_PARAM_MIN:
+		ret = sbi_tune_get_range(args[0], out_val, NULL);
+		break;
+	case SBI_EXT_TUNE_GET_PARAM_MAX:
+		ret = sbi_tune_get_range(args[0], NULL, out_val);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_tune = {
+	.extid_start = SBI_EXT_TUNE,
+	.extid_end = SBI_EXT_TUNE,
+	.handle = sbi_ecall_tune_handler,
+};
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fwtime.h>
+#include <sbi/sbi_scratch.h>
+
+struct fwtime_hart {
+	/* MCYCLE value when time was last charged */
+	unsigned long last;
+	/* Category being charged (SBI_FWTIME_NONE outside OpenSBI) */
+	u32 current;
+	/* Shared memory registered by supervisor software */
+	struct sbi_fwtime_shmem *shmem;
+	/* Accumulated cycles indexed by category */
+	u64 cycles[SBI_FWTIME_MAX];
+};
+
+static unsigned long fwtime_off;
+
+static inline void fwtime_charge(struct fwtime_hart *fh)
+{
+	unsigned long now = csr_read(CSR_MCYCLE);
+
+	if (fh->current < SBI_FWTIME_MAX)
+		fh->cycles[fh->current] += now - fh->last;
+	fh->last = now;
+}
+
+static void fwtime_publish(struct fwtime_hart *fh)
+{
+	u32 i;
+	struct sbi_fwtime_shmem *sm = fh->shmem;
+
+	/* Make sequence odd even if memory was never written before */
+	sm->seq |= 0x1;
+	smp_wmb();
+
+	sm->count = SBI_FWTIME_MAX;
+	for (i = 0; i < SBI_FWTIME_MAX; i++)
+		sm->cycles[i] = fh->cycles[i];
+
+	smp_wmb();
+	sm->seq++;
+}
+
+u32 sbi_fwtime_enter(u32 cat)
+{
+	u32 prev_cat;
+	struct fwtime_hart *fh;
+
+	if (!fwtime_off)
+		return SBI_FWTIME_NONE;
+
+	fh = sbi_scratch_thishart_offset_ptr(fwtime_off);
+	fwtime_charge(fh);
+	prev_cat = fh->current;
+	fh->current = cat;
+
+	return prev_cat;
+}
+
+void sbi_fwtime_exit(u32 prev_cat)
+{
+	struct fwtime_hart *fh;
+
+	if (!fwtime_off)
+		return;
+
+	fh = sbi_scratch_thishart_offset_ptr(fwtime_off);
+	fwtime_charge(fh);
+	fh->current = prev_cat;
+
+	/* Publish only when going back to the lower privilege mode */
+	if (prev_cat == SBI_FWTIME_NONE && fh->shmem)
+		fwtime_publish(fh);
+}
+
+u32 sbi_fwtime_trap_category(unsigned long mcause)
+{
+	if (mcause & (1UL << (__riscv_xlen - 1))) {
+		mcause &= ~(1UL << (__riscv_xlen - 1));
+		return (mcause == IRQ_M_SOFT) ?
+			SBI_FWTIME_IPI : SBI_FWTIME_OTHER;
+	}
+
+	switch (mcause) {
+	case CAUSE_SUPERVISOR_ECALL:
+	case CAUSE_MACHINE_ECALL:
+		return SBI_FWTIME_ECALL;
+	case CAUSE_ILLEGAL_INSTRUCTION:
+	case CAUSE_MISALIGNED_LOAD:
+	case CAUSE_MISALIGNED_STORE:
+		return SBI_FWTIME_EMULATION;
+	default:
+		return SBI_FWTIME_OTHER;
+	};
+}
+
+int sbi_fwtime_set_shmem(unsigned long addr)
+{
+	struct fwtime_hart *fh;
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	if (!fwtime_off)
+		return SBI_ENOTSUPP;
+	/* Time of other domains must not leak into the shared memory */
+	if (sbi_domain_sched_is_shared(current_hartid()))
+		return SBI_EDENIED;
+	fh = sbi_scratch_thishart_offset_ptr(fwtime_off);
+
+	if (addr == SBI_FWTIME_SHMEM_DISABLE) {
+		fh->shmem = NULL;
+		return 0;
+	}
+
+	if (addr & (SBI_FWTIME_SHMEM_ALIGN - 1))
+		return SBI_EINVALID_ADDR;
+	if (!sbi_domain_check_addr_range(dom, addr,
+					 sizeof(struct sbi_fwtime_shmem), PRV_S,
+					 SBI_DOMAIN_READ | SBI_DOMAIN_WRITE))
+		return SBI_EINVALID_ADDR;
+
+	fh->shmem = (struct sbi_fwtime_shmem *)addr;
+	fwtime_publish(fh);
+
+	return 0;
+}
+
+int sbi_fwtime_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct fwtime_hart *fh;
+
+	if (cold_boot) {
+		fwtime_off = sbi_scratch_alloc_offset(sizeof(*fh), "FWTIME");
+		if (!fwtime_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!fwtime_off)
+			return SBI_ENOMEM;
+	}
+
+	/*
+	 * Counters keep accumulating across HART stop/start whereas
+	 * the shared memory must be registered again after start.
+	 */
+	fh = sbi_scratch_offset_ptr(scratch, fwtime_off);
+	fh->current = SBI_FWTIME_NONE;
+	fh->last = csr_read(CSR_MCYCLE);
+	fh->shmem = NULL;
+
+	return 0;
+}
@@ -11,6 +11,8 @@
 #include <sbi/riscv_barrier.h>
 #include <sbi/riscv_encoding.h>
 #include <sbi/riscv_fp.h>
+#include <sbi/riscv_locks.h>
+#include <sbi/sbi_bitmap.h>
 #include <sbi/sbi_bitops.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
@@ -29,6 +31,7 @@ void (*sbi_hart_expected_trap)(void) = &__sbi_expected_trap;
 
 struct hart_features {
 	unsigned long features;
+	DECLARE_BITMAP(extensions, SBI_HART_EXT_MAX);
 	unsigned int pmp_count;
 	unsigned int pmp_addr_bits;
 	unsigned long pmp_gran;
@@ -36,22 +39,45 @@ struct hart_features {
 };
 static unsigned long hart_features_offset;
 
+/*
+ * HARTs having the same mvendorid, marchid, mimpid and platform specific
+ * key (e.g. hash of device tree compatible and riscv,isa) are expected to
+ * have the same features so detection results are shared among them.
+ */
+#define HART_FEATURES_SHARE_MAX		4
+
+struct hart_features_share_id {
+	unsigned long mvendorid;
+	unsigned long marchid;
+	unsigned long mimpid;
+	unsigned long platkey;
+};
+
+struct hart_features_share {
+	bool valid;
+	struct hart_features_share_id id;
+	struct hart_features hfeatures;
+};
+static struct hart_features_share hfshare[HART_FEATURES_SHARE_MAX];
+static spinlock_t hfshare_lock = SPIN_LOCK_INITIALIZER;
+
 static void mstatus_init(struct sbi_scratch *scratch)
 {
 	unsigned long mstatus_val = 0;
 
 	/* Enable FPU */
-	if (misa_extension('D') || misa_extension('F'))
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('D')) ||
+	    sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('F')))
 		mstatus_val |=  MSTATUS_FS;
 
 	/* Enable Vector context */
-	if (misa_extension('V'))
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('V')))
 		mstatus_val |=  MSTATUS_VS;
 
 	csr_write(CSR_MSTATUS, mstatus_val);
 
 	/* Enable user/supervisor use of perf counters */
-	if (misa_extension('S') &&
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')) &&
 	    sbi_hart_has_feature(scratch, SBI_HART_HAS_SCOUNTEREN))
 		csr_write(CSR_SCOUNTEREN, -1);
 	if (sbi_hart_has_feature(scratch, SBI_HART_HAS_MCOUNTEREN))
@@ -61,7 +87,7 @@ static void mstatus_init(struct sbi_scratch *scratch)
 	csr_write(CSR_MIE, 0);
 
 	/* Disable S-mode paging */
-	if (misa_extension('S'))
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')))
 		csr_write(CSR_SATP, 0);
 }
 
@@ -71,7 +97,8 @@ static int fp_init(struct sbi_scratch *scratch)
 	int i;
 #endif
 
-	if (!misa_extension('D') && !misa_extension('F'))
+	if (!sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('D')) &&
+	    !sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('F')))
 		return 0;
 
 	if (!(csr_read(CSR_MSTATUS) & MSTATUS_FS))
@@ -91,7 +118,7 @@ static int delegate_traps(struct sbi_scratch *scratch)
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 	unsigned long interrupts, exceptions;
 
-	if (!misa_extension('S'))
+	if (!sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')))
 		/* No delegation possible as mideleg does not exist */
 		return 0;
 
@@ -111,7 +138,7 @@ static int delegate_traps(struct sbi_scratch *scratch)
 	 * The HS-mode will additionally handle supervisor calls (i.e. ecalls
 	 * from VS-mode), Guest page faults and Virtual interrupts.
 	 */
-	if (misa_extension('H')) {
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H'))) {
 		exceptions |= (1U << CAUSE_VIRTUAL_SUPERVISOR_ECALL);
 		exceptions |= (1U << CAUSE_FETCH_GUEST_PAGE_FAULT);
 		exceptions |= (1U << CAUSE_LOAD_GUEST_PAGE_FAULT);
@@ -128,7 +155,7 @@ static int delegate_traps(struct sbi_scratch *scratch)
 void sbi_hart_delegation_dump(struct sbi_scratch *scratch,
 			      const char *prefix, const char *suffix)
 {
-	if (!misa_extension('S'))
+	if (!sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')))
 		/* No delegation possible as mideleg does not exist*/
 		return;
 
@@ -219,6 +246,15 @@ int sbi_hart_pmp_configure(struct sbi_scratch *scratch)
 	return 0;
 }
 
+void sbi_hart_pmp_unconfigure(struct sbi_scratch *scratch)
+{
+	unsigned int i, pmp_count = sbi_hart_pmp_count(scratch);
+
+	/* Locked PMP entries stay as-is until the next reset */
+	for (i = 0; i < pmp_count; i++)
+		pmp_disable(i);
+}
+
 /**
  * Check whether a particular hart feature is available
  *
@@ -312,6 +348,119 @@ done:
 		sbi_strncpy(features_str, "none", nfstr);
 }
 
+static const char *const hart_ext_names[] = {
+	[SBI_HART_EXT_ZBB - SBI_HART_EXT_ZBB]		= "zbb",
+	[SBI_HART_EXT_SVINVAL - SBI_HART_EXT_ZBB]	= "svinval",
+	[SBI_HART_EXT_SSTC - SBI_HART_EXT_ZBB]		= "sstc",
+	[SBI_HART_EXT_ZICBOM - SBI_HART_EXT_ZBB]	= "zicbom",
+	[SBI_HART_EXT_ZAWRS - SBI_HART_EXT_ZBB]		= "zawrs",
+	[SBI_HART_EXT_SMAIA - SBI_HART_EXT_ZBB]		= "smaia",
+	[SBI_HART_EXT_SSCOFPMF - SBI_HART_EXT_ZBB]	= "sscofpmf",
+};
+
+/**
+ * Check whether a particular ISA extension is available on a HART
+ *
+ * The extensions are detected once per HART in sbi_hart_init() so
+ * this is cheap enough to be used in hot paths instead of reading
+ * the MISA CSR.
+ *
+ * @param scratch pointer to the HART scratch space
+ * @param ext the extension index to check
+ * @returns true (available) or false (not available)
+ */
+bool sbi_hart_has_extension(struct sbi_scratch *scratch,
+			    enum sbi_hart_extensions ext)
+{
+	struct hart_features *hfeatures;
+
+	/* Traps taken before HART init can only use MISA */
+	if (!hart_features_offset) {
+		if (ext < SBI_HART_EXT_ZBB)
+			return misa_extension_imp('A' + ext) ? true : false;
+		return false;
+	}
+
+	hfeatures = sbi_scratch_offset_ptr(scratch, hart_features_offset);
+	if (hfeatures->extensions[BIT_WORD(ext)] & BIT_MASK(ext))
+		return true;
+	else
+		return false;
+}
+
+/**
+ * Mark an ISA extension as available or not available on a HART
+ *
+ * @param scratch pointer to the HART scratch space
+ * @param ext the extension index to update
+ * @param enable true to mark the extension available
+ */
+void sbi_hart_update_extension(struct sbi_scratch *scratch,
+			       enum sbi_hart_extensions ext, bool enable)
+{
+	struct hart_features *hfeatures =
+			sbi_scratch_offset_ptr(scratch, hart_features_offset);
+
+	if (SBI_HART_EXT_MAX <= ext)
+		return;
+
+	if (enable)
+		hfeatures->extensions[BIT_WORD(ext)] |= BIT_MASK(ext);
+	else
+		hfeatures->extensions[BIT_WORD(ext)] &= ~BIT_MASK(ext);
+}
+
+/**
+ * Get the name of a multi-letter ISA extension
+ *
+ * @param ext the extension index
+ * @returns lower-case extension name or NULL for single letter extensions
+ */
+const char *sbi_hart_extension_name(enum sbi_hart_extensions ext)
+{
+	if (ext < SBI_HART_EXT_ZBB || SBI_HART_EXT_MAX <= ext)
+		return NULL;
+
+	return hart_ext_names[ext - SBI_HART_EXT_ZBB];
+}
+
+/**
+ * Get the multi-letter ISA extensions of a HART in string format
+ *
+ * @param scratch pointer to the HART scratch space
+ * @param extensions_str pointer to a char array where the extensions string
+ *			 will be updated
+ * @param nestr length of the extensions_str. The extensions string will be
+ *		truncated if nestr is not long enough.
+ */
+void sbi_hart_get_extensions_str(struct sbi_scratch *scratch,
+				 char *extensions_str, int nestr)
+{
+	int ext, len, offset = 0;
+	const char *temp;
+
+	if (!extensions_str || nestr <= 0)
+		return;
+	sbi_memset(extensions_str, 0, nestr);
+
+	for (ext = SBI_HART_EXT_ZBB; ext < SBI_HART_EXT_MAX; ext++) {
+		if (!sbi_hart_has_extension(scratch, ext))
+			continue;
+		temp = sbi_hart_extension_name(ext);
+		len = sbi_strlen(temp);
+		if (nestr <= (offset + len + 1))
+			break;
+		sbi_snprintf(extensions_str + offset, nestr - offset,
+			     "%s,", temp);
+		offset = offset + len + 1;
+	}
+
+	if (offset)
+		extensions_str[offset - 1] = '\0';
+	else
+		sbi_strncpy(extensions_str, "none", nestr);
+}
+
 static unsigned long hart_pmp_get_allowed_addr(void)
 {
 	unsigned long val = 0;
@@ -327,14 +476,216 @@ static unsigned long hart_pmp_get_allowed_addr(void)
 	return val;
 }
 
-static void hart_detect_features(struct sbi_scratch *scratch)
+static void hart_cbo_clean_allowed(ulong addr, struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3") = (ulong)trap;
+	register ulong ttmp asm("a4");
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+
+	trap->cause = 0;
+	asm volatile(
+		"add %[ttmp], %[tinfo], zero\n"
+		"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+		".insn i 0x0f, 2, x0, %[addr], 1\n"
+		"csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp)
+	    : [addr] "r"(addr)
+	    : "memory");
+}
+
+static void hart_zbb_allowed(struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3") = (ulong)trap;
+	register ulong ttmp asm("a4");
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+	ulong val = 0;
+
+	trap->cause = 0;
+	asm volatile(
+		"add %[ttmp], %[tinfo], zero\n"
+		"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+		/* clz val, val */
+		".insn i 0x13, 1, %[val], %[val], 0x600\n"
+		"csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mtvec] "+&r"(mtvec), [tinfo] "+&r"(tinfo),
+	      [ttmp] "+&r"(ttmp), [val] "+&r"(val)
+	    :
+	    : "memory");
+}
+
+static void hart_svinval_allowed(struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3") = (ulong)trap;
+	register ulong ttmp asm("a4");
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+
+	trap->cause = 0;
+	asm volatile(
+		"add %[ttmp], %[tinfo], zero\n"
+		"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+		/* sfence.w.inval */
+		".insn i 0x73, 0, x0, x0, 0x180\n"
+		"csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp)
+	    :
+	    : "memory");
+}
+
+static int hart_detect_extensions(struct sbi_scratch *scratch,
+				  struct hart_features *hfeatures)
+{
+	int rc;
+	char ext;
+	struct sbi_trap_info trap = {0};
+
+	bitmap_zero(hfeatures->extensions, SBI_HART_EXT_MAX);
+
+	/* Single letter extensions come from MISA (or the platform) */
+	for (ext = 'A'; ext <= 'Z'; ext++) {
+		if (misa_extension_imp(ext))
+			sbi_hart_update_extension(scratch,
+						  SBI_HART_EXT_MISA(ext), true);
+	}
+
+	/*
+	 * Let the platform populate multi-letter extensions first
+	 * (e.g. from the device tree) and then override whatever we
+	 * can safely find out by probing.
+	 */
+	rc = sbi_platform_extensions_init(sbi_platform_ptr(scratch));
+	if (rc)
+		return rc;
+
+	hart_zbb_allowed(&trap);
+	sbi_hart_update_extension(scratch, SBI_HART_EXT_ZBB, !trap.cause);
+
+	/* Svinval fences are harmless to execute in M-mode */
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S'))) {
+		hart_svinval_allowed(&trap);
+		sbi_hart_update_extension(scratch, SBI_HART_EXT_SVINVAL,
+					  !trap.cause);
+	} else {
+		sbi_hart_update_extension(scratch, SBI_HART_EXT_SVINVAL,
+					  false);
+	}
+
+	trap.cause = 0;
+	csr_read_allowed(CSR_STIMECMP, (ulong)&trap);
+	sbi_hart_update_extension(scratch, SBI_HART_EXT_SSTC, !trap.cause);
+
+	/* Detect if hart supports Zicbom by cleaning our own scratch */
+	hart_cbo_clean_allowed((ulong)scratch, &trap);
+	sbi_hart_update_extension(scratch, SBI_HART_EXT_ZICBOM, !trap.cause);
+
+	trap.cause = 0;
+	csr_read_allowed(CSR_MTOPI, (ulong)&trap);
+	sbi_hart_update_extension(scratch, SBI_HART_EXT_SMAIA, !trap.cause);
+
+	trap.cause = 0;
+	csr_read_allowed(CSR_SCOUNTOVF, (ulong)&trap);
+	sbi_hart_update_extension(scratch, SBI_HART_EXT_SSCOFPMF,
+				  !trap.cause);
+
+	return 0;
+}
+
+static bool hart_features_share_allowed(struct sbi_scratch *scratch)
+{
+#ifdef CONFIG_SBI_HART_FEATURES_SHARING
+	return sbi_platform_has_heterogeneous_harts(sbi_platform_ptr(scratch))
+		? false : true;
+#else
+	return false;
+#endif
+}
+
+static void hart_features_share_id(struct sbi_scratch *scratch,
+				   struct hart_features_share_id *id)
+{
+	id->mvendorid = csr_read(CSR_MVENDORID);
+	id->marchid = csr_read(CSR_MARCHID);
+	id->mimpid = csr_read(CSR_MIMPID);
+	id->platkey = sbi_platform_hart_features_key(sbi_platform_ptr(scratch));
+}
+
+static bool hart_features_share_match(const struct hart_features_share *hfs,
+				      const struct hart_features_share_id *id)
+{
+	return hfs->valid &&
+	       hfs->id.mvendorid == id->mvendorid &&
+	       hfs->id.marchid == id->marchid &&
+	       hfs->id.mimpid == id->mimpid &&
+	       hfs->id.platkey == id->platkey;
+}
+
+static bool hart_features_share_get(struct sbi_scratch *scratch,
+				    struct hart_features *hfeatures)
+{
+	int i;
+	bool found = false;
+	struct hart_features_share_id id;
+
+	if (!hart_features_share_allowed(scratch))
+		return false;
+
+	hart_features_share_id(scratch, &id);
+
+	spin_lock(&hfshare_lock);
+	for (i = 0; i < HART_FEATURES_SHARE_MAX; i++) {
+		if (hart_features_share_match(&hfshare[i], &id)) {
+			sbi_memcpy(hfeatures, &hfshare[i].hfeatures,
+				   sizeof(*hfeatures));
+			found = true;
+			break;
+		}
+	}
+	spin_unlock(&hfshare_lock);
+
+	return found;
+}
+
+static void hart_features_share_put(struct sbi_scratch *scratch,
+				    const struct hart_features *hfeatures)
+{
+	int i;
+	struct hart_features_share_id id;
+
+	if (!hart_features_share_allowed(scratch))
+		return;
+
+	hart_features_share_id(scratch, &id);
+
+	spin_lock(&hfshare_lock);
+	for (i = 0; i < HART_FEATURES_SHARE_MAX; i++) {
+		/* Another HART with same IDs might have been faster */
+		if (hart_features_share_match(&hfshare[i], &id))
+			break;
+		if (hfshare[i].valid)
+			continue;
+		sbi_memcpy(&hfshare[i].id, &id, sizeof(id));
+		sbi_memcpy(&hfshare[i].hfeatures, hfeatures,
+			   sizeof(*hfeatures));
+		hfshare[i].valid = true;
+		break;
+	}
+	spin_unlock(&hfshare_lock);
+}
+
+static int hart_detect_features(struct sbi_scratch *scratch)
 {
 	struct sbi_trap_info trap = {0};
 	struct hart_features *hfeatures;
 	unsigned long val;
+	int rc;
 
-	/* Reset hart features */
+	/* Reuse features detected on an identical HART */
 	hfeatures = sbi_scratch_offset_ptr(scratch, hart_features_offset);
+	if (hart_features_share_get(scratch, hfeatures))
+		return 0;
+
+	/* Reset hart features */
 	hfeatures->features = 0;
 	hfeatures->pmp_count = 0;
 	hfeatures->mhpm_count = 0;
@@ -428,6 +779,31 @@ __mhpm_skip:
 	csr_read_allowed(CSR_TIME, (unsigned long)&trap);
 	if (!trap.cause)
 		hfeatures->features |= SBI_HART_HAS_TIME;
+
+	rc = hart_detect_extensions(scratch, hfeatures);
+	if (rc)
+		return rc;
+
+	hart_features_share_put(scratch, hfeatures);
+
+	return 0;
+}
+
+int sbi_hart_reinit(struct sbi_scratch *scratch)
+{
+	int rc;
+
+	mstatus_init(scratch);
+
+	rc = fp_init(scratch);
+	if (rc)
+		return rc;
+
+	rc = delegate_traps(scratch);
+	if (rc)
+		return rc;
+
+	return 0;
 }
 
 int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot)
@@ -445,19 +821,11 @@ int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot)
 			return SBI_ENOMEM;
 	}
 
-	hart_detect_features(scratch);
-
-	mstatus_init(scratch);
-
-	rc = fp_init(scratch);
-	if (rc)
-		return rc;
-
-	rc = delegate_traps(scratch);
+	rc = hart_detect_features(scratch);
 	if (rc)
 		return rc;
 
-	return 0;
+	return sbi_hart_reinit(scratch);
 }
 
 void __attribute__((noreturn)) sbi_hart_hang(void)
@@ -477,16 +845,17 @@ sbi_hart_switch_mode(unsigned long arg0, unsigned long arg1,
 #else
 	unsigned long val;
 #endif
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
 	switch (next_mode) {
 	case PRV_M:
 		break;
 	case PRV_S:
-		if (!misa_extension('S'))
+		if (!sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')))
 			sbi_hart_hang();
 		break;
 	case PRV_U:
-		if (!misa_extension('U'))
+		if (!sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('U')))
 			sbi_hart_hang();
 		break;
 	default:
@@ -497,7 +866,7 @@ sbi_hart_switch_mode(unsigned long arg0, unsigned long arg1,
 	val = INSERT_FIELD(val, MSTATUS_MPP, next_mode);
 	val = INSERT_FIELD(val, MSTATUS_MPIE, 0);
 #if __riscv_xlen == 32
-	if (misa_extension('H')) {
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H'))) {
 		valH = csr_read(CSR_MSTATUSH);
 		if (next_virt)
 			valH = INSERT_FIELD(valH, MSTATUSH_MPV, 1);
@@ -506,7 +875,7 @@ sbi_hart_switch_mode(unsigned long arg0, unsigned long arg1,
 		csr_write(CSR_MSTATUSH, valH);
 	}
 #else
-	if (misa_extension('H')) {
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H'))) {
 		if (next_virt)
 			val = INSERT_FIELD(val, MSTATUS_MPV, 1);
 		else
@@ -522,15 +891,20 @@ sbi_hart_switch_mode(unsigned long arg0, unsigned long arg1,
 		csr_write(CSR_SIE, 0);
 		csr_write(CSR_SATP, 0);
 	} else if (next_mode == PRV_U) {
-		if (misa_extension('N')) {
+		if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('N'))) {
 			csr_write(CSR_UTVEC, next_addr);
 			csr_write(CSR_USCRATCH, 0);
 			csr_write(CSR_UIE, 0);
 		}
 	}
 
+	/*
+	 * TP points to sbi_scratch while in M-mode so clear it to avoid
+	 * leaking M-mode addresses to the next booting stage.
+	 */
 	register unsigned long a0 asm("a0") = arg0;
 	register unsigned long a1 asm("a1") = arg1;
-	__asm__ __volatile__("mret" : : "r"(a0), "r"(a1));
+	__asm__ __volatile__("mv tp, zero\n\t"
+			     "mret" : : "r"(a0), "r"(a1));
 	__builtin_unreachable();
 }
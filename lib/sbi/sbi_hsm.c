@@ -22,8 +22,10 @@
 #include <sbi/sbi_init.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_platform.h>
+#include <sbi/sbi_shpage.h>
 #include <sbi/sbi_system.h>
 #include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
 #include <sbi/sbi_console.h>
 
 static unsigned long hart_data_offset;
@@ -50,6 +52,9 @@ int sbi_hsm_hart_state_to_status(int state)
 	case SBI_HART_STARTED:
 		ret = SBI_HSM_HART_STATUS_STARTED;
 		break;
+	case SBI_HART_SUSPENDED:
+		ret = SBI_HSM_HART_STATUS_SUSPENDED;
+		break;
 	default:
 		ret = SBI_EINVAL;
 	}
@@ -127,6 +132,78 @@ void sbi_hsm_prepare_next_jump(struct sbi_scratch *scratch, u32 hartid)
 				  SBI_HART_STARTED);
 	if (oldstate != SBI_HART_STARTING)
 		sbi_hart_hang();
+
+	sbi_shpage_hart_state_update(hartid);
+	sbi_trace(SBI_TRACE_HSM_STATE, hartid, SBI_HART_STARTED, 0, 0);
+}
+
+/**
+ * Check whether all HARTs other than the given HART are stopped
+ * @param hartid the HART ID to skip
+ * @return TRUE if every other HART is in SBI_HART_STOPPED state
+ */
+bool sbi_hsm_hart_others_stopped(u32 hartid)
+{
+	u32 i;
+
+	for (i = 0; i <= sbi_scratch_last_hartid(); i++) {
+		if (i == hartid || !sbi_hartid_to_scratch(i))
+			continue;
+		if (__sbi_hsm_hart_get_state(i) != SBI_HART_STOPPED)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Move current HART from started to suspended state for system suspend
+ * @return 0 on success and SBI_EDENIED if HART is not started
+ */
+int sbi_hsm_hart_suspend(struct sbi_scratch *scratch, u32 hartid)
+{
+	u32 oldstate;
+	struct sbi_hsm_data *hdata = sbi_scratch_offset_ptr(scratch,
+							    hart_data_offset);
+
+	oldstate = atomic_cmpxchg(&hdata->state, SBI_HART_STARTED,
+				  SBI_HART_SUSPENDED);
+	if (oldstate != SBI_HART_STARTED)
+		return SBI_EDENIED;
+
+	sbi_shpage_hart_state_update(hartid);
+	sbi_trace(SBI_TRACE_HSM_STATE, hartid, SBI_HART_SUSPENDED, 0, 0);
+
+	return 0;
+}
+
+/** Move current HART from suspended back to started state */
+void sbi_hsm_hart_resume(struct sbi_scratch *scratch, u32 hartid)
+{
+	u32 oldstate;
+	struct sbi_hsm_data *hdata = sbi_scratch_offset_ptr(scratch,
+							    hart_data_offset);
+
+	oldstate = atomic_cmpxchg(&hdata->state, SBI_HART_SUSPENDED,
+				  SBI_HART_STARTED);
+	if (oldstate != SBI_HART_SUSPENDED)
+		sbi_hart_hang();
+
+	sbi_shpage_hart_state_update(hartid);
+	sbi_trace(SBI_TRACE_HSM_STATE, hartid, SBI_HART_STARTED, 0, 0);
+}
+
+/** Check whether a HART is resuming from system suspend */
+bool sbi_hsm_hart_suspended(struct sbi_scratch *scratch)
+{
+	struct sbi_hsm_data *hdata;
+
+	if (!hart_data_offset)
+		return FALSE;
+
+	hdata = sbi_scratch_offset_ptr(scratch, hart_data_offset);
+	return (atomic_read(&hdata->state) == SBI_HART_SUSPENDED) ?
+		TRUE : FALSE;
 }
 
 static void sbi_hsm_hart_wait(struct sbi_scratch *scratch, u32 hartid)
@@ -196,6 +273,9 @@ void __noreturn sbi_hsm_exit(struct sbi_scratch *scratch)
 	if (hstate != SBI_HART_STOPPING)
 		goto fail_exit;
 
+	sbi_shpage_hart_state_update(current_hartid());
+	sbi_trace(SBI_TRACE_HSM_STATE, current_hartid(), SBI_HART_STOPPED, 0, 0);
+
 	if (sbi_platform_has_hart_hotplug(plat)) {
 		sbi_platform_hart_stop(plat);
 		/* It should never reach here */
@@ -250,6 +330,9 @@ int sbi_hsm_hart_start(struct sbi_scratch *scratch,
 	if (hstate != SBI_HART_STOPPED)
 		return SBI_EINVAL;
 
+	sbi_shpage_hart_state_update(hartid);
+	sbi_trace(SBI_TRACE_HSM_STATE, hartid, SBI_HART_STARTING, 0, 0);
+
 	init_count = sbi_init_count(hartid);
 	rscratch->next_arg1 = priv;
 	rscratch->next_addr = saddr;
@@ -284,6 +367,9 @@ int sbi_hsm_hart_stop(struct sbi_scratch *scratch, bool exitnow)
 		return SBI_EDENIED;
 	}
 
+	sbi_shpage_hart_state_update(hartid);
+	sbi_trace(SBI_TRACE_HSM_STATE, hartid, SBI_HART_STOPPING, 0, 0);
+
 	if (exitnow)
 		sbi_exit(scratch);
 
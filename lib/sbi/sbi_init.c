@@ -11,18 +11,29 @@
 #include <sbi/riscv_atomic.h>
 #include <sbi/riscv_barrier.h>
 #include <sbi/riscv_locks.h>
+#include <sbi/sbi_cache.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
 #include <sbi/sbi_ecall.h>
+#include <sbi/sbi_fwtime.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_hartmask.h>
 #include <sbi/sbi_hsm.h>
+#include <sbi/sbi_mprof.h>
 #include <sbi/sbi_ipi.h>
+#include <sbi/sbi_perf_profile.h>
 #include <sbi/sbi_platform.h>
+#include <sbi/sbi_shpage.h>
+#include <sbi/sbi_sse.h>
+#include <sbi/sbi_stack.h>
 #include <sbi/sbi_system.h>
 #include <sbi/sbi_string.h>
 #include <sbi/sbi_timer.h>
 #include <sbi/sbi_tlb.h>
+#include <sbi/sbi_record.h>
+#include <sbi/sbi_trace.h>
+#include <sbi/sbi_unpriv.h>
 #include <sbi/sbi_version.h>
 
 #define BANNER                                              \
@@ -70,6 +81,9 @@ static void sbi_boot_print_general(struct sbi_scratch *scratch)
 	sbi_printf("Firmware Base             : 0x%lx\n", scratch->fw_start);
 	sbi_printf("Firmware Size             : %d KB\n",
 		   (u32)(scratch->fw_size / 1024));
+	if (scratch->fw_decomp_cycles)
+		sbi_printf("Firmware Decompress Time  : %lu cycles\n",
+			   scratch->fw_decomp_cycles);
 
 	/* SBI details */
 	sbi_printf("Runtime SBI Version       : %d.%d\n",
@@ -88,8 +102,9 @@ static void sbi_boot_print_domains(struct sbi_scratch *scratch)
 
 static void sbi_boot_print_hart(struct sbi_scratch *scratch, u32 hartid)
 {
-	int xlen;
+	int xlen, prof;
 	char str[128];
+	unsigned long stack_used;
 	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
 
 	if (scratch->options & SBI_SCRATCH_NO_BOOT_PRINTS)
@@ -109,6 +124,8 @@ static void sbi_boot_print_hart(struct sbi_scratch *scratch, u32 hartid)
 	sbi_printf("Boot HART ISA             : %s\n", str);
 	sbi_hart_get_features_str(scratch, str, sizeof(str));
 	sbi_printf("Boot HART Features        : %s\n", str);
+	sbi_hart_get_extensions_str(scratch, str, sizeof(str));
+	sbi_printf("Boot HART ISA Extensions  : %s\n", str);
 	sbi_printf("Boot HART PMP Count       : %d\n",
 		   sbi_hart_pmp_count(scratch));
 	sbi_printf("Boot HART PMP Granularity : %lu\n",
@@ -119,6 +136,16 @@ static void sbi_boot_print_hart(struct sbi_scratch *scratch, u32 hartid)
 		   sbi_hart_mhpm_count(scratch));
 	sbi_printf("Boot HART MHPM Count      : %d\n",
 		   sbi_hart_mhpm_count(scratch));
+	if (sbi_stack_size(scratch))
+		sbi_printf("Boot HART Stack Size      : %lu bytes\n",
+			   sbi_stack_size(scratch));
+	if (!sbi_stack_usage(scratch, &stack_used))
+		sbi_printf("Boot HART Stack Used      : %lu bytes\n",
+			   stack_used);
+	prof = sbi_perf_profile_current(scratch);
+	if (prof >= 0)
+		sbi_printf("Boot HART Perf Profile    : %s\n",
+			   sbi_perf_profile_get(prof)->name);
 	sbi_hart_delegation_dump(scratch, "Boot HART ", "         ");
 }
 
@@ -215,14 +242,31 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 	if (!init_count_offset)
 		sbi_hart_hang();
 
+	rc = sbi_stack_init(scratch, TRUE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hsm_init(scratch, hartid, TRUE);
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_fwtime_init(scratch, TRUE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_unpriv_init(scratch, TRUE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_platform_early_init(plat, TRUE);
 	if (rc)
 		sbi_hart_hang();
 
+	/* Right after platform early init which may setup caches */
+	rc = sbi_perf_profile_init(scratch, TRUE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hart_init(scratch, TRUE);
 	if (rc)
 		sbi_hart_hang();
@@ -258,6 +302,36 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 		sbi_hart_hang();
 	}
 
+	rc = sbi_trace_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: trace init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_record_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: record init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_mprof_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: mprof init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_sse_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: sse init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_cache_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: cache init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
 	rc = sbi_ecall_init();
 	if (rc) {
 		sbi_printf("%s: ecall init failed (error %d)\n", __func__, rc);
@@ -279,6 +353,24 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 		sbi_hart_hang();
 	}
 
+	/*
+	 * Note: Domain scheduler is initialized after domains are
+	 * finalized because it needs owner domains of HARTs.
+	 */
+	rc = sbi_domain_sched_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: domain sched init failed (error %d)\n",
+			   __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_shpage_init();
+	if (rc) {
+		sbi_printf("%s: shared page init failed (error %d)\n",
+			   __func__, rc);
+		sbi_hart_hang();
+	}
+
 	sbi_boot_print_domains(scratch);
 
 	rc = sbi_hart_pmp_configure(scratch);
@@ -311,6 +403,52 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 			     scratch->next_mode, FALSE);
 }
 
+/*
+ * Resume from system suspend. Firmware data is still in memory so only
+ * per-HART hardware state is setup again without probing anything.
+ */
+static void __noreturn init_warm_resume(struct sbi_scratch *scratch,
+					u32 hartid)
+{
+	int rc;
+	u64 resume_start = sbi_timer_value();
+	u32 fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_OTHER);
+	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
+
+	rc = sbi_hart_reinit(scratch);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_platform_irqchip_init(plat, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_platform_ipi_init(plat, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_platform_timer_init(plat, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	/* Counters used for sampling are setup again on first trap */
+	rc = sbi_mprof_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_hart_pmp_configure(scratch);
+	if (rc)
+		sbi_hart_hang();
+
+	sbi_system_resume(resume_start);
+
+	sbi_hsm_hart_resume(scratch, hartid);
+	sbi_fwtime_exit(fwtime_prev);
+	sbi_hart_switch_mode(hartid, scratch->next_arg1,
+			     scratch->next_addr,
+			     scratch->next_mode, FALSE);
+}
+
 static void __noreturn init_warmboot(struct sbi_scratch *scratch, u32 hartid)
 {
 	int rc;
@@ -322,14 +460,34 @@ static void __noreturn init_warmboot(struct sbi_scratch *scratch, u32 hartid)
 	if (!init_count_offset)
 		sbi_hart_hang();
 
+	if (sbi_hsm_hart_suspended(scratch))
+		init_warm_resume(scratch, hartid);
+
+	rc = sbi_stack_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hsm_init(scratch, hartid, FALSE);
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_fwtime_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_unpriv_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_platform_early_init(plat, FALSE);
 	if (rc)
 		sbi_hart_hang();
 
+	/* Right after platform early init which may setup caches */
+	rc = sbi_perf_profile_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hart_init(scratch, FALSE);
 	if (rc)
 		sbi_hart_hang();
@@ -350,6 +508,26 @@ static void __noreturn init_warmboot(struct sbi_scratch *scratch, u32 hartid)
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_trace_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_record_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_mprof_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_sse_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_domain_sched_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hart_pmp_configure(scratch);
 	if (rc)
 		sbi_hart_hang();
@@ -463,6 +641,8 @@ void __noreturn sbi_exit(struct sbi_scratch *scratch)
 
 	sbi_platform_early_exit(plat);
 
+	sbi_mprof_exit(scratch);
+
 	sbi_timer_exit(scratch);
 
 	sbi_ipi_exit(scratch);
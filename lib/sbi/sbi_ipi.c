@@ -13,12 +13,17 @@
 #include <sbi/riscv_barrier.h>
 #include <sbi/sbi_bitops.h>
 #include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
 #include <sbi/sbi_error.h>
+#include <sbi/sbi_fifo.h>
+#include <sbi/sbi_fwtime.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_hsm.h>
 #include <sbi/sbi_init.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_platform.h>
+#include <sbi/sbi_trace.h>
+#include <sbi/sbi_trap.h>
 
 struct sbi_ipi_data {
 	unsigned long ipi_type;
@@ -57,10 +62,10 @@ static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
 
 	/*
 	 * Set IPI type on remote hart's scratch area and
-	 * trigger the interrupt
+	 * trigger the interrupt (sbi_platform_ipi_send() orders both)
 	 */
+	sbi_trace(SBI_TRACE_IPI_SEND, remote_hartid, event, 0, 0);
 	atomic_raw_set_bit(event, &ipi_data->ipi_type);
-	smp_wmb();
 	sbi_platform_ipi_send(plat, remote_hartid);
 
 	if (ipi_ops->sync)
@@ -69,16 +74,11 @@ static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
 	return 0;
 }
 
-/**
- * As this this function only handlers scalar values of hart mask, it must be
- * set to all online harts if the intention is to send IPIs to all the harts.
- * If hmask is zero, no IPIs will be sent.
- */
-int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
+static int sbi_ipi_send_domain(const struct sbi_domain *dom,
+			       ulong hmask, ulong hbase, u32 event, void *data)
 {
 	int rc;
 	ulong i, m;
-	struct sbi_domain *dom = sbi_domain_thishart_ptr();
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
 	if (hbase != -1UL) {
@@ -107,6 +107,17 @@ int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
 	return 0;
 }
 
+/**
+ * As this this function only handlers scalar values of hart mask, it must be
+ * set to all online harts if the intention is to send IPIs to all the harts.
+ * If hmask is zero, no IPIs will be sent.
+ */
+int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
+{
+	return sbi_ipi_send_domain(sbi_domain_thishart_ptr(),
+				   hmask, hbase, event, data);
+}
+
 int sbi_ipi_event_create(const struct sbi_ipi_event_ops *ops)
 {
 	int i, ret = SBI_ENOSPC;
@@ -133,13 +144,138 @@ void sbi_ipi_event_destroy(u32 event)
 	ipi_ops_array[event] = NULL;
 }
 
+struct sbi_ipi_call_info {
+	sbi_ipi_call_fn fn;
+	void *arg;
+	/* Completion counter of a waiting caller (NULL for async calls) */
+	atomic_t *pending;
+};
+
+struct sbi_ipi_call_req {
+	struct sbi_ipi_call_info info;
+	/* Current HART is one of the target HARTs */
+	bool local;
+};
+
+static unsigned long ipi_call_fifo_off;
+static unsigned long ipi_call_fifo_mem_off;
+
+static void sbi_ipi_process_call(struct sbi_scratch *scratch)
+{
+	struct sbi_ipi_call_info info;
+	struct sbi_fifo *call_fifo =
+			sbi_scratch_offset_ptr(scratch, ipi_call_fifo_off);
+
+	while (!sbi_fifo_dequeue(call_fifo, &info)) {
+		info.fn(info.arg);
+		/* Completion is ordered after the effects of the function */
+		if (info.pending)
+			atomic_sub_return(info.pending, 1);
+	}
+}
+
+static int sbi_ipi_update_call(struct sbi_scratch *scratch,
+			       struct sbi_scratch *remote_scratch,
+			       u32 remote_hartid, void *data)
+{
+	u32 fwtime_prev;
+	struct sbi_trap_nested nst;
+	struct sbi_ipi_call_req *req = data;
+	struct sbi_fifo *call_fifo_r =
+			sbi_scratch_offset_ptr(remote_scratch, ipi_call_fifo_off);
+
+	/* Current HART calls the function after signalling remote HARTs */
+	if (remote_hartid == current_hartid()) {
+		req->local = TRUE;
+		return -1;
+	}
+
+	if (req->info.pending)
+		atomic_add_return(req->info.pending, 1);
+
+	while (sbi_fifo_enqueue(call_fifo_r, &req->info) < 0) {
+		/* Take own calls while waiting to avoid a deadlock */
+		fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_SYNC_WAIT);
+		sbi_trap_nested_begin(&nst);
+		if (!nst.enabled)
+			sbi_ipi_process_call(scratch);
+		sbi_trap_nested_end(&nst);
+		sbi_fwtime_exit(fwtime_prev);
+	}
+
+	return 0;
+}
+
+static struct sbi_ipi_event_ops ipi_call_ops = {
+	.name = "IPI_CALL",
+	.update = sbi_ipi_update_call,
+	.process = sbi_ipi_process_call,
+};
+
+static u32 ipi_call_event = SBI_IPI_EVENT_MAX;
+
+int sbi_ipi_call(ulong hmask, ulong hbase, sbi_ipi_call_fn fn, void *arg,
+		 bool wait)
+{
+	int rc;
+	u32 fwtime_prev;
+	struct sbi_trap_nested nst;
+	atomic_t pending = ATOMIC_INITIALIZER(0);
+	struct sbi_ipi_call_req req;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	if (!fn)
+		return SBI_EINVAL;
+
+	req.info.fn = fn;
+	req.info.arg = arg;
+	req.info.pending = (wait) ? &pending : NULL;
+	req.local = FALSE;
+
+	rc = sbi_ipi_send_many(hmask, hbase, ipi_call_event, &req);
+	if (rc)
+		return rc;
+
+	if (wait && atomic_read(&pending)) {
+		fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_SYNC_WAIT);
+		sbi_trap_nested_begin(&nst);
+		while (atomic_read(&pending)) {
+			/* Nested IPI handling takes own calls otherwise */
+			if (!nst.enabled)
+				sbi_ipi_process_call(scratch);
+		}
+		sbi_trap_nested_end(&nst);
+		sbi_fwtime_exit(fwtime_prev);
+	}
+
+	if (req.local)
+		fn(arg);
+
+	return 0;
+}
+
+static int sbi_ipi_update_smode(struct sbi_scratch *scratch,
+				struct sbi_scratch *remote_scratch,
+				u32 remote_hartid, void *data)
+{
+	const struct sbi_domain *dom = data;
+
+	/* Remote HART might be time-shared by the target domain */
+	sbi_domain_sched_ipi_update(remote_scratch,
+				    (dom) ? dom : sbi_domain_thishart_ptr());
+
+	return 0;
+}
+
 static void sbi_ipi_process_smode(struct sbi_scratch *scratch)
 {
-	csr_set(CSR_MIP, MIP_SSIP);
+	if (sbi_domain_sched_ipi_process(scratch))
+		csr_set(CSR_MIP, MIP_SSIP);
 }
 
 static struct sbi_ipi_event_ops ipi_smode_ops = {
 	.name = "IPI_SMODE",
+	.update = sbi_ipi_update_smode,
 	.process = sbi_ipi_process_smode,
 };
 
@@ -150,26 +286,27 @@ int sbi_ipi_send_smode(ulong hmask, ulong hbase)
 	return sbi_ipi_send_many(hmask, hbase, ipi_smode_event, NULL);
 }
 
+int sbi_ipi_send_smode_domain(const struct sbi_domain *dom,
+			      ulong hmask, ulong hbase)
+{
+	return sbi_ipi_send_domain(dom, hmask, hbase, ipi_smode_event,
+				   (void *)dom);
+}
+
 void sbi_ipi_clear_smode(void)
 {
 	csr_clear(CSR_MIP, MIP_SSIP);
 }
 
-static void sbi_ipi_process_halt(struct sbi_scratch *scratch)
+static void sbi_ipi_call_halt(void *arg)
 {
-	sbi_hsm_hart_stop(scratch, TRUE);
+	sbi_hsm_hart_stop(sbi_scratch_thishart_ptr(), TRUE);
 }
 
-static struct sbi_ipi_event_ops ipi_halt_ops = {
-	.name = "IPI_HALT",
-	.process = sbi_ipi_process_halt,
-};
-
-static u32 ipi_halt_event = SBI_IPI_EVENT_MAX;
-
 int sbi_ipi_send_halt(ulong hmask, ulong hbase)
 {
-	return sbi_ipi_send_many(hmask, hbase, ipi_halt_event, NULL);
+	/* Halted HARTs don't return so there is nothing to wait for */
+	return sbi_ipi_call(hmask, hbase, sbi_ipi_call_halt, NULL, FALSE);
 }
 
 void sbi_ipi_process(void)
@@ -183,9 +320,12 @@ void sbi_ipi_process(void)
 			sbi_scratch_offset_ptr(scratch, ipi_data_off);
 
 	u32 hartid = current_hartid();
+	u32 fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_IPI);
+
 	sbi_platform_ipi_clear(plat, hartid);
 
 	ipi_type = atomic_raw_xchg_ulong(&ipi_data->ipi_type, 0);
+	sbi_trace(SBI_TRACE_IPI_RECV, 0, 0, ipi_type, 0);
 	ipi_event = 0;
 	while (ipi_type) {
 		if (!(ipi_type & 1UL))
@@ -199,37 +339,76 @@ skip:
 		ipi_type = ipi_type >> 1;
 		ipi_event++;
 	};
+
+	sbi_fwtime_exit(fwtime_prev);
+}
+
+void sbi_ipi_process_pending(void)
+{
+	struct sbi_ipi_data *ipi_data;
+
+	if (!ipi_data_off)
+		return;
+
+	/*
+	 * Events queued for this HART while it is already in M-mode
+	 * (ecall, timer, emulation) are handled right away. This lets
+	 * remote HARTs waiting in sync() proceed sooner and also avoids
+	 * taking a separate trap for the IPI.
+	 */
+	ipi_data = sbi_scratch_offset_ptr(sbi_scratch_thishart_ptr(),
+					  ipi_data_off);
+	if (*(volatile unsigned long *)&ipi_data->ipi_type)
+		sbi_ipi_process();
 }
 
 int sbi_ipi_init(struct sbi_scratch *scratch, bool cold_boot)
 {
 	int ret;
 	struct sbi_ipi_data *ipi_data;
+	struct sbi_fifo *call_fifo;
 
 	if (cold_boot) {
 		ipi_data_off = sbi_scratch_alloc_offset(sizeof(*ipi_data),
 							"IPI_DATA");
 		if (!ipi_data_off)
 			return SBI_ENOMEM;
+		ipi_call_fifo_off = sbi_scratch_alloc_offset(sizeof(*call_fifo),
+							     "IPI_CALL_FIFO");
+		if (!ipi_call_fifo_off)
+			return SBI_ENOMEM;
+		ipi_call_fifo_mem_off = sbi_scratch_alloc_offset(
+				SBI_IPI_CALL_FIFO_NUM_ENTRIES *
+				sizeof(struct sbi_ipi_call_info),
+				"IPI_CALL_FIFO_MEM");
+		if (!ipi_call_fifo_mem_off)
+			return SBI_ENOMEM;
 		ret = sbi_ipi_event_create(&ipi_smode_ops);
 		if (ret < 0)
 			return ret;
 		ipi_smode_event = ret;
-		ret = sbi_ipi_event_create(&ipi_halt_ops);
+		ret = sbi_ipi_event_create(&ipi_call_ops);
 		if (ret < 0)
 			return ret;
-		ipi_halt_event = ret;
+		ipi_call_event = ret;
 	} else {
-		if (!ipi_data_off)
+		if (!ipi_data_off || !ipi_call_fifo_off ||
+		    !ipi_call_fifo_mem_off)
 			return SBI_ENOMEM;
 		if (SBI_IPI_EVENT_MAX <= ipi_smode_event ||
-		    SBI_IPI_EVENT_MAX <= ipi_halt_event)
+		    SBI_IPI_EVENT_MAX <= ipi_call_event)
 			return SBI_ENOSPC;
 	}
 
 	ipi_data = sbi_scratch_offset_ptr(scratch, ipi_data_off);
 	ipi_data->ipi_type = 0x00;
 
+	call_fifo = sbi_scratch_offset_ptr(scratch, ipi_call_fifo_off);
+	sbi_fifo_init(call_fifo,
+		      sbi_scratch_offset_ptr(scratch, ipi_call_fifo_mem_off),
+		      SBI_IPI_CALL_FIFO_NUM_ENTRIES,
+		      sizeof(struct sbi_ipi_call_info));
+
 	/* Platform init */
 	ret = sbi_platform_ipi_init(sbi_platform_ptr(scratch), cold_boot);
 	if (ret)
@@ -249,6 +428,12 @@ void sbi_ipi_exit(struct sbi_scratch *scratch)
 	/* Process pending IPIs */
 	sbi_ipi_process();
 
+	/*
+	 * Complete calls queued behind a call which stopped this HART
+	 * (such as halt) so that waiting callers don't spin forever.
+	 */
+	sbi_ipi_process_call(scratch);
+
 	/* Platform exit */
 	sbi_platform_ipi_exit(sbi_platform_ptr(scratch));
 }
@@ -21,6 +21,33 @@ union reg_data {
 	u64 data_u64;
 };
 
+static bool misaligned_emulate = TRUE;
+
+bool sbi_misaligned_get_emulate(void)
+{
+	return misaligned_emulate;
+}
+
+void sbi_misaligned_set_emulate(bool emulate)
+{
+	misaligned_emulate = emulate;
+}
+
+/* Hand the misaligned access back to S-mode when emulation is off */
+static int misaligned_redirect(ulong cause, ulong addr, ulong tval2,
+			       ulong tinst, struct sbi_trap_regs *regs)
+{
+	struct sbi_trap_info trap;
+
+	trap.epc = regs->mepc;
+	trap.cause = cause;
+	trap.tval = addr;
+	trap.tval2 = tval2;
+	trap.tinst = tinst;
+
+	return sbi_trap_redirect(regs, &trap);
+}
+
 int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 				struct sbi_trap_regs *regs)
 {
@@ -29,6 +56,10 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 	struct sbi_trap_info uptrap;
 	int i, fp = 0, shift = 0, len = 0;
 
+	if (!misaligned_emulate)
+		return misaligned_redirect(CAUSE_MISALIGNED_LOAD, addr,
+					   tval2, tinst, regs);
+
 	if (tinst & 0x1) {
 		/*
 		 * Bit[0] == 1 implies trapped instruction value is
@@ -149,6 +180,10 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 	struct sbi_trap_info uptrap;
 	int i, len = 0;
 
+	if (!misaligned_emulate)
+		return misaligned_redirect(CAUSE_MISALIGNED_STORE, addr,
+					   tval2, tinst, regs);
+
 	if (tinst & 0x1) {
 		/*
 		 * Bit[0] == 1 implies trapped instruction value is
@@ -0,0 +1,439 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/riscv_locks.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_mprof.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_trap.h>
+
+struct mprof_hart {
+	/* Sampling interrupts are allowed */
+	bool window;
+	/* Sampling source used by this HART */
+	u32 mode;
+	/* Value of mprof_gen when the sampling source was setup */
+	unsigned long gen;
+	/* MIE CSR saved by sbi_mprof_window_begin() */
+	unsigned long mie;
+};
+
+static unsigned long mprof_off;
+static spinlock_t mprof_lock = SPIN_LOCK_INITIALIZER;
+
+/* Incremented whenever sampling is started or stopped */
+static unsigned long mprof_gen;
+static u32 mprof_mode = SBI_MPROF_MODE_NONE;
+static unsigned long mprof_period;
+static unsigned long mprof_event;
+
+/* Layout of shared memory (S-mode might overwrite the header) */
+static struct sbi_mprof_header *mprof_hdr;
+static u32 mprof_hist_count;
+static unsigned long mprof_hist_size;
+static u32 mprof_bucket_shift;
+static unsigned long mprof_fw_start;
+static unsigned long mprof_fw_size;
+
+static void mprof_counter_reload(void)
+{
+	u64 val = -(u64)mprof_period;
+
+#if __riscv_xlen == 32
+	csr_write(CSR_MHPMCOUNTER3, 0);
+	csr_write(CSR_MHPMCOUNTER3H, val >> 32);
+	csr_write(CSR_MHPMCOUNTER3, val & 0xffffffff);
+#else
+	csr_write(CSR_MHPMCOUNTER3, val);
+#endif
+}
+
+static void mprof_counter_start(void)
+{
+	csr_set(CSR_MCOUNTINHIBIT, 1UL << SBI_MPROF_COUNTER);
+
+	/* Only count events while executing in M-mode */
+#if __riscv_xlen == 32
+	csr_write(CSR_MHPMEVENT3, mprof_event);
+	csr_write(CSR_MHPMEVENT3H, MHPMEVENTH_SINH | MHPMEVENTH_UINH |
+				   MHPMEVENTH_VSINH | MHPMEVENTH_VUINH);
+#else
+	csr_write(CSR_MHPMEVENT3, mprof_event | MHPMEVENT_SINH |
+				  MHPMEVENT_UINH | MHPMEVENT_VSINH |
+				  MHPMEVENT_VUINH);
+#endif
+	mprof_counter_reload();
+	csr_clear(CSR_MIP, MIP_LCOFIP);
+
+	csr_clear(CSR_MCOUNTINHIBIT, 1UL << SBI_MPROF_COUNTER);
+}
+
+static void mprof_counter_stop(void)
+{
+	csr_set(CSR_MCOUNTINHIBIT, 1UL << SBI_MPROF_COUNTER);
+	csr_write(CSR_MHPMEVENT3, 0);
+#if __riscv_xlen == 32
+	csr_write(CSR_MHPMEVENT3H, 0);
+#endif
+	csr_clear(CSR_MIP, MIP_LCOFIP);
+}
+
+static void mprof_hart_setup(struct mprof_hart *mh)
+{
+	u32 mode;
+	unsigned long gen;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	gen = mprof_gen;
+	smp_rmb();
+	mode = mprof_mode;
+
+	if (mh->mode == SBI_MPROF_MODE_COUNTER)
+		mprof_counter_stop();
+
+	/* Fallback to M-mode timer on HARTs without Sscofpmf */
+	if (mode == SBI_MPROF_MODE_COUNTER &&
+	    (!sbi_hart_has_extension(scratch, SBI_HART_EXT_SSCOFPMF) ||
+	     !sbi_hart_mhpm_count(scratch)))
+		mode = SBI_MPROF_MODE_TIMER;
+
+	if (mode == SBI_MPROF_MODE_COUNTER)
+		mprof_counter_start();
+
+	mh->mode = mode;
+	mh->gen = gen;
+}
+
+static void mprof_sample(struct sbi_trap_regs *regs)
+{
+	unsigned long pc = regs->mepc - mprof_fw_start;
+	u32 hartindex = current_hartindex();
+	struct sbi_mprof_hist *hist;
+
+	/* Only samples of M-mode code are interesting */
+	if (((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) != PRV_M)
+		return;
+	if (!mprof_hdr || mprof_hist_count <= hartindex)
+		return;
+
+	hist = (void *)mprof_hdr + SBI_MPROF_HIST_OFFSET +
+	       hartindex * mprof_hist_size;
+	hist->samples++;
+	if (pc < mprof_fw_size)
+		hist->buckets[pc >> mprof_bucket_shift]++;
+	else
+		hist->dropped++;
+}
+
+void sbi_mprof_window_begin(struct sbi_trap_regs *regs)
+{
+	struct mprof_hart *mh;
+	unsigned long irq;
+
+	if (!mprof_off)
+		return;
+	mh = sbi_scratch_thishart_offset_ptr(mprof_off);
+
+	if (mh->gen != mprof_gen)
+		mprof_hart_setup(mh);
+	if (mh->mode == SBI_MPROF_MODE_NONE)
+		return;
+
+	/* Nested traps don't open another window */
+	if (((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) == PRV_M)
+		return;
+
+	/* Only the sampling interrupt is taken inside the window */
+	irq = (mh->mode == SBI_MPROF_MODE_COUNTER) ? MIP_LCOFIP : MIP_MTIP;
+	mh->mie = csr_swap(CSR_MIE, irq);
+	if (mh->mode == SBI_MPROF_MODE_TIMER)
+		sbi_platform_timer_event_start(sbi_platform_thishart_ptr(),
+					       sbi_timer_value() + mprof_period);
+
+	mh->window = TRUE;
+	csr_set(CSR_MSTATUS, MSTATUS_MIE);
+}
+
+void sbi_mprof_window_end(void)
+{
+	struct mprof_hart *mh;
+
+	if (!mprof_off)
+		return;
+	mh = sbi_scratch_thishart_offset_ptr(mprof_off);
+	if (!mh->window)
+		return;
+
+	csr_clear(CSR_MSTATUS, MSTATUS_MIE);
+	mh->window = FALSE;
+
+	/* MTIE tracks pending timer event which might have changed */
+	csr_write(CSR_MIE, mh->mie);
+	if (mh->mode == SBI_MPROF_MODE_TIMER)
+		sbi_timer_event_restore();
+	else if (sbi_timer_event_pending(NULL) ||
+		 sbi_timer_deadline_pending(NULL))
+		csr_set(CSR_MIE, MIP_MTIP);
+	else
+		csr_clear(CSR_MIE, MIP_MTIP);
+}
+
+bool sbi_mprof_timer_process(struct sbi_trap_regs *regs)
+{
+	u64 now, next_event, deadline;
+	struct mprof_hart *mh;
+
+	if (!mprof_off)
+		return FALSE;
+	mh = sbi_scratch_thishart_offset_ptr(mprof_off);
+	if (!mh->window || mh->mode != SBI_MPROF_MODE_TIMER)
+		return FALSE;
+
+	mprof_sample(regs);
+
+	/* The M-mode timer is shared with timer event of S-mode */
+	now = sbi_timer_value();
+	if ((sbi_timer_event_pending(&next_event) && next_event <= now) ||
+	    (sbi_timer_deadline_pending(&deadline) && deadline <= now))
+		sbi_timer_process();
+
+	sbi_platform_timer_event_start(sbi_platform_thishart_ptr(),
+				       now + mprof_period);
+	csr_set(CSR_MIE, MIP_MTIP);
+
+	return TRUE;
+}
+
+bool sbi_mprof_overflow_process(struct sbi_trap_regs *regs)
+{
+	struct mprof_hart *mh;
+
+	if (!mprof_off)
+		return FALSE;
+	mh = sbi_scratch_thishart_offset_ptr(mprof_off);
+	if (mh->mode != SBI_MPROF_MODE_COUNTER)
+		return FALSE;
+
+	if (mh->window)
+		mprof_sample(regs);
+
+#if __riscv_xlen == 32
+	csr_clear(CSR_MHPMEVENT3H, MHPMEVENTH_OF);
+#else
+	csr_clear(CSR_MHPMEVENT3, MHPMEVENT_OF);
+#endif
+	csr_clear(CSR_MIP, MIP_LCOFIP);
+	mprof_counter_reload();
+
+	return TRUE;
+}
+
+static bool mprof_harts_shared(void)
+{
+	u32 i;
+
+	for (i = 0; i <= sbi_scratch_last_hartid(); i++) {
+		if (sbi_domain_sched_is_shared(i))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+int sbi_mprof_set_shmem(unsigned long addr, unsigned long size)
+{
+	int ret = 0;
+	u32 i, count, buckets, shift;
+	unsigned long hist_size;
+	struct sbi_mprof_hist *hist;
+	struct sbi_mprof_header *hdr = (void *)addr;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	spin_lock(&mprof_lock);
+
+	if (mprof_mode != SBI_MPROF_MODE_NONE) {
+		ret = SBI_EALREADY;
+		goto done;
+	}
+
+	if (addr == SBI_MPROF_SHMEM_DISABLE) {
+		mprof_hdr = NULL;
+		goto done;
+	}
+
+	/* Samples of time-shared HARTs would mix up domains */
+	if (mprof_harts_shared()) {
+		ret = SBI_EDENIED;
+		goto done;
+	}
+
+	if ((addr & (SBI_MPROF_HIST_OFFSET - 1)) ||
+	    size <= SBI_MPROF_HIST_OFFSET || (addr + size) < addr ||
+	    !sbi_domain_check_addr_range(dom, addr, size, PRV_S,
+					 SBI_DOMAIN_READ | SBI_DOMAIN_WRITE)) {
+		ret = SBI_EINVALID_ADDR;
+		goto done;
+	}
+
+	/* Histograms must not overlap with firmware */
+	if ((addr < (scratch->fw_start + scratch->fw_size)) &&
+	    (scratch->fw_start < (addr + size))) {
+		ret = SBI_EINVALID_ADDR;
+		goto done;
+	}
+
+	/* Use largest power of 2 buckets fitting in each histogram */
+	count = sbi_platform_hart_count(plat);
+	hist_size = (size - SBI_MPROF_HIST_OFFSET) / count;
+	if (hist_size < sizeof(struct sbi_mprof_hist) + 2 * sizeof(u32)) {
+		ret = SBI_EINVAL;
+		goto done;
+	}
+	buckets = (hist_size - sizeof(struct sbi_mprof_hist)) / sizeof(u32);
+	while (buckets & (buckets - 1))
+		buckets &= buckets - 1;
+	hist_size = sizeof(struct sbi_mprof_hist) + buckets * sizeof(u32);
+
+	/* Smallest bucket size (at least 2 bytes) covering the firmware */
+	shift = 1;
+	while (((scratch->fw_size - 1) >> shift) >= buckets)
+		shift++;
+
+	mprof_hdr = NULL;
+	smp_wmb();
+
+	mprof_hist_count = count;
+	mprof_hist_size = hist_size;
+	mprof_bucket_shift = shift;
+	mprof_fw_start = scratch->fw_start;
+	mprof_fw_size = scratch->fw_size;
+
+	sbi_memset(hdr, 0, SBI_MPROF_HIST_OFFSET + count * hist_size);
+	hdr->version = SBI_MPROF_VERSION;
+	hdr->hist_count = count;
+	hdr->hist_offset = SBI_MPROF_HIST_OFFSET;
+	hdr->hist_size = hist_size;
+	hdr->bucket_count = buckets;
+	hdr->bucket_shift = shift;
+	hdr->mode = SBI_MPROF_MODE_NONE;
+	hdr->fw_start = mprof_fw_start;
+	hdr->fw_size = mprof_fw_size;
+	for (i = 0; i < count; i++) {
+		hist = (void *)hdr + SBI_MPROF_HIST_OFFSET + i * hist_size;
+		hist->hartid = (plat->hart_index2id) ?
+				plat->hart_index2id[i] : i;
+	}
+
+	smp_wmb();
+	hdr->magic = SBI_MPROF_MAGIC;
+	mprof_hdr = hdr;
+
+done:
+	spin_unlock(&mprof_lock);
+	return ret;
+}
+
+int sbi_mprof_start(unsigned long period, unsigned long event)
+{
+	int ret;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	if (!period)
+		return SBI_EINVAL;
+
+	spin_lock(&mprof_lock);
+
+	if (!mprof_hdr) {
+		ret = SBI_ENOTSUPP;
+		goto done;
+	}
+
+	/* Period is in timer ticks when falling back to M-mode timer */
+	if (event && sbi_hart_has_extension(scratch, SBI_HART_EXT_SSCOFPMF) &&
+	    sbi_hart_mhpm_count(scratch))
+		mprof_mode = SBI_MPROF_MODE_COUNTER;
+	else
+		mprof_mode = SBI_MPROF_MODE_TIMER;
+	mprof_period = period;
+	mprof_event = event;
+	smp_wmb();
+	mprof_gen++;
+
+	mprof_hdr->mode = mprof_mode;
+	mprof_hdr->period = period;
+	ret = mprof_mode;
+
+done:
+	spin_unlock(&mprof_lock);
+	return ret;
+}
+
+int sbi_mprof_stop(void)
+{
+	spin_lock(&mprof_lock);
+
+	mprof_mode = SBI_MPROF_MODE_NONE;
+	smp_wmb();
+	mprof_gen++;
+
+	if (mprof_hdr)
+		mprof_hdr->mode = SBI_MPROF_MODE_NONE;
+
+	spin_unlock(&mprof_lock);
+	return 0;
+}
+
+int sbi_mprof_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct mprof_hart *mh;
+
+	if (cold_boot) {
+		mprof_off = sbi_scratch_alloc_offset(sizeof(*mh), "MPROF");
+		if (!mprof_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!mprof_off)
+			return SBI_ENOMEM;
+	}
+
+	/* Sampling source is setup again on first trap */
+	mh = sbi_scratch_offset_ptr(scratch, mprof_off);
+	mh->window = FALSE;
+	mh->mode = SBI_MPROF_MODE_NONE;
+	mh->gen = 0;
+	mh->mie = 0;
+
+	return 0;
+}
+
+void sbi_mprof_exit(struct sbi_scratch *scratch)
+{
+	struct mprof_hart *mh;
+
+	if (!mprof_off)
+		return;
+	mh = sbi_scratch_offset_ptr(scratch, mprof_off);
+
+	/* HART stop does not return to sbi_mprof_window_end() */
+	if (mh->window) {
+		csr_clear(CSR_MSTATUS, MSTATUS_MIE);
+		csr_write(CSR_MIE, mh->mie);
+		mh->window = FALSE;
+	}
+
+	if (mh->mode == SBI_MPROF_MODE_COUNTER)
+		mprof_counter_stop();
+	mh->mode = SBI_MPROF_MODE_NONE;
+}
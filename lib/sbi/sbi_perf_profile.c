@@ -0,0 +1,204 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_ipi.h>
+#include <sbi/sbi_perf_profile.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+
+/* M-mode custom read/write CSR ranges usable by profiles */
+#define PERF_CSR_CUSTOM0_BASE		0x7c0
+#define PERF_CSR_CUSTOM1_BASE		0xbc0
+#define PERF_CSR_CUSTOM_COUNT		64
+
+struct perf_profile_hart {
+	/* Profile active on the HART */
+	long current;
+	/* Profile was switched at runtime so keep it across HART restart */
+	bool switched;
+};
+
+static struct sbi_perf_profile perf_profiles[SBI_PERF_PROFILE_MAX];
+static u32 perf_profile_count;
+static u32 perf_profile_default;
+static unsigned long perf_hart_offset;
+
+static void perf_csr_update(u32 csr, unsigned long mask, unsigned long value)
+{
+#define switchcase_csr_update(__csr_num, __mask, __val)			\
+	case __csr_num:							\
+		csr_write(__csr_num, (csr_read(__csr_num) & ~(__mask)) |	\
+				     ((__val) & (__mask)));		\
+		break;
+#define switchcase_csr_update_2(__csr_num, __mask, __val)		\
+	switchcase_csr_update(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update(__csr_num + 1, __mask, __val)
+#define switchcase_csr_update_4(__csr_num, __mask, __val)		\
+	switchcase_csr_update_2(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update_2(__csr_num + 2, __mask, __val)
+#define switchcase_csr_update_8(__csr_num, __mask, __val)		\
+	switchcase_csr_update_4(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update_4(__csr_num + 4, __mask, __val)
+#define switchcase_csr_update_16(__csr_num, __mask, __val)		\
+	switchcase_csr_update_8(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update_8(__csr_num + 8, __mask, __val)
+#define switchcase_csr_update_32(__csr_num, __mask, __val)		\
+	switchcase_csr_update_16(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update_16(__csr_num + 16, __mask, __val)
+#define switchcase_csr_update_64(__csr_num, __mask, __val)		\
+	switchcase_csr_update_32(__csr_num + 0, __mask, __val)		\
+	switchcase_csr_update_32(__csr_num + 32, __mask, __val)
+
+	switch (csr) {
+	switchcase_csr_update_64(PERF_CSR_CUSTOM0_BASE, mask, value)
+	switchcase_csr_update_64(PERF_CSR_CUSTOM1_BASE, mask, value)
+	default:
+		break;
+	};
+
+#undef switchcase_csr_update_64
+#undef switchcase_csr_update_32
+#undef switchcase_csr_update_16
+#undef switchcase_csr_update_8
+#undef switchcase_csr_update_4
+#undef switchcase_csr_update_2
+#undef switchcase_csr_update
+}
+
+static void perf_profile_apply(struct sbi_scratch *scratch, long index)
+{
+	u32 i;
+	const struct sbi_perf_profile *prof;
+	struct perf_profile_hart *ph;
+
+	if (index < 0 || perf_profile_count <= index)
+		return;
+	prof = &perf_profiles[index];
+
+	for (i = 0; i < prof->csr_count; i++)
+		perf_csr_update(prof->csrs[i].csr,
+				prof->csrs[i].mask, prof->csrs[i].value);
+
+	/* Settle outstanding accesses under the new settings */
+	__asm__ __volatile__("fence.i" ::: "memory");
+	mb();
+
+	ph = sbi_scratch_offset_ptr(scratch, perf_hart_offset);
+	ph->current = index;
+}
+
+bool sbi_perf_profile_csr_valid(u32 csr)
+{
+	if (PERF_CSR_CUSTOM0_BASE <= csr &&
+	    csr < (PERF_CSR_CUSTOM0_BASE + PERF_CSR_CUSTOM_COUNT))
+		return TRUE;
+	if (PERF_CSR_CUSTOM1_BASE <= csr &&
+	    csr < (PERF_CSR_CUSTOM1_BASE + PERF_CSR_CUSTOM_COUNT))
+		return TRUE;
+	return FALSE;
+}
+
+int sbi_perf_profile_register(const struct sbi_perf_profile *prof)
+{
+	u32 i;
+
+	if (!prof || !prof->name[0] ||
+	    SBI_PERF_PROFILE_CSR_MAX < prof->csr_count)
+		return SBI_EINVAL;
+	for (i = 0; i < prof->csr_count; i++) {
+		if (!sbi_perf_profile_csr_valid(prof->csrs[i].csr))
+			return SBI_EINVAL;
+	}
+	for (i = 0; i < perf_profile_count; i++) {
+		if (!sbi_strcmp(perf_profiles[i].name, prof->name))
+			return SBI_EALREADY;
+	}
+	if (SBI_PERF_PROFILE_MAX <= perf_profile_count)
+		return SBI_ENOSPC;
+
+	sbi_memcpy(&perf_profiles[perf_profile_count], prof, sizeof(*prof));
+	perf_profiles[perf_profile_count].name[
+			sizeof(prof->name) - 1] = '\0';
+
+	return perf_profile_count++;
+}
+
+int sbi_perf_profile_set_default(u32 index)
+{
+	if (perf_profile_count <= index)
+		return SBI_EINVAL;
+
+	perf_profile_default = index;
+	return 0;
+}
+
+u32 sbi_perf_profile_count(void)
+{
+	return perf_profile_count;
+}
+
+const struct sbi_perf_profile *sbi_perf_profile_get(u32 index)
+{
+	if (perf_profile_count <= index)
+		return NULL;
+
+	return &perf_profiles[index];
+}
+
+int sbi_perf_profile_current(struct sbi_scratch *scratch)
+{
+	struct perf_profile_hart *ph;
+
+	if (!perf_hart_offset || !perf_profile_count)
+		return SBI_ENOENT;
+
+	ph = sbi_scratch_offset_ptr(scratch, perf_hart_offset);
+	return ph->current;
+}
+
+static void perf_profile_call_switch(void *arg)
+{
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	struct perf_profile_hart *ph =
+			sbi_scratch_offset_ptr(scratch, perf_hart_offset);
+
+	ph->switched = TRUE;
+	perf_profile_apply(scratch, (unsigned long)arg);
+}
+
+int sbi_perf_profile_switch(u32 index, ulong hmask, ulong hbase)
+{
+	if (perf_profile_count <= index)
+		return SBI_EINVAL;
+
+	/* Profile index is passed by value so there is no need to wait */
+	return sbi_ipi_call(hmask, hbase, perf_profile_call_switch,
+			    (void *)(unsigned long)index, FALSE);
+}
+
+int sbi_perf_profile_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct perf_profile_hart *ph;
+
+	if (cold_boot) {
+		perf_hart_offset = sbi_scratch_alloc_offset(sizeof(*ph),
+							    "PERF_PROFILE");
+		if (!perf_hart_offset)
+			return SBI_ENOMEM;
+	} else {
+		if (!perf_hart_offset)
+			return SBI_ENOMEM;
+	}
+
+	/* Same settings on every HART whenever it (re)starts */
+	ph = sbi_scratch_offset_ptr(scratch, perf_hart_offset);
+	perf_profile_apply(scratch, (ph->switched) ?
+				    ph->current : perf_profile_default);
+
+	return 0;
+}
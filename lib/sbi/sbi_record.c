@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_record.h>
+#include <sbi/sbi_ring.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_timer.h>
+
+bool sbi_record_enabled;
+
+static unsigned long record_addr;
+static unsigned long record_size;
+static struct sbi_ring_buffer record_rb;
+
+/* Record buffer is a plain ring buffer */
+_Static_assert(sizeof(struct sbi_record_header) ==
+	       sizeof(struct sbi_ring_header) &&
+	       sizeof(struct sbi_record_ring) == sizeof(struct sbi_ring),
+	       "record buffer layout must match ring buffer layout");
+
+void __sbi_record_ecall(unsigned long extid, unsigned long funcid,
+			const unsigned long *args)
+{
+	u32 i;
+	unsigned long mstatus;
+	struct sbi_record *rec;
+
+	rec = sbi_ring_buffer_begin(&record_rb, &mstatus);
+	if (!rec)
+		return;
+
+	rec->time = sbi_timer_value();
+	rec->extid = extid;
+	rec->funcid = funcid;
+	for (i = 0; i < array_size(rec->args); i++)
+		rec->args[i] = args[i];
+
+	sbi_ring_buffer_commit(&record_rb, mstatus);
+}
+
+int sbi_record_configure(unsigned long addr, unsigned long size)
+{
+	if (record_rb.hdr)
+		return SBI_EALREADY;
+	if (!size || (addr & 0x7))
+		return SBI_EINVAL;
+
+	record_addr = addr;
+	record_size = size;
+
+	return 0;
+}
+
+int sbi_record_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	if (!cold_boot || !record_size)
+		return 0;
+
+	if (sbi_ring_buffer_setup(&record_rb, scratch, record_addr, record_size,
+				  SBI_RECORD_RING_OFFSET, sizeof(struct sbi_record),
+				  SBI_RECORD_MAGIC, SBI_RECORD_VERSION)) {
+		sbi_printf("%s: invalid record buffer 0x%lx (size 0x%lx)\n",
+			   __func__, record_addr, record_size);
+		return 0;
+	}
+
+	sbi_record_enabled = TRUE;
+
+	return 0;
+}
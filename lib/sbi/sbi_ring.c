@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_barrier.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_ring.h>
+#include <sbi/sbi_scratch.h>
+
+int sbi_ring_buffer_setup(struct sbi_ring_buffer *rb,
+			  struct sbi_scratch *scratch,
+			  unsigned long addr, unsigned long size,
+			  unsigned long ring_offset, unsigned long record_size,
+			  u32 magic, u32 version)
+{
+	u32 i, entries, count;
+	unsigned long ring_size;
+	struct sbi_ring *ring;
+	struct sbi_ring_header *hdr = (void *)addr;
+	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
+
+	if (!rb || !record_size || ring_offset < sizeof(*hdr))
+		return SBI_EINVAL;
+	if (rb->hdr)
+		return SBI_EALREADY;
+
+	/* Ring buffer must not overlap with firmware */
+	if ((addr < (scratch->fw_start + scratch->fw_size)) &&
+	    (scratch->fw_start < (addr + size)))
+		return SBI_EINVALID_ADDR;
+
+	count = sbi_platform_hart_count(plat);
+	if (!count || size <= ring_offset)
+		return SBI_EINVAL;
+	ring_size = (size - ring_offset) / count;
+	if (ring_size <= sizeof(*ring))
+		return SBI_EINVAL;
+
+	/* Use largest power of 2 records fitting in each ring */
+	entries = (ring_size - sizeof(*ring)) / record_size;
+	if (entries < 2)
+		return SBI_EINVAL;
+	while (entries & (entries - 1))
+		entries &= entries - 1;
+	ring_size = sizeof(*ring) + entries * record_size;
+
+	hdr->version = version;
+	hdr->ring_count = count;
+	hdr->ring_entries = entries;
+	hdr->ring_offset = ring_offset;
+	hdr->ring_size = ring_size;
+	hdr->record_size = record_size;
+	hdr->reserved = 0;
+
+	for (i = 0; i < count; i++) {
+		ring = (void *)hdr + ring_offset + i * ring_size;
+		ring->head = 0;
+		ring->hartid = (plat->hart_index2id) ?
+				plat->hart_index2id[i] : i;
+		ring->reserved = 0;
+	}
+
+	rb->ring_count = count;
+	rb->ring_entries = entries;
+	rb->ring_offset = ring_offset;
+	rb->ring_size = ring_size;
+	rb->record_size = record_size;
+
+	smp_wmb();
+	hdr->magic = magic;
+	rb->hdr = hdr;
+
+	return 0;
+}
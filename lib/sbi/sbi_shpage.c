@@ -0,0 +1,222 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/riscv_locks.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hsm.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_shpage.h>
+#include <sbi/sbi_version.h>
+
+static spinlock_t shpage_lock = SPIN_LOCK_INITIALIZER;
+static bool shpage_ready;
+
+static inline struct sbi_shpage *shpage_ptr(const struct sbi_domain *dom)
+{
+	return (struct sbi_shpage *)dom->shared_page;
+}
+
+static void shpage_write_begin(struct sbi_shpage *sp)
+{
+	/* Make sequence odd even if page was never written before */
+	sp->seq |= 0x1;
+	smp_wmb();
+}
+
+static void shpage_write_end(struct sbi_shpage *sp)
+{
+	smp_wmb();
+	sp->seq++;
+}
+
+static u32 shpage_hart_state(const struct sbi_domain *dom, u32 hartid)
+{
+	int status;
+
+	if (!sbi_domain_is_assigned_hart(dom, hartid))
+		return SBI_SHPAGE_HART_STATE_NONE;
+
+	status = sbi_hsm_hart_state_to_status(
+				sbi_hsm_hart_get_state(dom, hartid));
+	if (status < 0)
+		return SBI_SHPAGE_HART_STATE_NONE;
+
+	return status;
+}
+
+static void shpage_populate(const struct sbi_domain *dom)
+{
+	u32 i, count;
+	unsigned long val;
+	struct sbi_ecall_extension *ext;
+	struct sbi_shpage *sp = shpage_ptr(dom);
+
+	shpage_write_begin(sp);
+
+	sp->magic = SBI_SHPAGE_MAGIC;
+	sp->version = SBI_SHPAGE_VERSION;
+	sp->domain_index = dom->index;
+
+	sp->spec_version = ((u64)sbi_ecall_version_major() <<
+			    SBI_SPEC_VERSION_MAJOR_OFFSET) |
+			   sbi_ecall_version_minor();
+	sp->impl_id = sbi_ecall_get_impid();
+	sp->impl_version = OPENSBI_VERSION;
+	sp->mvendorid = csr_read(CSR_MVENDORID);
+	sp->marchid = csr_read(CSR_MARCHID);
+	sp->mimpid = csr_read(CSR_MIMPID);
+
+	for (i = 0; i < SBI_SHPAGE_HARTMASK_WORDS; i++)
+		sp->domain_harts[i] = 0;
+	count = sbi_scratch_last_hartid() + 1;
+	if (SBI_HARTMASK_MAX_BITS < count)
+		count = SBI_HARTMASK_MAX_BITS;
+	for (i = 0; i < SBI_HARTMASK_MAX_BITS; i++) {
+		if (count <= i) {
+			sp->hart_state[i] = SBI_SHPAGE_HART_STATE_NONE;
+			continue;
+		}
+		sp->hart_state[i] = shpage_hart_state(dom, i);
+		if (sbi_domain_is_assigned_hart(dom, i))
+			sp->domain_harts[i / 64] |= 1ULL << (i % 64);
+	}
+	sp->hart_count = count;
+
+	count = 0;
+	sbi_list_for_each_entry(ext, sbi_ecall_get_extensions_head(), head) {
+		/* Extension ID ranges (legacy and vendor) are not listed */
+		if (ext->extid_start != ext->extid_end)
+			continue;
+		if (SBI_SHPAGE_PROBE_MAX <= count)
+			break;
+		if (sbi_ecall_probe_extension(ext->extid_start, &val))
+			continue;
+		sp->probe[count].extid = ext->extid_start;
+		sp->probe[count].value = val;
+		count++;
+	}
+	sp->probe_count = count;
+	for (i = count; i < SBI_SHPAGE_PROBE_MAX; i++) {
+		sp->probe[i].extid = 0;
+		sp->probe[i].value = 0;
+	}
+
+	shpage_write_end(sp);
+}
+
+static bool shpage_addr_valid(const struct sbi_domain *dom,
+			      unsigned long addr, unsigned long access)
+{
+	if (!addr || (addr & (SBI_SHPAGE_SIZE - 1)))
+		return FALSE;
+
+	if (!sbi_domain_check_addr_range(dom, addr, SBI_SHPAGE_SIZE,
+					 PRV_S, access))
+		return FALSE;
+
+	return TRUE;
+}
+
+int sbi_shpage_set(struct sbi_domain *dom, unsigned long addr)
+{
+	if (!dom)
+		return SBI_EINVAL;
+
+	if (addr == SBI_SHPAGE_DISABLE) {
+		spin_lock(&shpage_lock);
+		dom->shared_page = 0;
+		spin_unlock(&shpage_lock);
+		return 0;
+	}
+
+	/*
+	 * Page registered at runtime must be owned by the domain so that
+	 * it can't be used to overwrite memory it is only allowed to read.
+	 */
+	if (!shpage_addr_valid(dom, addr, SBI_DOMAIN_READ | SBI_DOMAIN_WRITE))
+		return SBI_EINVALID_ADDR;
+
+	spin_lock(&shpage_lock);
+	dom->shared_page = addr;
+	shpage_populate(dom);
+	spin_unlock(&shpage_lock);
+
+	return 0;
+}
+
+unsigned long sbi_shpage_get(const struct sbi_domain *dom)
+{
+	if (!dom || !dom->shared_page)
+		return SBI_SHPAGE_DISABLE;
+
+	return dom->shared_page;
+}
+
+void sbi_shpage_hart_state_update(u32 hartid)
+{
+	struct sbi_shpage *sp;
+	const struct sbi_domain *dom;
+
+	if (!shpage_ready || SBI_HARTMASK_MAX_BITS <= hartid)
+		return;
+
+	dom = sbi_hartid_to_domain(hartid);
+	if (!dom)
+		return;
+
+	/*
+	 * Read the HSM state under the lock instead of publishing the
+	 * state of the caller's transition so that racing transitions
+	 * of the same HART can't leave a stale state in the page.
+	 */
+	spin_lock(&shpage_lock);
+	sp = shpage_ptr(dom);
+	if (sp) {
+		shpage_write_begin(sp);
+		sp->hart_state[hartid] = shpage_hart_state(dom, hartid);
+		shpage_write_end(sp);
+	}
+	spin_unlock(&shpage_lock);
+}
+
+int sbi_shpage_init(void)
+{
+	u32 i;
+	struct sbi_domain *dom;
+
+	sbi_domain_for_each(i, dom) {
+		if (dom->shared_page &&
+		    !shpage_addr_valid(dom, dom->shared_page,
+				       SBI_DOMAIN_READ)) {
+			sbi_printf("%s: %s: invalid shared page 0x%lx\n",
+				   __func__, dom->name, dom->shared_page);
+			dom->shared_page = 0;
+		}
+	}
+
+	/*
+	 * Note: HSM transitions racing with this are not lost because
+	 * the shared pages are populated after marking them ready.
+	 */
+	shpage_ready = TRUE;
+	smp_mb();
+
+	sbi_domain_for_each(i, dom) {
+		if (!dom->shared_page)
+			continue;
+
+		spin_lock(&shpage_lock);
+		shpage_populate(dom);
+		spin_unlock(&shpage_lock);
+	}
+
+	return 0;
+}
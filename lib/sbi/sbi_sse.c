@@ -0,0 +1,529 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_bitops.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_hsm.h>
+#include <sbi/sbi_ipi.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_sse.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_trap.h>
+
+/* Supported events (lower index wins among events of same priority) */
+static const u32 sse_event_ids[] = {
+	SBI_SSE_EVENT_LOCAL_PMU_OVERFLOW,
+	SBI_SSE_EVENT_LOCAL_SOFTWARE,
+};
+
+#define SSE_EVENT_COUNT		array_size(sse_event_ids)
+#define SSE_EVENT_PMU_OVERFLOW	0
+#define SSE_EVENT_NONE		-1
+
+#define SSE_INTERRUPTED_FLAGS_MASK				\
+	(SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPP |		\
+	 SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPIE |		\
+	 SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPV |		\
+	 SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPVP)
+
+struct sse_event {
+	/* Attributes indexed by SBI_SSE_ATTR_xxx (STATUS holds the state) */
+	unsigned long attrs[SBI_SSE_ATTR_MAX];
+};
+
+struct sse_hart {
+	struct sse_event events[SSE_EVENT_COUNT];
+	/* Bitmap of pending events (also updated by remote HARTs) */
+	volatile unsigned long pending;
+	/* Index of running event or SSE_EVENT_NONE */
+	int running;
+	/* Events are not delivered while masked */
+	bool masked;
+	/* MIE has to follow state of PMU overflow event */
+	bool update_irqs;
+	/* Running event was completed by sbi_sse_complete() */
+	bool complete;
+	unsigned long complete_a0;
+	unsigned long complete_a1;
+};
+
+static unsigned long sse_off;
+
+static inline struct sse_hart *sse_thishart(void)
+{
+	return sbi_scratch_thishart_offset_ptr(sse_off);
+}
+
+static int sse_event_index(u32 event_id)
+{
+	int i;
+
+	for (i = 0; i < SSE_EVENT_COUNT; i++) {
+		if (sse_event_ids[i] == event_id)
+			return i;
+	}
+
+	return SSE_EVENT_NONE;
+}
+
+static struct sse_event *sse_event_get(struct sse_hart *shs, u32 event_id)
+{
+	int i = sse_event_index(event_id);
+
+	return (i == SSE_EVENT_NONE) ? NULL : &shs->events[i];
+}
+
+static inline unsigned long sse_event_state(struct sse_event *e)
+{
+	return e->attrs[SBI_SSE_ATTR_STATUS];
+}
+
+static inline void sse_event_set_state(struct sse_hart *shs,
+				       struct sse_event *e,
+				       unsigned long state)
+{
+	e->attrs[SBI_SSE_ATTR_STATUS] = state;
+	if (e == &shs->events[SSE_EVENT_PMU_OVERFLOW])
+		shs->update_irqs = TRUE;
+}
+
+static int sse_attrs_check(u32 base_attr_id, u32 attr_count,
+			   unsigned long phys_lo, unsigned long phys_hi,
+			   unsigned long access)
+{
+	unsigned long size = attr_count * sizeof(unsigned long);
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	if (!attr_count)
+		return SBI_EINVAL;
+	if (SBI_SSE_ATTR_MAX <= base_attr_id ||
+	    SBI_SSE_ATTR_MAX - base_attr_id < attr_count)
+		return SBI_EBAD_RANGE;
+
+	if (phys_hi || (phys_lo & (sizeof(unsigned long) - 1)) ||
+	    !sbi_domain_check_addr_range(dom, phys_lo, size, PRV_S, access))
+		return SBI_EINVALID_ADDR;
+
+	return 0;
+}
+
+int sbi_sse_read_attrs(u32 event_id, u32 base_attr_id, u32 attr_count,
+		       unsigned long phys_lo, unsigned long phys_hi)
+{
+	int i, ret;
+	unsigned long val, *out = (unsigned long *)phys_lo;
+	struct sse_hart *shs = sse_thishart();
+	struct sse_event *e = sse_event_get(shs, event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+
+	ret = sse_attrs_check(base_attr_id, attr_count, phys_lo, phys_hi,
+			      SBI_DOMAIN_WRITE);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < attr_count; i++) {
+		val = e->attrs[base_attr_id + i];
+		if (base_attr_id + i == SBI_SSE_ATTR_STATUS) {
+			if (shs->pending & BIT(e - shs->events))
+				val |= 1UL << SBI_SSE_ATTR_STATUS_PENDING_OFFSET;
+			val |= 1UL << SBI_SSE_ATTR_STATUS_INJECT_OFFSET;
+		}
+		out[i] = val;
+	}
+
+	return 0;
+}
+
+static int sse_attr_check(struct sse_event *e, u32 attr_id, unsigned long val)
+{
+	switch (attr_id) {
+	case SBI_SSE_ATTR_CONFIG:
+		if (val & ~SBI_SSE_ATTR_CONFIG_ONESHOT)
+			return SBI_EINVAL;
+		if (sse_event_state(e) >= SBI_SSE_STATE_ENABLED)
+			return SBI_EINVALID_STATE;
+		return 0;
+	case SBI_SSE_ATTR_PRIO:
+		if ((u32)val != val)
+			return SBI_EINVAL;
+		if (sse_event_state(e) >= SBI_SSE_STATE_ENABLED)
+			return SBI_EINVALID_STATE;
+		return 0;
+	case SBI_SSE_ATTR_INTERRUPTED_FLAGS:
+		if (val & ~SSE_INTERRUPTED_FLAGS_MASK)
+			return SBI_EINVAL;
+		/* fallthrough */
+	case SBI_SSE_ATTR_INTERRUPTED_SEPC:
+	case SBI_SSE_ATTR_INTERRUPTED_A6:
+	case SBI_SSE_ATTR_INTERRUPTED_A7:
+		if (sse_event_state(e) != SBI_SSE_STATE_RUNNING)
+			return SBI_EINVALID_STATE;
+		return 0;
+	default:
+		return SBI_EDENIED;
+	}
+}
+
+int sbi_sse_write_attrs(u32 event_id, u32 base_attr_id, u32 attr_count,
+			unsigned long phys_lo, unsigned long phys_hi)
+{
+	int i, ret;
+	unsigned long vals[SBI_SSE_ATTR_MAX];
+	struct sse_event *e = sse_event_get(sse_thishart(), event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+
+	ret = sse_attrs_check(base_attr_id, attr_count, phys_lo, phys_hi,
+			      SBI_DOMAIN_READ);
+	if (ret)
+		return ret;
+
+	/* Take a copy so that all values are checked before any update */
+	sbi_memcpy(vals, (void *)phys_lo, attr_count * sizeof(unsigned long));
+	for (i = 0; i < attr_count; i++) {
+		ret = sse_attr_check(e, base_attr_id + i, vals[i]);
+		if (ret)
+			return ret;
+	}
+
+	for (i = 0; i < attr_count; i++)
+		e->attrs[base_attr_id + i] = vals[i];
+
+	return 0;
+}
+
+int sbi_sse_register(u32 event_id, unsigned long entry_pc,
+		     unsigned long entry_arg)
+{
+	struct sse_event *e = sse_event_get(sse_thishart(), event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+	if (!entry_pc || (entry_pc & 0x1))
+		return SBI_EINVALID_ADDR;
+	if (sse_event_state(e) != SBI_SSE_STATE_UNUSED)
+		return SBI_EINVALID_STATE;
+
+	e->attrs[SBI_SSE_ATTR_ENTRY_PC] = entry_pc;
+	e->attrs[SBI_SSE_ATTR_ENTRY_ARG] = entry_arg;
+	e->attrs[SBI_SSE_ATTR_STATUS] = SBI_SSE_STATE_REGISTERED;
+
+	return 0;
+}
+
+int sbi_sse_unregister(u32 event_id)
+{
+	struct sse_hart *shs = sse_thishart();
+	struct sse_event *e = sse_event_get(shs, event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+	if (sse_event_state(e) != SBI_SSE_STATE_REGISTERED &&
+	    sse_event_state(e) != SBI_SSE_STATE_ENABLED)
+		return SBI_EINVALID_STATE;
+
+	sse_event_set_state(shs, e, SBI_SSE_STATE_UNUSED);
+	e->attrs[SBI_SSE_ATTR_ENTRY_PC] = 0;
+	e->attrs[SBI_SSE_ATTR_ENTRY_ARG] = 0;
+	atomic_raw_clear_bit(e - shs->events, &shs->pending);
+
+	return 0;
+}
+
+int sbi_sse_enable(u32 event_id)
+{
+	struct sse_hart *shs = sse_thishart();
+	struct sse_event *e = sse_event_get(shs, event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+	if (sse_event_state(e) != SBI_SSE_STATE_REGISTERED)
+		return SBI_EINVALID_STATE;
+
+	sse_event_set_state(shs, e, SBI_SSE_STATE_ENABLED);
+
+	return 0;
+}
+
+int sbi_sse_disable(u32 event_id)
+{
+	struct sse_hart *shs = sse_thishart();
+	struct sse_event *e = sse_event_get(shs, event_id);
+
+	if (!e)
+		return SBI_ENOTSUPP;
+	if (sse_event_state(e) != SBI_SSE_STATE_ENABLED)
+		return SBI_EINVALID_STATE;
+
+	sse_event_set_state(shs, e, SBI_SSE_STATE_REGISTERED);
+
+	return 0;
+}
+
+int sbi_sse_complete(unsigned long a0, unsigned long a1)
+{
+	struct sse_hart *shs = sse_thishart();
+
+	if (shs->running == SSE_EVENT_NONE || shs->complete)
+		return SBI_EINVALID_STATE;
+
+	shs->complete = TRUE;
+	shs->complete_a0 = a0;
+	shs->complete_a1 = a1;
+
+	return 0;
+}
+
+static void sse_call_inject(void *arg)
+{
+	/* Event is delivered when returning from the IPI */
+	atomic_raw_set_bit((unsigned long)arg, &sse_thishart()->pending);
+}
+
+int sbi_sse_inject(u32 event_id, unsigned long hartid)
+{
+	int i = sse_event_index(event_id);
+	struct sbi_domain *dom = sbi_domain_thishart_ptr();
+
+	if (i == SSE_EVENT_NONE)
+		return SBI_ENOTSUPP;
+	if (sbi_platform_hart_invalid(sbi_platform_thishart_ptr(), hartid) ||
+	    sbi_hsm_hart_get_state(dom, hartid) != SBI_HART_STARTED)
+		return SBI_EINVAL;
+	if (sbi_domain_sched_is_shared(hartid))
+		return SBI_EDENIED;
+
+	/* Event is delivered when returning from this ecall */
+	if (hartid == current_hartid()) {
+		atomic_raw_set_bit(i, &sse_thishart()->pending);
+		return 0;
+	}
+
+	return sbi_ipi_call(1UL, hartid, sse_call_inject,
+			    (void *)(unsigned long)i, FALSE);
+}
+
+int sbi_sse_hart_unmask(void)
+{
+	struct sse_hart *shs = sse_thishart();
+
+	if (!shs->masked)
+		return SBI_EALREADY_STARTED;
+	shs->masked = FALSE;
+
+	return 0;
+}
+
+int sbi_sse_hart_mask(void)
+{
+	struct sse_hart *shs = sse_thishart();
+
+	if (shs->masked)
+		return SBI_EALREADY_STOPPED;
+	shs->masked = TRUE;
+
+	return 0;
+}
+
+bool sbi_sse_hart_running(void)
+{
+	if (!sse_off)
+		return FALSE;
+
+	return (sse_thishart()->running != SSE_EVENT_NONE) ? TRUE : FALSE;
+}
+
+bool sbi_sse_overflow_process(void)
+{
+	struct sse_hart *shs;
+
+	if (!sse_off)
+		return FALSE;
+	shs = sse_thishart();
+	if (sse_event_state(&shs->events[SSE_EVENT_PMU_OVERFLOW]) <
+	    SBI_SSE_STATE_ENABLED)
+		return FALSE;
+
+	/* S-mode finds the overflowing counters in SCOUNTOVF */
+	csr_clear(CSR_MIP, MIP_LCOFIP);
+	atomic_raw_set_bit(SSE_EVENT_PMU_OVERFLOW, &shs->pending);
+
+	return TRUE;
+}
+
+static void sse_event_complete(struct sse_hart *shs,
+			       struct sbi_trap_regs *regs)
+{
+	unsigned long hstatus;
+	struct sse_event *e = &shs->events[shs->running];
+	unsigned long flags = e->attrs[SBI_SSE_ATTR_INTERRUPTED_FLAGS];
+
+	/* Resume at SEPC as if the handler executed SRET */
+	regs->a0 = shs->complete_a0;
+	regs->a1 = shs->complete_a1;
+	regs->mepc = csr_read(CSR_SEPC);
+	regs->mstatus &= ~MSTATUS_MPP;
+	if (regs->mstatus & MSTATUS_SPP)
+		regs->mstatus |= (PRV_S << MSTATUS_MPP_SHIFT);
+	regs->mstatus &= ~MSTATUS_SIE;
+	if (regs->mstatus & MSTATUS_SPIE)
+		regs->mstatus |= MSTATUS_SIE;
+#if __riscv_xlen == 32
+	regs->mstatusH &= ~MSTATUSH_MPV;
+#else
+	regs->mstatus &= ~MSTATUS_MPV;
+#endif
+
+	if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				   SBI_HART_EXT_MISA('H'))) {
+		hstatus = csr_read(CSR_HSTATUS);
+		if (hstatus & HSTATUS_SPV) {
+#if __riscv_xlen == 32
+			regs->mstatusH |= MSTATUSH_MPV;
+#else
+			regs->mstatus |= MSTATUS_MPV;
+#endif
+		}
+		hstatus &= ~(HSTATUS_SPV | HSTATUS_SPVP);
+		if (flags & SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPV)
+			hstatus |= HSTATUS_SPV;
+		if (flags & SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPVP)
+			hstatus |= HSTATUS_SPVP;
+		csr_write(CSR_HSTATUS, hstatus);
+	}
+
+	/* Restore S-mode state saved when the event was delivered */
+	csr_write(CSR_SEPC, e->attrs[SBI_SSE_ATTR_INTERRUPTED_SEPC]);
+	regs->mstatus &= ~(MSTATUS_SPP | MSTATUS_SPIE);
+	if (flags & SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPP)
+		regs->mstatus |= MSTATUS_SPP;
+	if (flags & SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPIE)
+		regs->mstatus |= MSTATUS_SPIE;
+	regs->a6 = e->attrs[SBI_SSE_ATTR_INTERRUPTED_A6];
+	regs->a7 = e->attrs[SBI_SSE_ATTR_INTERRUPTED_A7];
+
+	if (e->attrs[SBI_SSE_ATTR_CONFIG] & SBI_SSE_ATTR_CONFIG_ONESHOT)
+		sse_event_set_state(shs, e, SBI_SSE_STATE_REGISTERED);
+	else
+		sse_event_set_state(shs, e, SBI_SSE_STATE_ENABLED);
+	shs->running = SSE_EVENT_NONE;
+	shs->complete = FALSE;
+}
+
+static void sse_event_deliver(struct sse_hart *shs,
+			      struct sbi_trap_regs *regs)
+{
+	int i, idx = SSE_EVENT_NONE;
+	unsigned long hstatus, sepc, flags = 0;
+	struct sse_event *e;
+
+	/* Pick enabled event with lowest priority value */
+	for (i = 0; i < SSE_EVENT_COUNT; i++) {
+		if (!(shs->pending & BIT(i)) ||
+		    sse_event_state(&shs->events[i]) != SBI_SSE_STATE_ENABLED)
+			continue;
+		if (idx == SSE_EVENT_NONE ||
+		    shs->events[i].attrs[SBI_SSE_ATTR_PRIO] <
+		    shs->events[idx].attrs[SBI_SSE_ATTR_PRIO])
+			idx = i;
+	}
+	if (idx == SSE_EVENT_NONE)
+		return;
+	e = &shs->events[idx];
+
+	if (regs->mstatus & MSTATUS_SPP)
+		flags |= SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPP;
+	if (regs->mstatus & MSTATUS_SPIE)
+		flags |= SBI_SSE_ATTR_INTERRUPTED_FLAGS_SSTATUS_SPIE;
+	if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				   SBI_HART_EXT_MISA('H'))) {
+		hstatus = csr_read(CSR_HSTATUS);
+		if (hstatus & HSTATUS_SPV)
+			flags |= SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPV;
+		if (hstatus & HSTATUS_SPVP)
+			flags |= SBI_SSE_ATTR_INTERRUPTED_FLAGS_HSTATUS_SPVP;
+	}
+
+	/* Enter the handler as if HS-mode (or S-mode) took a trap */
+	sepc = csr_swap(CSR_SEPC, regs->mepc);
+	if (sbi_trap_enter_smode(regs, e->attrs[SBI_SSE_ATTR_ENTRY_PC])) {
+		csr_write(CSR_SEPC, sepc);
+		return;
+	}
+
+	e->attrs[SBI_SSE_ATTR_INTERRUPTED_SEPC] = sepc;
+	e->attrs[SBI_SSE_ATTR_INTERRUPTED_FLAGS] = flags;
+	e->attrs[SBI_SSE_ATTR_INTERRUPTED_A6] = regs->a6;
+	e->attrs[SBI_SSE_ATTR_INTERRUPTED_A7] = regs->a7;
+	regs->a6 = current_hartid();
+	regs->a7 = e->attrs[SBI_SSE_ATTR_ENTRY_ARG];
+
+	atomic_raw_clear_bit(idx, &shs->pending);
+	e->attrs[SBI_SSE_ATTR_STATUS] = SBI_SSE_STATE_RUNNING;
+	shs->running = idx;
+}
+
+void sbi_sse_trap_exit(struct sbi_trap_regs *regs)
+{
+	struct sse_hart *shs;
+
+	if (!sse_off ||
+	    ((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) == PRV_M)
+		return;
+	shs = sse_thishart();
+
+	if (shs->complete)
+		sse_event_complete(shs, regs);
+
+	/* Done here because a trap might have restored MIE on its way out */
+	if (shs->update_irqs) {
+		shs->update_irqs = FALSE;
+		if (sse_event_state(&shs->events[SSE_EVENT_PMU_OVERFLOW]) >=
+		    SBI_SSE_STATE_ENABLED)
+			csr_set(CSR_MIE, MIP_LCOFIP);
+		else
+			csr_clear(CSR_MIE, MIP_LCOFIP);
+	}
+
+	if (shs->pending && !shs->masked && shs->running == SSE_EVENT_NONE)
+		sse_event_deliver(shs, regs);
+}
+
+int sbi_sse_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	int i;
+	struct sse_hart *shs;
+
+	if (cold_boot) {
+		sse_off = sbi_scratch_alloc_offset(sizeof(*shs), "SSE");
+		if (!sse_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!sse_off)
+			return SBI_ENOMEM;
+	}
+
+	/* Events of a HART are unused and masked after (re)start */
+	shs = sbi_scratch_offset_ptr(scratch, sse_off);
+	sbi_memset(shs, 0, sizeof(*shs));
+	for (i = 0; i < SSE_EVENT_COUNT; i++)
+		shs->events[i].attrs[SBI_SSE_ATTR_PREFERRED_HART] =
+							current_hartid();
+	shs->running = SSE_EVENT_NONE;
+	shs->masked = TRUE;
+	csr_clear(CSR_MIE, MIP_LCOFIP);
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_stack.h>
+
+static unsigned long stack_painted_offset;
+
+/*
+ * The firmware places the HART stack right below its sbi_scratch and
+ * both are carved out of one hart_stack_size sized area, so the stack
+ * grows down from the scratch address.
+ */
+unsigned long sbi_stack_size(struct sbi_scratch *scratch)
+{
+	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
+	u32 size = sbi_platform_hart_stack_size(plat);
+
+	if (size <= SBI_SCRATCH_SIZE)
+		return 0;
+
+	return size - SBI_SCRATCH_SIZE;
+}
+
+int sbi_stack_usage(struct sbi_scratch *scratch, unsigned long *used)
+{
+	unsigned long pos, top, *painted;
+
+	if (!scratch || !used || !stack_painted_offset)
+		return SBI_EINVAL;
+
+	painted = sbi_scratch_offset_ptr(scratch, stack_painted_offset);
+	if (!*painted)
+		return SBI_ENOTSUPP;
+
+	top = (unsigned long)scratch;
+	pos = top - sbi_stack_size(scratch);
+	while (pos < top &&
+	       *(unsigned long *)pos == SBI_STACK_PAINT_PATTERN)
+		pos += __SIZEOF_POINTER__;
+
+	*used = top - pos;
+
+	return 0;
+}
+
+/*
+ * Paint the unused part of the current HART stack. Everything below
+ * the stack pointer is free at this point and the loop itself does not
+ * touch memory below it, so the paint can be done in place.
+ */
+static void __attribute__((noinline)) stack_paint(struct sbi_scratch *scratch)
+{
+	unsigned long sp, *pos, *end;
+
+	__asm__ __volatile__("mv %0, sp" : "=r"(sp));
+
+	pos = (unsigned long *)((unsigned long)scratch - sbi_stack_size(scratch));
+	end = (unsigned long *)(sp & ~(__SIZEOF_POINTER__ - 1));
+	while (pos < end)
+		*pos++ = SBI_STACK_PAINT_PATTERN;
+}
+
+int sbi_stack_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	unsigned long *painted;
+
+	if (cold_boot) {
+		stack_painted_offset = sbi_scratch_alloc_offset(
+						__SIZEOF_POINTER__,
+						"STACK_PAINTED");
+		if (!stack_painted_offset)
+			return SBI_ENOMEM;
+	} else {
+		if (!stack_painted_offset)
+			return SBI_ENOMEM;
+	}
+
+	if (!(scratch->options & SBI_SCRATCH_STACK_PAINT))
+		return 0;
+
+	/* Paint only once so that HART restarts keep the high-water mark */
+	painted = sbi_scratch_offset_ptr(scratch, stack_painted_offset);
+	if (*painted)
+		return 0;
+
+	if (sbi_stack_size(scratch))
+		stack_paint(scratch);
+	*painted = 1;
+
+	return 0;
+}
@@ -9,14 +9,23 @@
  */
 
 #include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
 #include <sbi/sbi_bitops.h>
+#include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
+#include <sbi/sbi_domain_sched.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_fwtime.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_hsm.h>
+#include <sbi/sbi_mprof.h>
 #include <sbi/sbi_platform.h>
+#include <sbi/sbi_sse.h>
 #include <sbi/sbi_system.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_init.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
 
 bool sbi_system_reset_supported(u32 reset_type, u32 reset_reason)
 {
@@ -54,3 +63,141 @@ void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason)
 	/* If platform specific reset did not work then do sbi_exit() */
 	sbi_exit(scratch);
 }
+
+/* M-mode state of the HART suspending the system (kept in memory) */
+struct system_suspend_ctx {
+	unsigned long mtvec;
+	unsigned long medeleg;
+	unsigned long mideleg;
+	unsigned long mie;
+	/* Timer value when the system was suspended */
+	u64 suspend_time;
+	/* Timer value when the system woke up (zero if not known) */
+	u64 wake_time;
+	/* Timer ticks between wake up and returning to S-mode */
+	u64 resume_latency;
+};
+
+static struct system_suspend_ctx suspend_ctx;
+static bool suspend_test;
+
+void sbi_system_suspend_test_enable(void)
+{
+	suspend_test = TRUE;
+}
+
+/*
+ * Emulated suspend to RAM which waits for any enabled interrupt (such
+ * as the S-mode timer event) and then goes through the regular resume
+ * path as if the HART lost its state.
+ */
+static int system_suspend_test(u32 sleep_type)
+{
+	while (!(csr_read(CSR_MIP) & csr_read(CSR_MIE)))
+		wfi();
+
+	return 0;
+}
+
+bool sbi_system_suspend_supported(u32 sleep_type)
+{
+	if (suspend_test && sleep_type == SBI_SUSP_SLEEP_TYPE_SUSPEND)
+		return TRUE;
+
+	if (sbi_platform_system_suspend_check(sbi_platform_thishart_ptr(),
+					      sleep_type))
+		return TRUE;
+
+	return FALSE;
+}
+
+int sbi_system_suspend(u32 sleep_type, ulong resume_addr, ulong opaque)
+{
+	int ret;
+	unsigned long prev_mode;
+	u32 hartid = current_hartid();
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	void (*jump_warmboot)(void) = (void (*)(void))scratch->warmboot_addr;
+
+	if (!sbi_system_suspend_supported(sleep_type))
+		return SBI_EINVAL;
+
+	prev_mode = (csr_read(CSR_MSTATUS) & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
+	if (prev_mode != PRV_S && prev_mode != PRV_U)
+		return SBI_EFAIL;
+
+	/* Same permission as system reset and only on owned HARTs */
+	if (!dom->system_reset_allowed ||
+	    !sbi_domain_sched_is_owner(dom, hartid))
+		return SBI_EFAIL;
+
+	/* The context interrupted by a running event would be lost */
+	if (sbi_sse_hart_running())
+		return SBI_EFAIL;
+
+	if (!sbi_hsm_hart_others_stopped(hartid))
+		return SBI_EDENIED;
+
+	if (!sbi_domain_check_addr(dom, resume_addr, prev_mode,
+				   SBI_DOMAIN_EXECUTE))
+		return SBI_EINVALID_ADDR;
+
+	ret = sbi_hsm_hart_suspend(scratch, hartid);
+	if (ret)
+		return ret;
+
+	/* Resume goes to S-mode without the trap handler exit path */
+	sbi_mprof_window_end();
+	sbi_fwtime_exit(SBI_FWTIME_NONE);
+
+	scratch->next_arg1 = opaque;
+	scratch->next_addr = resume_addr;
+	scratch->next_mode = prev_mode;
+
+	suspend_ctx.mtvec = csr_read(CSR_MTVEC);
+	suspend_ctx.medeleg = csr_read(CSR_MEDELEG);
+	suspend_ctx.mideleg = csr_read(CSR_MIDELEG);
+	suspend_ctx.mie = csr_read(CSR_MIE);
+	suspend_ctx.wake_time = 0;
+	suspend_ctx.suspend_time = sbi_timer_value();
+
+	sbi_trace(SBI_TRACE_SYSTEM_SUSPEND, 0, sleep_type, 0, 0);
+
+	if (suspend_test)
+		ret = system_suspend_test(sleep_type);
+	else
+		ret = sbi_platform_system_suspend(sbi_platform_ptr(scratch),
+						  sleep_type,
+						  scratch->warmboot_addr);
+	if (ret) {
+		sbi_hsm_hart_resume(scratch, hartid);
+		return ret;
+	}
+
+	/* Resume the same way as platforms which lost HART state */
+	suspend_ctx.wake_time = sbi_timer_value();
+	jump_warmboot();
+	__builtin_unreachable();
+}
+
+void sbi_system_resume(u64 resume_start)
+{
+	u64 wake;
+
+	csr_write(CSR_MTVEC, suspend_ctx.mtvec);
+	csr_write(CSR_MEDELEG, suspend_ctx.medeleg);
+	csr_write(CSR_MIDELEG, suspend_ctx.mideleg);
+	csr_write(CSR_MIE, suspend_ctx.mie);
+
+	/* Timer events are kept in memory but the M-mode timer is not */
+	sbi_timer_event_restore();
+
+	wake = suspend_ctx.wake_time ? suspend_ctx.wake_time : resume_start;
+	suspend_ctx.resume_latency = sbi_timer_value() - wake;
+	sbi_trace(SBI_TRACE_SYSTEM_RESUME, 0, 0,
+		  wake - suspend_ctx.suspend_time, suspend_ctx.resume_latency);
+	sbi_dprintf("System resumed after %lu ticks in %lu ticks\n",
+		    (ulong)(wake - suspend_ctx.suspend_time),
+		    (ulong)suspend_ctx.resume_latency);
+}
@@ -14,10 +14,16 @@
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
 
 static unsigned long time_delta_off;
+static unsigned long time_event_off;
+static unsigned long time_deadline_off;
 static u64 (*get_time_val)(const struct sbi_platform *plat);
 
+/* Value of time_event when there is no pending timer event */
+#define TIME_EVENT_NONE		(~0ULL)
+
 #if __riscv_xlen == 32
 static u64 get_ticks(const struct sbi_platform *plat)
 {
@@ -80,20 +86,102 @@ void sbi_timer_set_delta_upper(ulong delta_upper)
 
 void sbi_timer_event_start(u64 next_event)
 {
-	sbi_platform_timer_event_start(sbi_platform_thishart_ptr(), next_event);
+	u64 *time_event = sbi_scratch_thishart_offset_ptr(time_event_off);
+	u64 *time_deadline = sbi_scratch_thishart_offset_ptr(time_deadline_off);
+
+	sbi_trace(SBI_TRACE_TIMER_START, 0, 0, next_event, 0);
+	*time_event = next_event;
+	sbi_platform_timer_event_start(sbi_platform_thishart_ptr(),
+			(next_event < *time_deadline) ? next_event : *time_deadline);
 	csr_clear(CSR_MIP, MIP_STIP);
 	csr_set(CSR_MIE, MIP_MTIP);
 }
 
+void sbi_timer_event_stop(void)
+{
+	u64 *time_event = sbi_scratch_thishart_offset_ptr(time_event_off);
+
+	*time_event = TIME_EVENT_NONE;
+	sbi_timer_event_restore();
+}
+
 void sbi_timer_process(void)
 {
-	csr_clear(CSR_MIE, MIP_MTIP);
-	csr_set(CSR_MIP, MIP_STIP);
+	u64 now;
+	u64 *time_event = sbi_scratch_thishart_offset_ptr(time_event_off);
+	u64 *time_deadline = sbi_scratch_thishart_offset_ptr(time_deadline_off);
+
+	if (*time_deadline == TIME_EVENT_NONE) {
+		*time_event = TIME_EVENT_NONE;
+		csr_clear(CSR_MIE, MIP_MTIP);
+		csr_set(CSR_MIP, MIP_STIP);
+		return;
+	}
+
+	/* The M-mode timer is shared by the timer event and the deadline */
+	now = sbi_timer_value();
+	if (*time_deadline <= now)
+		*time_deadline = TIME_EVENT_NONE;
+	if (*time_event <= now) {
+		*time_event = TIME_EVENT_NONE;
+		csr_set(CSR_MIP, MIP_STIP);
+	}
+	sbi_timer_event_restore();
+}
+
+bool sbi_timer_event_pending(u64 *next_event)
+{
+	u64 *time_event = sbi_scratch_thishart_offset_ptr(time_event_off);
+
+	if (*time_event == TIME_EVENT_NONE)
+		return FALSE;
+	if (next_event)
+		*next_event = *time_event;
+
+	return TRUE;
+}
+
+void sbi_timer_deadline_start(u64 deadline)
+{
+	u64 *time_deadline = sbi_scratch_thishart_offset_ptr(time_deadline_off);
+
+	*time_deadline = deadline;
+	sbi_timer_event_restore();
+}
+
+bool sbi_timer_deadline_pending(u64 *deadline)
+{
+	u64 *time_deadline = sbi_scratch_thishart_offset_ptr(time_deadline_off);
+
+	if (*time_deadline == TIME_EVENT_NONE)
+		return FALSE;
+	if (deadline)
+		*deadline = *time_deadline;
+
+	return TRUE;
+}
+
+void sbi_timer_event_restore(void)
+{
+	u64 next_event = TIME_EVENT_NONE, deadline;
+	const struct sbi_platform *plat = sbi_platform_thishart_ptr();
+
+	sbi_timer_event_pending(&next_event);
+	if (sbi_timer_deadline_pending(&deadline) && deadline < next_event)
+		next_event = deadline;
+
+	if (next_event != TIME_EVENT_NONE) {
+		sbi_platform_timer_event_start(plat, next_event);
+		csr_set(CSR_MIE, MIP_MTIP);
+	} else {
+		sbi_platform_timer_event_stop(plat);
+		csr_clear(CSR_MIE, MIP_MTIP);
+	}
 }
 
 int sbi_timer_init(struct sbi_scratch *scratch, bool cold_boot)
 {
-	u64 *time_delta;
+	u64 *time_delta, *time_event, *time_deadline;
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 	int ret;
 
@@ -102,14 +190,31 @@ int sbi_timer_init(struct sbi_scratch *scratch, bool cold_boot)
 							  "TIME_DELTA");
 		if (!time_delta_off)
 			return SBI_ENOMEM;
+
+		time_event_off = sbi_scratch_alloc_offset(sizeof(*time_event),
+							  "TIME_EVENT");
+		if (!time_event_off)
+			return SBI_ENOMEM;
+
+		time_deadline_off = sbi_scratch_alloc_offset(
+						sizeof(*time_deadline),
+						"TIME_DEADLINE");
+		if (!time_deadline_off)
+			return SBI_ENOMEM;
 	} else {
-		if (!time_delta_off)
+		if (!time_delta_off || !time_event_off || !time_deadline_off)
 			return SBI_ENOMEM;
 	}
 
 	time_delta = sbi_scratch_offset_ptr(scratch, time_delta_off);
 	*time_delta = 0;
 
+	time_event = sbi_scratch_offset_ptr(scratch, time_event_off);
+	*time_event = TIME_EVENT_NONE;
+
+	time_deadline = sbi_scratch_offset_ptr(scratch, time_deadline_off);
+	*time_deadline = TIME_EVENT_NONE;
+
 	ret = sbi_platform_timer_init(plat, cold_boot);
 	if (ret)
 		return ret;
@@ -127,6 +232,11 @@ int sbi_timer_init(struct sbi_scratch *scratch, bool cold_boot)
 
 void sbi_timer_exit(struct sbi_scratch *scratch)
 {
+	u64 *time_event = sbi_scratch_offset_ptr(scratch, time_event_off);
+	u64 *time_deadline = sbi_scratch_offset_ptr(scratch, time_deadline_off);
+
+	*time_event = TIME_EVENT_NONE;
+	*time_deadline = TIME_EVENT_NONE;
 	sbi_platform_timer_event_stop(sbi_platform_ptr(scratch));
 
 	csr_clear(CSR_MIP, MIP_STIP);
@@ -13,25 +13,81 @@
 #include <sbi/riscv_barrier.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_fifo.h>
+#include <sbi/sbi_fwtime.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_tlb.h>
+#include <sbi/sbi_trace.h>
+#include <sbi/sbi_trap.h>
 #include <sbi/sbi_hfence.h>
 #include <sbi/sbi_string.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_platform.h>
 
+/*
+ * Full flushes executed by a HART. Every full flush takes a new sequence
+ * number before it starts. A queued request which sampled an older
+ * sequence number is already covered by a later full flush of the same
+ * kind, so its local flush can be skipped.
+ */
+struct sbi_tlb_gen {
+	/* Last sequence number, read by remote HARTs at enqueue time */
+	unsigned long seq;
+	/* Sequence numbers of last full flush of each kind */
+	unsigned long vma;
+	unsigned long asid_seq;
+	unsigned long asid;
+	unsigned long gvma;
+	unsigned long vmid_seq;
+	unsigned long vmid;
+	unsigned long icache;
+};
+
 static unsigned long tlb_sync_off;
 static unsigned long tlb_fifo_off;
 static unsigned long tlb_fifo_mem_off;
+static unsigned long tlb_gen_off;
 static unsigned long tlb_range_flush_limit;
+static u32 tlb_fifo_num_entries = SBI_TLB_FIFO_NUM_ENTRIES;
+
+static inline struct sbi_tlb_gen *sbi_tlb_gen_ptr(void)
+{
+	return sbi_scratch_thishart_offset_ptr(tlb_gen_off);
+}
+
+static unsigned long sbi_tlb_gen_next(struct sbi_tlb_gen *gen)
+{
+	gen->seq++;
+
+	/* Publish the sequence number before the flush starts */
+	smp_mb();
+
+	return gen->seq;
+}
+
+/* Check whether sequence number "a" was taken after "b" */
+static inline bool sbi_tlb_gen_after(unsigned long a, unsigned long b)
+{
+	return (long)(a - b) > 0;
+}
 
 static void sbi_tlb_flush_all(void)
 {
+	struct sbi_tlb_gen *gen = sbi_tlb_gen_ptr();
+
+	gen->vma = sbi_tlb_gen_next(gen);
 	__asm__ __volatile("sfence.vma");
 }
 
+static void sbi_tlb_fence_i(void)
+{
+	struct sbi_tlb_gen *gen = sbi_tlb_gen_ptr();
+
+	gen->icache = sbi_tlb_gen_next(gen);
+	__asm__ __volatile("fence.i");
+}
+
 static void sbi_tlb_hfence_vvma(struct sbi_tlb_info *tinfo)
 {
 	unsigned long start = tinfo->start;
@@ -55,6 +111,14 @@ done:
 	csr_write(CSR_HGATP, hgatp);
 }
 
+static void sbi_tlb_hfence_gvma_all(void)
+{
+	struct sbi_tlb_gen *gen = sbi_tlb_gen_ptr();
+
+	gen->gvma = sbi_tlb_gen_next(gen);
+	__sbi_hfence_gvma_all();
+}
+
 static void sbi_tlb_hfence_gvma(struct sbi_tlb_info *tinfo)
 {
 	unsigned long start = tinfo->start;
@@ -62,7 +126,7 @@ static void sbi_tlb_hfence_gvma(struct sbi_tlb_info *tinfo)
 	unsigned long i;
 
 	if ((start == 0 && size == 0) || (size == SBI_TLB_FLUSH_ALL)) {
-		__sbi_hfence_gvma_all();
+		sbi_tlb_hfence_gvma_all();
 		return;
 	}
 
@@ -125,13 +189,17 @@ static void sbi_tlb_hfence_gvma_vmid(struct sbi_tlb_info *tinfo)
 	unsigned long size  = tinfo->size;
 	unsigned long vmid  = tinfo->vmid;
 	unsigned long i;
+	struct sbi_tlb_gen *gen;
 
 	if (start == 0 && size == 0) {
-		__sbi_hfence_gvma_all();
+		sbi_tlb_hfence_gvma_all();
 		return;
 	}
 
 	if (size == SBI_TLB_FLUSH_ALL) {
+		gen = sbi_tlb_gen_ptr();
+		gen->vmid = vmid;
+		gen->vmid_seq = sbi_tlb_gen_next(gen);
 		__sbi_hfence_gvma_vmid(vmid);
 		return;
 	}
@@ -147,6 +215,7 @@ static void sbi_tlb_sfence_vma_asid(struct sbi_tlb_info *tinfo)
 	unsigned long size  = tinfo->size;
 	unsigned long asid  = tinfo->asid;
 	unsigned long i;
+	struct sbi_tlb_gen *gen;
 
 	if (start == 0 && size == 0) {
 		sbi_tlb_flush_all();
@@ -155,6 +224,9 @@ static void sbi_tlb_sfence_vma_asid(struct sbi_tlb_info *tinfo)
 
 	/* Flush entire MM context for a given ASID */
 	if (size == SBI_TLB_FLUSH_ALL) {
+		gen = sbi_tlb_gen_ptr();
+		gen->asid = asid;
+		gen->asid_seq = sbi_tlb_gen_next(gen);
 		__asm__ __volatile__("sfence.vma x0, %0"
 				     :
 				     : "r"(asid)
@@ -192,7 +264,7 @@ static void sbi_tlb_local_flush(struct sbi_tlb_info *tinfo)
 		sbi_tlb_hfence_vvma_asid(tinfo);
 		break;
 	case SBI_ITLB_FLUSH:
-		__asm__ __volatile("fence.i");
+		sbi_tlb_fence_i();
 		break;
 	default:
 		sbi_printf("Invalid tlb flush request type [%lu]\n",
@@ -201,13 +273,48 @@ static void sbi_tlb_local_flush(struct sbi_tlb_info *tinfo)
 	return;
 }
 
+/* Check whether a full flush started after the request was queued */
+static bool sbi_tlb_entry_covered(struct sbi_tlb_info *tinfo)
+{
+	struct sbi_tlb_gen *gen = sbi_tlb_gen_ptr();
+
+	switch (tinfo->type) {
+	case SBI_TLB_FLUSH_VMA:
+		return sbi_tlb_gen_after(gen->vma, tinfo->seq);
+	case SBI_TLB_FLUSH_VMA_ASID:
+		if (sbi_tlb_gen_after(gen->vma, tinfo->seq))
+			return TRUE;
+		return (gen->asid == tinfo->asid &&
+			sbi_tlb_gen_after(gen->asid_seq, tinfo->seq));
+	case SBI_TLB_FLUSH_GVMA:
+		return sbi_tlb_gen_after(gen->gvma, tinfo->seq);
+	case SBI_TLB_FLUSH_GVMA_VMID:
+		if (sbi_tlb_gen_after(gen->gvma, tinfo->seq))
+			return TRUE;
+		return (gen->vmid == tinfo->vmid &&
+			sbi_tlb_gen_after(gen->vmid_seq, tinfo->seq));
+	case SBI_ITLB_FLUSH:
+		return sbi_tlb_gen_after(gen->icache, tinfo->seq);
+	default:
+		return FALSE;
+	}
+}
+
 static void sbi_tlb_entry_process(struct sbi_tlb_info *tinfo)
 {
 	u32 rhartid;
 	struct sbi_scratch *rscratch = NULL;
 	unsigned long *rtlb_sync = NULL;
 
-	sbi_tlb_local_flush(tinfo);
+	/* Requesters are acknowledged even if the flush is skipped */
+	if (!sbi_tlb_entry_covered(tinfo)) {
+		sbi_trace(SBI_TRACE_TLB_PROCESS, 0, tinfo->type,
+			  tinfo->start, tinfo->size);
+		sbi_tlb_local_flush(tinfo);
+	} else {
+		sbi_trace(SBI_TRACE_TLB_SKIP, 0, tinfo->type,
+			  tinfo->start, tinfo->size);
+	}
 
 	sbi_hartmask_for_each_hart(rhartid, &tinfo->smask) {
 		rscratch = sbi_hartid_to_scratch(rhartid);
@@ -247,17 +354,27 @@ static void sbi_tlb_process(struct sbi_scratch *scratch)
 
 static void sbi_tlb_sync(struct sbi_scratch *scratch)
 {
+	struct sbi_trap_nested nst;
 	unsigned long *tlb_sync =
 			sbi_scratch_offset_ptr(scratch, tlb_sync_off);
+	u32 fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_SYNC_WAIT);
+
+	/* Take own IPIs and timer interrupts while waiting */
+	sbi_trap_nested_begin(&nst);
 
 	while (!atomic_raw_xchg_ulong(tlb_sync, 0)) {
 		/*
 		 * While we are waiting for remote hart to set the sync,
-		 * consume fifo requests to avoid deadlock.
+		 * consume fifo requests to avoid deadlock. This is done
+		 * by the nested IPI handling when interrupts are enabled.
 		 */
-		sbi_tlb_process_count(scratch, 1);
+		if (!nst.enabled)
+			sbi_tlb_process_count(scratch, 1);
 	}
 
+	sbi_trap_nested_end(&nst);
+	sbi_fwtime_exit(fwtime_prev);
+
 	return;
 }
 
@@ -334,6 +451,9 @@ static int sbi_tlb_update(struct sbi_scratch *scratch,
 {
 	int ret;
 	struct sbi_fifo *tlb_fifo_r;
+	u32 fwtime_prev;
+	struct sbi_trap_nested nst;
+	struct sbi_tlb_gen *rgen;
 	struct sbi_tlb_info *tinfo = data;
 	u32 curr_hartid = current_hartid();
 
@@ -356,10 +476,21 @@ static int sbi_tlb_update(struct sbi_scratch *scratch,
 		return -1;
 	}
 
+	/*
+	 * Sample the remote flush sequence number after all prior
+	 * page table updates. Merged FIFO entries keep the older
+	 * (more conservative) sequence number.
+	 */
+	rgen = sbi_scratch_offset_ptr(remote_scratch, tlb_gen_off);
+	smp_mb();
+	tinfo->seq = *(volatile unsigned long *)&rgen->seq;
+
 	tlb_fifo_r = sbi_scratch_offset_ptr(remote_scratch, tlb_fifo_off);
 
 	ret = sbi_fifo_inplace_update(tlb_fifo_r, data, sbi_tlb_update_cb);
 	if (ret != SBI_FIFO_UNCHANGED) {
+		sbi_trace(SBI_TRACE_TLB_COALESCE, remote_hartid, tinfo->type,
+			  tinfo->start, tinfo->size);
 		return 1;
 	}
 
@@ -372,14 +503,28 @@ static int sbi_tlb_update(struct sbi_scratch *scratch,
 		 * TODO: Introduce a wait/wakeup event mechanism to handle
 		 * this properly.
 		 */
-		sbi_tlb_process_count(scratch, 1);
+		fwtime_prev = sbi_fwtime_enter(SBI_FWTIME_SYNC_WAIT);
+		sbi_trap_nested_begin(&nst);
+		if (!nst.enabled)
+			sbi_tlb_process_count(scratch, 1);
+		sbi_trap_nested_end(&nst);
+		sbi_fwtime_exit(fwtime_prev);
 		sbi_dprintf("hart%d: hart%d tlb fifo full\n",
 			    curr_hartid, remote_hartid);
 	}
 
+	sbi_trace(SBI_TRACE_TLB_ENQUEUE, remote_hartid, tinfo->type,
+		  tinfo->start, tinfo->size);
+
 	return 0;
 }
 
+/*
+ * Remote fences don't use sbi_ipi_call() because the TLB FIFO merges
+ * overlapping requests in place and skips entries covered by a later
+ * full flush using per-target sequence numbers, which a function pointer
+ * with a shared argument can't express.
+ */
 static struct sbi_ipi_event_ops tlb_ops = {
 	.name = "IPI_TLB",
 	.update = sbi_tlb_update,
@@ -394,12 +539,45 @@ int sbi_tlb_request(ulong hmask, ulong hbase, struct sbi_tlb_info *tinfo)
 	return sbi_ipi_send_many(hmask, hbase, tlb_event, tinfo);
 }
 
+unsigned long sbi_tlb_get_range_flush_limit(void)
+{
+	return tlb_range_flush_limit;
+}
+
+int sbi_tlb_set_range_flush_limit(unsigned long limit)
+{
+	if (!limit)
+		return SBI_EINVAL;
+
+	tlb_range_flush_limit = limit;
+	return 0;
+}
+
+u32 sbi_tlb_get_fifo_entries(void)
+{
+	return tlb_fifo_num_entries;
+}
+
+int sbi_tlb_set_fifo_entries(u32 entries)
+{
+	if (!entries || SBI_TLB_FIFO_MAX_ENTRIES < entries)
+		return SBI_EINVAL;
+
+	/* FIFOs are carved out of scratch space only once */
+	if (tlb_fifo_mem_off)
+		return SBI_EDENIED;
+
+	tlb_fifo_num_entries = entries;
+	return 0;
+}
+
 int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 {
 	int ret;
 	void *tlb_mem;
 	unsigned long *tlb_sync;
 	struct sbi_fifo *tlb_q;
+	struct sbi_tlb_gen *tlb_gen;
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 
 	if (cold_boot) {
@@ -414,26 +592,39 @@ int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 			return SBI_ENOMEM;
 		}
 		tlb_fifo_mem_off = sbi_scratch_alloc_offset(
-				SBI_TLB_FIFO_NUM_ENTRIES * SBI_TLB_INFO_SIZE,
+				tlb_fifo_num_entries * SBI_TLB_INFO_SIZE,
 				"IPI_TLB_FIFO_MEM");
 		if (!tlb_fifo_mem_off) {
 			sbi_scratch_free_offset(tlb_fifo_off);
 			sbi_scratch_free_offset(tlb_sync_off);
 			return SBI_ENOMEM;
 		}
+		tlb_gen_off = sbi_scratch_alloc_offset(sizeof(struct sbi_tlb_gen),
+						       "IPI_TLB_GEN");
+		if (!tlb_gen_off) {
+			sbi_scratch_free_offset(tlb_fifo_mem_off);
+			sbi_scratch_free_offset(tlb_fifo_off);
+			sbi_scratch_free_offset(tlb_sync_off);
+			return SBI_ENOMEM;
+		}
 		ret = sbi_ipi_event_create(&tlb_ops);
 		if (ret < 0) {
+			sbi_scratch_free_offset(tlb_gen_off);
 			sbi_scratch_free_offset(tlb_fifo_mem_off);
 			sbi_scratch_free_offset(tlb_fifo_off);
 			sbi_scratch_free_offset(tlb_sync_off);
 			return ret;
 		}
 		tlb_event = ret;
-		tlb_range_flush_limit = sbi_platform_tlbr_flush_limit(plat);
+		/* Keep the limit if already tuned before TLB init */
+		if (!tlb_range_flush_limit)
+			tlb_range_flush_limit =
+				sbi_platform_tlbr_flush_limit(plat);
 	} else {
 		if (!tlb_sync_off ||
 		    !tlb_fifo_off ||
-		    !tlb_fifo_mem_off)
+		    !tlb_fifo_mem_off ||
+		    !tlb_gen_off)
 			return SBI_ENOMEM;
 		if (SBI_IPI_EVENT_MAX <= tlb_event)
 			return SBI_ENOSPC;
@@ -442,11 +633,13 @@ int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 	tlb_sync = sbi_scratch_offset_ptr(scratch, tlb_sync_off);
 	tlb_q = sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
 	tlb_mem = sbi_scratch_offset_ptr(scratch, tlb_fifo_mem_off);
+	tlb_gen = sbi_scratch_offset_ptr(scratch, tlb_gen_off);
 
 	*tlb_sync = 0;
+	sbi_memset(tlb_gen, 0, sizeof(*tlb_gen));
 
 	sbi_fifo_init(tlb_q, tlb_mem,
-		      SBI_TLB_FIFO_NUM_ENTRIES, SBI_TLB_INFO_SIZE);
+		      tlb_fifo_num_entries, SBI_TLB_INFO_SIZE);
 
 	return 0;
 }
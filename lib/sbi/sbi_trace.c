@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_ring.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
+
+unsigned long sbi_trace_mask;
+
+static unsigned long trace_addr;
+static unsigned long trace_size;
+static unsigned long trace_boot_mask;
+static struct sbi_ring_buffer trace_rb;
+
+/* Trace buffer is a ring buffer with a larger header */
+_Static_assert(sizeof(struct sbi_trace_ring) == sizeof(struct sbi_ring),
+	       "struct sbi_trace_ring must match struct sbi_ring");
+
+static inline struct sbi_trace_header *trace_hdr(void)
+{
+	return (struct sbi_trace_header *)trace_rb.hdr;
+}
+
+void __sbi_trace(u32 event, u32 arg0, u32 arg1, u64 arg2, u64 arg3)
+{
+	unsigned long mstatus;
+	struct sbi_trace_record *rec;
+
+	rec = sbi_ring_buffer_begin(&trace_rb, &mstatus);
+	if (!rec)
+		return;
+
+	rec->time = sbi_timer_value();
+	rec->event = event;
+	rec->arg0 = arg0;
+	rec->arg1 = arg1;
+	rec->arg2 = arg2;
+	rec->arg3 = arg3;
+
+	sbi_ring_buffer_commit(&trace_rb, mstatus);
+}
+
+unsigned long sbi_trace_get_buffer(void)
+{
+	return (unsigned long)trace_hdr();
+}
+
+unsigned long sbi_trace_get_mask(void)
+{
+	return sbi_trace_mask;
+}
+
+int sbi_trace_set_mask(unsigned long mask)
+{
+	if (mask & ~SBI_TRACE_MASK_ALL)
+		return SBI_EINVAL;
+	if (!trace_hdr())
+		return SBI_ENOTSUPP;
+
+	trace_hdr()->mask = mask;
+	sbi_trace_mask = mask;
+
+	return 0;
+}
+
+int sbi_trace_configure(unsigned long addr, unsigned long size,
+			unsigned long mask)
+{
+	if (trace_hdr())
+		return SBI_EALREADY;
+	if (!size || (addr & 0x7) || (mask & ~SBI_TRACE_MASK_ALL))
+		return SBI_EINVAL;
+
+	trace_addr = addr;
+	trace_size = size;
+	trace_boot_mask = mask;
+
+	return 0;
+}
+
+int sbi_trace_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	int rc;
+
+	if (!cold_boot || !trace_size)
+		return 0;
+
+	rc = sbi_ring_buffer_setup(&trace_rb, scratch, trace_addr, trace_size,
+				   SBI_TRACE_RING_OFFSET,
+				   sizeof(struct sbi_trace_record),
+				   SBI_TRACE_MAGIC, SBI_TRACE_VERSION);
+	if (rc) {
+		sbi_printf("%s: invalid trace buffer 0x%lx (size 0x%lx)\n",
+			   __func__, trace_addr, trace_size);
+		return 0;
+	}
+
+	return sbi_trace_set_mask(trace_boot_mask);
+}
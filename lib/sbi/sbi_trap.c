@@ -10,25 +10,36 @@
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_encoding.h>
 #include <sbi/sbi_console.h>
+#include <sbi/sbi_domain_sched.h>
 #include <sbi/sbi_ecall.h>
 #include <sbi/sbi_error.h>
+#include <sbi/sbi_fwtime.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_illegal_insn.h>
+#include <sbi/sbi_init.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_misaligned_ldst.h>
+#include <sbi/sbi_mprof.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_sse.h>
+#include <sbi/sbi_stack.h>
 #include <sbi/sbi_timer.h>
+#include <sbi/sbi_trace.h>
 #include <sbi/sbi_trap.h>
+#include <sbi/sbi_unpriv.h>
 
 static void __noreturn sbi_trap_error(const char *msg, int rc,
 				      ulong mcause, ulong mtval, ulong mtval2,
 				      ulong mtinst, struct sbi_trap_regs *regs)
 {
 	u32 hartid = current_hartid();
+	unsigned long stack_used;
 
 	sbi_printf("%s: hart%d: %s (error %d)\n", __func__, hartid, msg, rc);
 	sbi_printf("%s: hart%d: mcause=0x%" PRILX " mtval=0x%" PRILX "\n",
 		   __func__, hartid, mcause, mtval);
-	if (misa_extension('H')) {
+	if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				   SBI_HART_EXT_MISA('H'))) {
 		sbi_printf("%s: hart%d: mtval2=0x%" PRILX
 			   " mtinst=0x%" PRILX "\n",
 			   __func__, hartid, mtval2, mtinst);
@@ -67,10 +78,147 @@ static void __noreturn sbi_trap_error(const char *msg, int rc,
 		   hartid, "t4", regs->t4, "t5", regs->t5);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX "\n", __func__, hartid, "t6",
 		   regs->t6);
+	if (!sbi_stack_usage(sbi_scratch_thishart_ptr(), &stack_used))
+		sbi_printf("%s: hart%d: stack used %lu of %lu bytes\n",
+			   __func__, hartid, stack_used,
+			   sbi_stack_size(sbi_scratch_thishart_ptr()));
 
 	sbi_hart_hang();
 }
 
+/**
+ * Allow M-mode software and timer interrupts during a long wait
+ *
+ * The interrupts are taken as nested traps on the current M-mode stack.
+ * The caller must not hold any lock which the IPI or timer handling can
+ * take (console, TLB FIFO, etc) until sbi_trap_nested_end() is called.
+ *
+ * Interrupts are not enabled on a HART which is still initializing or
+ * which is already handling a trap taken from M-mode, so callers must
+ * keep their polling fallback for !nst->enabled. The counter overflow
+ * interrupt used by the M-mode profiler is left enabled as well.
+ *
+ * @param nst state to be passed to sbi_trap_nested_end()
+ */
+void sbi_trap_nested_begin(struct sbi_trap_nested *nst)
+{
+	nst->enabled = FALSE;
+
+	/* MPP is M-mode inside a trap taken from M-mode */
+	nst->mstatus = csr_read(CSR_MSTATUS);
+	if (((nst->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) == PRV_M)
+		return;
+	if (!sbi_init_count(current_hartid()))
+		return;
+
+	/* A nested trap clobbers MEPC, MPP and MPV of the outer trap */
+	nst->mepc = csr_read(CSR_MEPC);
+#if __riscv_xlen == 32
+	if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				   SBI_HART_EXT_MISA('H')))
+		nst->mstatusH = csr_read(CSR_MSTATUSH);
+#endif
+
+	nst->mie = csr_read_clear(CSR_MIE,
+				  ~(MIP_MSIP | MIP_MTIP | MIP_LCOFIP));
+	nst->mie &= ~(MIP_MSIP | MIP_MTIP | MIP_LCOFIP);
+	nst->enabled = TRUE;
+	csr_set(CSR_MSTATUS, MSTATUS_MIE);
+}
+
+/**
+ * Disable M-mode interrupts enabled by sbi_trap_nested_begin()
+ *
+ * @param nst state saved by sbi_trap_nested_begin()
+ */
+void sbi_trap_nested_end(struct sbi_trap_nested *nst)
+{
+	if (!nst->enabled)
+		return;
+
+	csr_clear(CSR_MSTATUS, MSTATUS_MIE);
+
+	/* MTIE might have been cleared by the nested timer handling */
+	csr_set(CSR_MIE, nst->mie);
+	csr_write(CSR_MEPC, nst->mepc);
+	csr_write(CSR_MSTATUS, nst->mstatus);
+#if __riscv_xlen == 32
+	if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				   SBI_HART_EXT_MISA('H')))
+		csr_write(CSR_MSTATUSH, nst->mstatusH);
+#endif
+	nst->enabled = FALSE;
+}
+
+/**
+ * Switch context of lower privledge mode to HS-mode (or S-mode) as if a
+ * trap was taken by HS-mode (or S-mode)
+ *
+ * The MSTATUS, MSTATUSH and HSTATUS bits are updated for the transition
+ * whereas the SEPC, SCAUSE and STVAL CSRs are left to the caller.
+ *
+ * @param regs pointer to register state
+ * @param target address where HS-mode (or S-mode) starts executing
+ *
+ * @return 0 on success and negative error code on failure
+ */
+int sbi_trap_enter_smode(struct sbi_trap_regs *regs, unsigned long target)
+{
+	ulong hstatus, prev_mode;
+#if __riscv_xlen == 32
+	bool prev_virt = (regs->mstatusH & MSTATUSH_MPV) ? TRUE : FALSE;
+#else
+	bool prev_virt = (regs->mstatus & MSTATUS_MPV) ? TRUE : FALSE;
+#endif
+	bool has_h = sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+					    SBI_HART_EXT_MISA('H'));
+
+	/* Sanity check on previous mode */
+	prev_mode = (regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
+	if (prev_mode != PRV_S && prev_mode != PRV_U)
+		return SBI_ENOTSUPP;
+
+	/* Clear MSTATUS MPV bits */
+#if __riscv_xlen == 32
+	regs->mstatusH &= ~MSTATUSH_MPV;
+#else
+	regs->mstatus &= ~MSTATUS_MPV;
+#endif
+
+	/* Update HSTATUS for VS/VU-mode to HS-mode transition */
+	if (has_h && prev_virt) {
+		/* Update HSTATUS SPVP and SPV bits */
+		hstatus = csr_read(CSR_HSTATUS);
+		hstatus &= ~HSTATUS_SPVP;
+		hstatus |= (prev_mode == PRV_S) ? HSTATUS_SPVP : 0;
+		hstatus &= ~HSTATUS_SPV;
+		hstatus |= (prev_virt) ? HSTATUS_SPV : 0;
+		csr_write(CSR_HSTATUS, hstatus);
+	}
+
+	/* Set MEPC to target address */
+	regs->mepc = target;
+
+	/* Set MPP to S-mode */
+	regs->mstatus &= ~MSTATUS_MPP;
+	regs->mstatus |= (PRV_S << MSTATUS_MPP_SHIFT);
+
+	/* Set SPP for S-mode */
+	regs->mstatus &= ~MSTATUS_SPP;
+	if (prev_mode == PRV_S)
+		regs->mstatus |= (1UL << MSTATUS_SPP_SHIFT);
+
+	/* Set SPIE for S-mode */
+	regs->mstatus &= ~MSTATUS_SPIE;
+	if (regs->mstatus & MSTATUS_SIE)
+		regs->mstatus |= (1UL << MSTATUS_SPIE_SHIFT);
+
+	/* Clear SIE for S-mode */
+	regs->mstatus &= ~MSTATUS_SIE;
+
+	return 0;
+}
+
 /**
  * Redirect trap to lower privledge mode (S-mode or U-mode)
  *
@@ -82,7 +230,7 @@ static void __noreturn sbi_trap_error(const char *msg, int rc,
 int sbi_trap_redirect(struct sbi_trap_regs *regs,
 		      struct sbi_trap_info *trap)
 {
-	ulong hstatus, vsstatus, prev_mode;
+	ulong vsstatus, prev_mode;
 #if __riscv_xlen == 32
 	bool prev_virt = (regs->mstatusH & MSTATUSH_MPV) ? TRUE : FALSE;
 #else
@@ -90,6 +238,8 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 #endif
 	/* By default, we redirect to HS-mode */
 	bool next_virt = FALSE;
+	bool has_h = sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+					    SBI_HART_EXT_MISA('H'));
 
 	/* Sanity check on previous mode */
 	prev_mode = (regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
@@ -97,7 +247,7 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 		return SBI_ENOTSUPP;
 
 	/* For certain exceptions from VS/VU-mode we redirect to VS-mode */
-	if (misa_extension('H') && prev_virt) {
+	if (has_h && prev_virt) {
 		switch (trap->cause) {
 		case CAUSE_FETCH_PAGE_FAULT:
 		case CAUSE_LOAD_PAGE_FAULT:
@@ -109,28 +259,6 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 		};
 	}
 
-	/* Update MSTATUS MPV bits */
-#if __riscv_xlen == 32
-	regs->mstatusH &= ~MSTATUSH_MPV;
-	regs->mstatusH |= (next_virt) ? MSTATUSH_MPV : 0UL;
-#else
-	regs->mstatus &= ~MSTATUS_MPV;
-	regs->mstatus |= (next_virt) ? MSTATUS_MPV : 0UL;
-#endif
-
-	/* Update HSTATUS for VS/VU-mode to HS-mode transition */
-	if (misa_extension('H') && prev_virt && !next_virt) {
-		/* Update HSTATUS SPVP and SPV bits */
-		hstatus = csr_read(CSR_HSTATUS);
-		hstatus &= ~HSTATUS_SPVP;
-		hstatus |= (prev_mode == PRV_S) ? HSTATUS_SPVP : 0;
-		hstatus &= ~HSTATUS_SPV;
-		hstatus |= (prev_virt) ? HSTATUS_SPV : 0;
-		csr_write(CSR_HSTATUS, hstatus);
-		csr_write(CSR_HTVAL, trap->tval2);
-		csr_write(CSR_HTINST, trap->tinst);
-	}
-
 	/* Update exception related CSRs */
 	if (next_virt) {
 		/* Update VS-mode exception info */
@@ -164,30 +292,19 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 		/* Update VS-mode SSTATUS CSR */
 		csr_write(CSR_VSSTATUS, vsstatus);
 	} else {
+		/* Update hypervisor exception info */
+		if (has_h && prev_virt) {
+			csr_write(CSR_HTVAL, trap->tval2);
+			csr_write(CSR_HTINST, trap->tinst);
+		}
+
 		/* Update S-mode exception info */
 		csr_write(CSR_STVAL, trap->tval);
 		csr_write(CSR_SEPC, trap->epc);
 		csr_write(CSR_SCAUSE, trap->cause);
 
-		/* Set MEPC to S-mode exception vector base */
-		regs->mepc = csr_read(CSR_STVEC);
-
-		/* Set MPP to S-mode */
-		regs->mstatus &= ~MSTATUS_MPP;
-		regs->mstatus |= (PRV_S << MSTATUS_MPP_SHIFT);
-
-		/* Set SPP for S-mode */
-		regs->mstatus &= ~MSTATUS_SPP;
-		if (prev_mode == PRV_S)
-			regs->mstatus |= (1UL << MSTATUS_SPP_SHIFT);
-
-		/* Set SPIE for S-mode */
-		regs->mstatus &= ~MSTATUS_SPIE;
-		if (regs->mstatus & MSTATUS_SIE)
-			regs->mstatus |= (1UL << MSTATUS_SPIE_SHIFT);
-
-		/* Clear SIE for S-mode */
-		regs->mstatus &= ~MSTATUS_SIE;
+		/* Continue at S-mode exception vector base */
+		return sbi_trap_enter_smode(regs, csr_read(CSR_STVEC));
 	}
 
 	return 0;
@@ -215,9 +332,15 @@ void sbi_trap_handler(struct sbi_trap_regs *regs)
 	const char *msg = "trap handler failed";
 	ulong mcause = csr_read(CSR_MCAUSE);
 	ulong mtval = csr_read(CSR_MTVAL), mtval2 = 0, mtinst = 0;
+	u32 fwtime_prev = sbi_fwtime_enter(sbi_fwtime_trap_category(mcause));
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 	struct sbi_trap_info trap;
 
-	if (misa_extension('H')) {
+	sbi_trace(SBI_TRACE_TRAP_ENTRY, 0,
+		  (regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT,
+		  mcause, regs->mepc);
+
+	if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H'))) {
 		mtval2 = csr_read(CSR_MTVAL2);
 		mtinst = csr_read(CSR_MTINST);
 	}
@@ -226,23 +349,43 @@ void sbi_trap_handler(struct sbi_trap_regs *regs)
 		mcause &= ~(1UL << (__riscv_xlen - 1));
 		switch (mcause) {
 		case IRQ_M_TIMER:
+			if (sbi_mprof_timer_process(regs))
+				break;
 			sbi_timer_process();
+			sbi_ipi_process_pending();
 			break;
 		case IRQ_M_SOFT:
 			sbi_ipi_process();
 			break;
+		case IRQ_PMU_OVF:
+			if (sbi_mprof_overflow_process(regs))
+				break;
+			if (sbi_sse_overflow_process())
+				break;
+			msg = "unhandled counter overflow interrupt";
+			goto trap_error;
 		default:
 			msg = "unhandled external interrupt";
 			goto trap_error;
 		};
-		return;
+		goto trap_done;
 	}
 
+	sbi_mprof_window_begin(regs);
+
+	/* Interrupts don't access memory of the trapped context */
+	sbi_unpriv_trap_enter(scratch);
+
+	sbi_ipi_process_pending();
+
 	switch (mcause) {
+#ifdef CONFIG_SBI_EMULATE_ILLEGAL_INSN
 	case CAUSE_ILLEGAL_INSTRUCTION:
 		rc  = sbi_illegal_insn_handler(mtval, regs);
 		msg = "illegal instruction handler failed";
 		break;
+#endif
+#ifdef CONFIG_SBI_EMULATE_MISALIGNED
 	case CAUSE_MISALIGNED_LOAD:
 		rc = sbi_misaligned_load_handler(mtval, mtval2, mtinst, regs);
 		msg = "misaligned load handler failed";
@@ -251,6 +394,7 @@ void sbi_trap_handler(struct sbi_trap_regs *regs)
 		rc  = sbi_misaligned_store_handler(mtval, mtval2, mtinst, regs);
 		msg = "misaligned store handler failed";
 		break;
+#endif
 	case CAUSE_SUPERVISOR_ECALL:
 	case CAUSE_MACHINE_ECALL:
 		rc  = sbi_ecall_handler(regs);
@@ -270,4 +414,14 @@ void sbi_trap_handler(struct sbi_trap_regs *regs)
 trap_error:
 	if (rc)
 		sbi_trap_error(msg, rc, mcause, mtval, mtval2, mtinst, regs);
+
+	sbi_ipi_process_pending();
+
+	sbi_mprof_window_end();
+
+trap_done:
+	sbi_sse_trap_exit(regs);
+	sbi_domain_sched_trap_exit(regs);
+	sbi_trace(SBI_TRACE_TRAP_EXIT, 0, 0, 0, regs->mepc);
+	sbi_fwtime_exit(fwtime_prev);
 }
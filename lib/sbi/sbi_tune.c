@@ -0,0 +1,203 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hartmask.h>
+#include <sbi/sbi_misaligned_ldst.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_tlb.h>
+#include <sbi/sbi_tune.h>
+#include <sbi/sbi_unpriv.h>
+
+struct sbi_tune_param {
+	/** Name of the parameter (also the DT property name) */
+	const char *name;
+	/** Minimum valid value */
+	unsigned long min;
+	/** Maximum valid value */
+	unsigned long max;
+	/** Get current value */
+	unsigned long (*get)(void);
+	/** Set new value (already checked against min and max) */
+	int (*set)(unsigned long val);
+};
+
+static unsigned long tune_tlb_fifo_entries_get(void)
+{
+	return sbi_tlb_get_fifo_entries();
+}
+
+static int tune_tlb_fifo_entries_set(unsigned long val)
+{
+	return sbi_tlb_set_fifo_entries(val);
+}
+
+static unsigned long tune_console_mode_get(void)
+{
+	return sbi_console_get_mode();
+}
+
+static int tune_console_mode_set(unsigned long val)
+{
+	return sbi_console_set_mode(val);
+}
+
+#ifdef CONFIG_SBI_EMULATE_MISALIGNED
+static unsigned long tune_misaligned_emulation_get(void)
+{
+	return sbi_misaligned_get_emulate() ? 1 : 0;
+}
+
+static int tune_misaligned_emulation_set(unsigned long val)
+{
+	sbi_misaligned_set_emulate(val ? TRUE : FALSE);
+	return 0;
+}
+#endif
+
+static unsigned long tune_debug_prints_get(void)
+{
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+
+	return (scratch->options & SBI_SCRATCH_DEBUG_PRINTS) ? 1 : 0;
+}
+
+static int tune_debug_prints_set(unsigned long val)
+{
+	u32 i;
+	struct sbi_scratch *scratch;
+
+	for (i = 0; i < SBI_HARTMASK_MAX_BITS; i++) {
+		scratch = sbi_hartid_to_scratch(i);
+		if (!scratch)
+			continue;
+		if (val)
+			scratch->options |= SBI_SCRATCH_DEBUG_PRINTS;
+		else
+			scratch->options &= ~SBI_SCRATCH_DEBUG_PRINTS;
+	}
+
+	return 0;
+}
+
+static unsigned long tune_unpriv_direct_access_get(void)
+{
+	return sbi_unpriv_get_direct() ? 1 : 0;
+}
+
+static int tune_unpriv_direct_access_set(unsigned long val)
+{
+	sbi_unpriv_set_direct(val ? TRUE : FALSE);
+	return 0;
+}
+
+static const struct sbi_tune_param tune_params[SBI_TUNE_PARAM_MAX] = {
+	[SBI_TUNE_TLB_RANGE_FLUSH_LIMIT] = {
+		.name = "tlb-range-flush-limit",
+		.min = PAGE_SIZE,
+		.max = -1UL,
+		.get = sbi_tlb_get_range_flush_limit,
+		.set = sbi_tlb_set_range_flush_limit,
+	},
+	[SBI_TUNE_TLB_FIFO_ENTRIES] = {
+		.name = "tlb-fifo-entries",
+		.min = 1,
+		.max = SBI_TLB_FIFO_MAX_ENTRIES,
+		.get = tune_tlb_fifo_entries_get,
+		.set = tune_tlb_fifo_entries_set,
+	},
+	[SBI_TUNE_CONSOLE_MODE] = {
+		.name = "console-mode",
+		.min = SBI_CONSOLE_MODE_BUFFERED,
+		.max = SBI_CONSOLE_MODE_MAX - 1,
+		.get = tune_console_mode_get,
+		.set = tune_console_mode_set,
+	},
+	[SBI_TUNE_MISALIGNED_EMULATION] = {
+		.name = "misaligned-emulation",
+		.min = 0,
+		.max = 1,
+#ifdef CONFIG_SBI_EMULATE_MISALIGNED
+		.get = tune_misaligned_emulation_get,
+		.set = tune_misaligned_emulation_set,
+#endif
+	},
+	[SBI_TUNE_DEBUG_PRINTS] = {
+		.name = "debug-prints",
+		.min = 0,
+		.max = 1,
+		.get = tune_debug_prints_get,
+		.set = tune_debug_prints_set,
+	},
+	[SBI_TUNE_UNPRIV_DIRECT_ACCESS] = {
+		.name = "unpriv-direct-access",
+		.min = 0,
+		.max = 1,
+		.get = tune_unpriv_direct_access_get,
+		.set = tune_unpriv_direct_access_set,
+	},
+};
+
+int sbi_tune_find(const char *name)
+{
+	u32 i;
+
+	for (i = 0; i < SBI_TUNE_PARAM_MAX; i++) {
+		if (!sbi_strcmp(tune_params[i].name, name))
+			return i;
+	}
+
+	return SBI_ENOENT;
+}
+
+const char *sbi_tune_name(u32 id)
+{
+	if (SBI_TUNE_PARAM_MAX <= id)
+		return NULL;
+
+	return tune_params[id].name;
+}
+
+int sbi_tune_get(u32 id, unsigned long *out_val)
+{
+	if (SBI_TUNE_PARAM_MAX <= id || !out_val)
+		return SBI_EINVAL;
+	if (!tune_params[id].get)
+		return SBI_ENOTSUPP;
+
+	*out_val = tune_params[id].get();
+	return 0;
+}
+
+int sbi_tune_get_range(u32 id, unsigned long *out_min, unsigned long *out_max)
+{
+	if (SBI_TUNE_PARAM_MAX <= id)
+		return SBI_EINVAL;
+	if (!tune_params[id].get)
+		return SBI_ENOTSUPP;
+
+	if (out_min)
+		*out_min = tune_params[id].min;
+	if (out_max)
+		*out_max = tune_params[id].max;
+	return 0;
+}
+
+int sbi_tune_set(u32 id, unsigned long val)
+{
+	const struct sbi_tune_param *param;
+
+	if (SBI_TUNE_PARAM_MAX <= id)
+		return SBI_EINVAL;
+	param = &tune_params[id];
+	if (!param->set)
+		return SBI_ENOTSUPP;
+	if (val < param->min || param->max < val)
+		return SBI_EINVAL;
+
+	return param->set(val);
+}
@@ -7,26 +7,161 @@
  *   Anup Patel <anup.patel@wdc.com>
  */
 
+#include <sbi/riscv_asm.h>
 #include <sbi/riscv_encoding.h>
 #include <sbi/sbi_bitops.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_trap.h>
 #include <sbi/sbi_unpriv.h>
 
+/** Translation state of the context which trapped to M-mode */
+struct unpriv_xlate {
+	/** Fields below describe the current trap */
+	bool valid;
+	/** Trapped context uses physical addresses (no MPRV needed) */
+	bool bare;
+	/** Privilege mode of the trapped context */
+	unsigned long mode;
+};
+
+static unsigned long unpriv_xlate_off;
+static bool unpriv_direct = TRUE;
+
+bool sbi_unpriv_get_direct(void)
+{
+	return unpriv_direct;
+}
+
+void sbi_unpriv_set_direct(bool direct)
+{
+	unpriv_direct = direct;
+}
+
+void sbi_unpriv_trap_enter(struct sbi_scratch *scratch)
+{
+	struct unpriv_xlate *ux;
+
+	if (!unpriv_xlate_off)
+		return;
+
+	ux = sbi_scratch_offset_ptr(scratch, unpriv_xlate_off);
+	ux->valid = FALSE;
+}
+
+static void unpriv_xlate_update(struct sbi_scratch *scratch,
+				struct unpriv_xlate *ux)
+{
+	bool virt;
+	ulong mstatus = csr_read(CSR_MSTATUS);
+	bool has_h = sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('H'));
+
+	ux->mode = (mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT;
+#if __riscv_xlen == 32
+	virt = (has_h && (csr_read(CSR_MSTATUSH) & MSTATUSH_MPV)) ?
+		TRUE : FALSE;
+#else
+	virt = (has_h && (mstatus & MSTATUS_MPV)) ? TRUE : FALSE;
+#endif
+
+	/*
+	 * MPRV is a no-op for M-mode and such accesses are rare so
+	 * keep them on the MPRV path instead of special casing them.
+	 */
+	if (ux->mode == PRV_M)
+		ux->bare = FALSE;
+	else if (virt)
+		ux->bare = (!(csr_read(CSR_VSATP) & SATP_MODE) &&
+			    !(csr_read(CSR_HGATP) >> HGATP_MODE_SHIFT)) ?
+			   TRUE : FALSE;
+	else if (sbi_hart_has_extension(scratch, SBI_HART_EXT_MISA('S')))
+		ux->bare = (csr_read(CSR_SATP) & SATP_MODE) ? FALSE : TRUE;
+	else
+		ux->bare = TRUE;
+
+	ux->valid = TRUE;
+}
+
+/**
+ * Check whether an access of the trapped context can be done directly
+ *
+ * With translation off, addresses of the trapped context are physical
+ * addresses so a plain M-mode access is equivalent to an MPRV access
+ * once the domain allows it. The first and the last byte are checked
+ * because domain regions are at least 8 bytes in size and aligned.
+ * Anything else (including MMIO regions) takes the MPRV path so that
+ * PMP remains the final authority.
+ */
+static bool unpriv_direct_allowed(ulong addr, ulong len, ulong access)
+{
+	struct sbi_scratch *scratch;
+	struct unpriv_xlate *ux;
+	const struct sbi_domain *dom;
+
+	if (!unpriv_direct || !unpriv_xlate_off)
+		return FALSE;
+
+	scratch = sbi_scratch_thishart_ptr();
+	ux = sbi_scratch_offset_ptr(scratch, unpriv_xlate_off);
+	if (!ux->valid)
+		unpriv_xlate_update(scratch, ux);
+	if (!ux->bare)
+		return FALSE;
+
+	dom = sbi_domain_thishart_ptr();
+	if (!sbi_domain_check_addr(dom, addr, ux->mode, access))
+		return FALSE;
+	if (1 < len &&
+	    !sbi_domain_check_addr(dom, addr + len - 1, ux->mode, access))
+		return FALSE;
+
+	return TRUE;
+}
+
 /**
  * a3 must a pointer to the sbi_trap_info and a4 is used as a temporary
  * register in the trap handler. Make sure that compiler doesn't use a3 & a4.
+ * M-mode interrupts (enabled by the M-mode profiler) are disabled while
+ * MTVEC points to the expected trap handler.
  */
 #define DEFINE_UNPRIVILEGED_LOAD_FUNCTION(type, insn)                         \
+	static type direct_load_##type(const type *addr,                      \
+				       struct sbi_trap_info *trap)            \
+	{                                                                     \
+		register ulong tinfo asm("a3");                               \
+		register ulong mtvec = sbi_hart_expected_trap_addr();         \
+		ulong mie = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);         \
+		type ret = 0;                                                 \
+		asm volatile(                                                 \
+			"add %[tinfo], %[taddr], zero\n"                      \
+			"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"      \
+			".option push\n"                                      \
+			".option norvc\n"                                     \
+			#insn " %[ret], %[addr]\n"                            \
+			".option pop\n"                                       \
+			"csrw " STR(CSR_MTVEC) ", %[mtvec]"                   \
+		    : [mtvec] "+&r"(mtvec), [tinfo] "+&r"(tinfo),             \
+		      [ret] "=&r"(ret)                                        \
+		    : [addr] "m"(*addr), [taddr] "r"((ulong)trap)             \
+		    : "a4", "memory");                                        \
+		csr_set(CSR_MSTATUS, mie & MSTATUS_MIE);                      \
+		return ret;                                                   \
+	}                                                                     \
 	type sbi_load_##type(const type *addr,                                \
 			     struct sbi_trap_info *trap)                      \
 	{                                                                     \
 		register ulong tinfo asm("a3");                               \
 		register ulong mstatus = 0;                                   \
 		register ulong mtvec = sbi_hart_expected_trap_addr();         \
+		ulong mie;                                                    \
 		type ret = 0;                                                 \
 		trap->cause = 0;                                              \
+		if (unpriv_direct_allowed((ulong)addr, sizeof(type),          \
+					  SBI_DOMAIN_READ))                   \
+			return direct_load_##type(addr, trap);                \
+		mie = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);               \
 		asm volatile(                                                 \
 			"add %[tinfo], %[taddr], zero\n"                      \
 			"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"      \
@@ -42,17 +177,45 @@
 		    : [addr] "m"(*addr), [mprv] "r"(MSTATUS_MPRV),            \
 		      [taddr] "r"((ulong)trap)                                \
 		    : "a4", "memory");                                        \
+		csr_set(CSR_MSTATUS, mie & MSTATUS_MIE);                      \
 		return ret;                                                   \
 	}
 
 #define DEFINE_UNPRIVILEGED_STORE_FUNCTION(type, insn)                        \
+	static void direct_store_##type(type *addr, type val,                 \
+					struct sbi_trap_info *trap)           \
+	{                                                                     \
+		register ulong tinfo asm("a3") = (ulong)trap;                 \
+		register ulong mtvec = sbi_hart_expected_trap_addr();         \
+		ulong mie = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);         \
+		asm volatile(                                                 \
+			"add %[tinfo], %[taddr], zero\n"                      \
+			"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"      \
+			".option push\n"                                      \
+			".option norvc\n"                                     \
+			#insn " %[val], %[addr]\n"                            \
+			".option pop\n"                                       \
+			"csrw " STR(CSR_MTVEC) ", %[mtvec]"                   \
+		    : [mtvec] "+&r"(mtvec), [tinfo] "+&r"(tinfo)              \
+		    : [addr] "m"(*addr), [val] "r"(val),                      \
+		      [taddr] "r"((ulong)trap)                                \
+		    : "a4", "memory");                                        \
+		csr_set(CSR_MSTATUS, mie & MSTATUS_MIE);                      \
+	}                                                                     \
 	void sbi_store_##type(type *addr, type val,                           \
 			      struct sbi_trap_info *trap)                     \
 	{                                                                     \
 		register ulong tinfo asm("a3") = (ulong)trap;                 \
 		register ulong mstatus = 0;                                   \
 		register ulong mtvec = sbi_hart_expected_trap_addr();         \
+		ulong mie;                                                    \
 		trap->cause = 0;                                              \
+		if (unpriv_direct_allowed((ulong)addr, sizeof(type),          \
+					  SBI_DOMAIN_WRITE)) {                \
+			direct_store_##type(addr, val, trap);                 \
+			return;                                               \
+		}                                                             \
+		mie = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);               \
 		asm volatile(                                                 \
 			"add %[tinfo], %[taddr], zero\n"                      \
 			"csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"      \
@@ -68,6 +231,7 @@
 		    : [addr] "m"(*addr), [mprv] "r"(MSTATUS_MPRV),            \
 		      [val] "r"(val), [taddr] "r"((ulong)trap)                \
 		    : "a4", "memory");                                        \
+		csr_set(CSR_MSTATUS, mie & MSTATUS_MIE);                      \
 	}
 
 DEFINE_UNPRIVILEGED_LOAD_FUNCTION(u8, lbu)
@@ -120,10 +284,22 @@ ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
 	register ulong ttmp asm("a4");
 	register ulong mstatus = 0;
 	register ulong mtvec = sbi_hart_expected_trap_addr();
-	ulong insn = 0;
+	ulong mie, insn = 0;
 
 	trap->cause = 0;
 
+	/* Instruction fetch sees physical addresses with translation off */
+	if (unpriv_direct_allowed(mepc, 4, SBI_DOMAIN_EXECUTE)) {
+		insn = direct_load_u16((const u16 *)mepc, trap);
+		if (!trap->cause && (insn & 3) == 3)
+			insn |= (ulong)direct_load_u16((const u16 *)mepc + 1,
+						       trap) << 16;
+		goto done;
+	}
+
+	/* Interrupts must not be taken while MTVEC is swapped */
+	mie = csr_read_clear(CSR_MSTATUS, MSTATUS_MIE);
+
 	asm volatile(
 	    "add %[tinfo], %[taddr], zero\n"
 	    "csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
@@ -144,6 +320,9 @@ ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
 	      [taddr] "r"((ulong)trap), [addr] "r"(mepc)
 	    : "memory");
 
+	csr_set(CSR_MSTATUS, mie & MSTATUS_MIE);
+
+done:
 	switch (trap->cause) {
 	case CAUSE_LOAD_ACCESS:
 		trap->cause = CAUSE_FETCH_ACCESS;
@@ -163,3 +342,23 @@ ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
 
 	return insn;
 }
+
+int sbi_unpriv_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct unpriv_xlate *ux;
+
+	if (cold_boot) {
+		unpriv_xlate_off = sbi_scratch_alloc_offset(sizeof(*ux),
+							    "UNPRIV");
+		if (!unpriv_xlate_off)
+			return SBI_ENOMEM;
+	} else {
+		if (!unpriv_xlate_off)
+			return SBI_ENOMEM;
+	}
+
+	ux = sbi_scratch_offset_ptr(scratch, unpriv_xlate_off);
+	ux->valid = FALSE;
+
+	return 0;
+}
@@ -0,0 +1,28 @@
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+
+# Build time configuration of libsbiutils
+#
+# Every option defaults to "y" and can be set to "n" either in the
+# platform config.mk or on the make command line. Disabled drivers
+# are left out of the FDT based driver probing.
+
+# FDT IPI drivers
+CONFIG_FDT_IPI_CLINT ?= y
+
+# FDT irqchip drivers
+CONFIG_FDT_IRQCHIP_PLIC ?= y
+
+# FDT reset drivers
+CONFIG_FDT_RESET_HTIF ?= y
+CONFIG_FDT_RESET_SIFIVE ?= y
+
+# FDT serial drivers
+CONFIG_FDT_SERIAL_HTIF ?= y
+CONFIG_FDT_SERIAL_SHAKTI ?= y
+CONFIG_FDT_SERIAL_SIFIVE ?= y
+CONFIG_FDT_SERIAL_UART8250 ?= y
+
+# FDT timer drivers
+CONFIG_FDT_TIMER_CLINT ?= y
@@ -13,6 +13,7 @@
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_hartmask.h>
 #include <sbi/sbi_scratch.h>
+#include <sbi/sbi_shpage.h>
 #include <sbi_utils/fdt/fdt_domain.h>
 #include <sbi_utils/fdt/fdt_helper.h>
 
@@ -42,6 +43,32 @@ void fdt_iterate_each_domain(void *fdt, void *opaque,
 	}
 }
 
+void fdt_iterate_each_channel(void *fdt, void *opaque,
+			      void (*fn)(void *fdt, int channel_offset,
+					 void *opaque))
+{
+	int coffset, poffset;
+
+	if (!fdt || !fn)
+		return;
+
+	poffset = fdt_path_offset(fdt, "/chosen");
+	if (poffset < 0)
+		return;
+	poffset = fdt_node_offset_by_compatible(fdt, poffset,
+						"opensbi,domain,config");
+	if (poffset < 0)
+		return;
+
+	fdt_for_each_subnode(coffset, fdt, poffset) {
+		if (fdt_node_check_compatible(fdt, coffset,
+					      "opensbi,domain,channel"))
+			continue;
+
+		fn(fdt, coffset, opaque);
+	}
+}
+
 void fdt_iterate_each_memregion(void *fdt, int domain_offset, void *opaque,
 				void (*fn)(void *fdt, int domain_offset,
 					   int region_offset, u32 region_access,
@@ -211,9 +238,13 @@ static struct sbi_domain *fdt_hartid_to_domain[SBI_HARTMASK_MAX_BITS];
 static u32 fdt_domains_count;
 static struct sbi_domain fdt_domains[FDT_DOMAIN_MAX_COUNT];
 static struct sbi_hartmask fdt_masks[FDT_DOMAIN_MAX_COUNT];
+static struct sbi_hartmask fdt_shared_masks[FDT_DOMAIN_MAX_COUNT];
 static struct sbi_domain_memregion
 	fdt_regions[FDT_DOMAIN_MAX_COUNT][FDT_DOMAIN_REGION_MAX_COUNT + 2];
 
+static u32 fdt_channels_count;
+static struct sbi_domain_channel fdt_channels[SBI_DOMAIN_MAX_CHANNELS];
+
 struct sbi_domain *fdt_domain_get(u32 hartid)
 {
 	if (SBI_HARTMASK_MAX_BITS <= hartid)
@@ -268,8 +299,9 @@ static void __fdt_parse_domain(void *fdt, int domain_offset, void *opaque)
 	u64 val64;
 	const u32 *val;
 	struct sbi_domain *dom;
-	struct sbi_hartmask *mask;
-	int i, err, len, cpu_offset;
+	struct sbi_hartmask *mask, *shared_mask;
+	int i, err, len, cpus_offset, cpu_offset, page_offset;
+	unsigned long page_addr, page_size;
 	int *cold_domain_offset = opaque;
 	struct sbi_domain_memregion *regions;
 
@@ -278,6 +310,7 @@ static void __fdt_parse_domain(void *fdt, int domain_offset, void *opaque)
 		return;
 	dom = &fdt_domains[fdt_domains_count];
 	mask = &fdt_masks[fdt_domains_count];
+	shared_mask = &fdt_shared_masks[fdt_domains_count];
 	regions = &fdt_regions[fdt_domains_count][0];
 
 	/* Read DT node name */
@@ -372,15 +405,144 @@ static void __fdt_parse_domain(void *fdt, int domain_offset, void *opaque)
 	else
 		dom->system_reset_allowed = FALSE;
 
+	/* Read "shared-page" DT property */
+	dom->shared_page = 0;
+	val = fdt_getprop(fdt, domain_offset, "shared-page", &len);
+	if (val && len >= 4) {
+		page_offset = fdt_node_offset_by_phandle(fdt,
+							 fdt32_to_cpu(*val));
+		if (page_offset >= 0 &&
+		    !fdt_get_node_addr_size(fdt, page_offset,
+					    &page_addr, &page_size) &&
+		    SBI_SHPAGE_SIZE <= page_size)
+			dom->shared_page = page_addr;
+	}
+
+	/* Read "shared-harts" DT property */
+	dom->shared_harts = NULL;
+	val = fdt_getprop(fdt, domain_offset, "shared-harts", &len);
+	len = len / sizeof(u32);
+	if (val && len) {
+		SBI_HARTMASK_INIT(shared_mask);
+		for (i = 0; i < len; i++) {
+			cpu_offset = fdt_node_offset_by_phandle(fdt,
+							fdt32_to_cpu(val[i]));
+			if (cpu_offset < 0)
+				continue;
+
+			err = fdt_parse_hart_id(fdt, cpu_offset, &val32);
+			if (err)
+				continue;
+
+			sbi_hartmask_set_hart(val32, shared_mask);
+		}
+		dom->shared_harts = shared_mask;
+	}
+
+	/* Read "time-budget-us" DT property (zero selects default) */
+	dom->time_budget = 0;
+	val = fdt_getprop(fdt, domain_offset, "time-budget-us", &len);
+	cpus_offset = fdt_path_offset(fdt, "/cpus");
+	if (val && len >= 4 && cpus_offset >= 0) {
+		val64 = fdt32_to_cpu(*val);
+		val = fdt_getprop(fdt, cpus_offset,
+				  "timebase-frequency", &len);
+		if (val && len >= 4)
+			dom->time_budget = (val64 * fdt32_to_cpu(*val)) /
+					   1000000;
+	}
+
 	/* Increment domains count */
 	fdt_domains_count++;
 }
 
+static struct sbi_domain *__fdt_offset_to_domain(void *fdt, int domain_offset)
+{
+	u32 i;
+
+	if (domain_offset < 0)
+		return NULL;
+
+	for (i = 0; i < fdt_domains_count; i++) {
+		if (!sbi_strcmp(fdt_domains[i].name,
+				fdt_get_name(fdt, domain_offset, NULL)))
+			return &fdt_domains[i];
+	}
+
+	return NULL;
+}
+
+static void __fdt_parse_channel(void *fdt, int channel_offset, void *opaque)
+{
+	u32 i, val32;
+	u64 val64;
+	const u32 *val;
+	int len, rc, region_offset, domain_offset;
+	int *err = opaque;
+	struct sbi_domain_channel *chan;
+
+	/* Sanity check on maximum channels we can handle */
+	if (*err || SBI_DOMAIN_MAX_CHANNELS <= fdt_channels_count)
+		return;
+	chan = &fdt_channels[fdt_channels_count];
+	sbi_memset(chan, 0, sizeof(*chan));
+
+	/* Read DT node name */
+	sbi_strncpy(chan->name, fdt_get_name(fdt, channel_offset, NULL),
+		    sizeof(chan->name));
+	chan->name[sizeof(chan->name) - 1] = '\0';
+
+	/*
+	 * Read "memregion" DT property
+	 *
+	 * Incomplete channels are still registered so that
+	 * sbi_domain_finalize() rejects them.
+	 */
+	val = fdt_getprop(fdt, channel_offset, "memregion", &len);
+	region_offset = (val && len >= 4) ?
+			fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*val)) : -1;
+	if (region_offset >= 0 &&
+	    !fdt_node_check_compatible(fdt, region_offset,
+				       "opensbi,domain,memregion")) {
+		val = fdt_getprop(fdt, region_offset, "base", &len);
+		if (val && len >= 8) {
+			val64 = fdt32_to_cpu(val[0]);
+			val64 = (val64 << 32) | fdt32_to_cpu(val[1]);
+			chan->region.base = val64;
+		}
+
+		val = fdt_getprop(fdt, region_offset, "order", &len);
+		if (val && len >= 4) {
+			val32 = fdt32_to_cpu(*val);
+			chan->region.order = val32;
+		}
+	}
+
+	/* Read "peers" DT property */
+	val = fdt_getprop(fdt, channel_offset, "peers", &len);
+	len = (val) ? len / sizeof(u32) : 0;
+	for (i = 0; i < array_size(chan->peers) && i < len; i++) {
+		domain_offset = fdt_node_offset_by_phandle(fdt,
+							fdt32_to_cpu(val[i]));
+		chan->peers[i] = __fdt_offset_to_domain(fdt, domain_offset);
+	}
+
+	rc = sbi_domain_channel_register(chan);
+	if (rc) {
+		*err = rc;
+		return;
+	}
+
+	/* Increment channels count */
+	fdt_channels_count++;
+}
+
 int fdt_domains_populate(void *fdt)
 {
 	const u32 *val;
 	int cold_domain_offset;
-	u32 i, hartid, cold_hartid;
+	u32 hartid, cold_hartid;
+	struct sbi_domain *dom;
 	int err, len, cpus_offset, cpu_offset, domain_offset;
 
 	/* Sanity checks */
@@ -429,17 +591,14 @@ int fdt_domains_populate(void *fdt)
 
 		domain_offset = fdt_node_offset_by_phandle(fdt,
 							   fdt32_to_cpu(*val));
-		if (domain_offset < 0)
-			continue;
-
-		for (i = 0; i < fdt_domains_count; i++) {
-			if (!sbi_strcmp(fdt_domains[i].name,
-				fdt_get_name(fdt, domain_offset, NULL))) {
-				fdt_hartid_to_domain[hartid] = &fdt_domains[i];
-				break;
-			}
-		}
+		dom = __fdt_offset_to_domain(fdt, domain_offset);
+		if (dom)
+			fdt_hartid_to_domain[hartid] = dom;
 	}
 
-	return 0;
+	/* Iterate over each channel in FDT and register it */
+	err = 0;
+	fdt_iterate_each_channel(fdt, &err, __fdt_parse_channel);
+
+	return err;
 }
@@ -8,7 +8,9 @@
 
 #include <libfdt.h>
 #include <sbi/riscv_asm.h>
+#include <sbi/sbi_bitops.h>
 #include <sbi/sbi_console.h>
+#include <sbi/sbi_hart.h>
 #include <sbi/sbi_hartmask.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_scratch.h>
@@ -213,6 +215,145 @@ int fdt_parse_max_hart_id(void *fdt, u32 *max_hartid)
 	return 0;
 }
 
+static bool fdt_isa_token_match(const char *token, int len, const char *name)
+{
+	int i;
+	char ch;
+
+	for (i = 0; i < len; i++) {
+		ch = token[i];
+		if ('A' <= ch && ch <= 'Z')
+			ch = ch - 'A' + 'a';
+		if (!name[i] || ch != name[i])
+			return FALSE;
+	}
+
+	return name[i] ? FALSE : TRUE;
+}
+
+static int fdt_hart_cpu_offset(void *fdt, u32 hartid)
+{
+	u32 cpu_hartid;
+	int cpu_offset, cpus_offset;
+
+	cpus_offset = fdt_path_offset(fdt, "/cpus");
+	if (cpus_offset < 0)
+		return cpus_offset;
+
+	fdt_for_each_subnode(cpu_offset, fdt, cpus_offset) {
+		if (fdt_parse_hart_id(fdt, cpu_offset, &cpu_hartid))
+			continue;
+		if (cpu_hartid == hartid)
+			return cpu_offset;
+	}
+
+	return SBI_ENOENT;
+}
+
+int fdt_parse_isa_extensions(void *fdt, u32 hartid,
+			     unsigned long *extensions)
+{
+	const char *isa, *tok, *end;
+	int len, ext, cpu_offset;
+
+	if (!fdt || !extensions)
+		return SBI_EINVAL;
+
+	cpu_offset = fdt_hart_cpu_offset(fdt, hartid);
+	if (cpu_offset < 0)
+		return cpu_offset;
+
+	isa = fdt_getprop(fdt, cpu_offset, "riscv,isa", &len);
+	if (!isa || len <= 0)
+		return 0;
+	end = isa + strnlen(isa, len);
+
+	/* Multi-letter extensions follow the single letter ones after '_' */
+	tok = isa;
+	while (tok < end && *tok != '_')
+		tok++;
+
+	while (tok < end) {
+		tok++;
+		len = 0;
+		while ((tok + len) < end && tok[len] != '_')
+			len++;
+
+		for (ext = SBI_HART_EXT_ZBB; ext < SBI_HART_EXT_MAX; ext++) {
+			if (fdt_isa_token_match(tok, len,
+						sbi_hart_extension_name(ext)))
+				__set_bit(ext, extensions);
+		}
+
+		tok += len;
+	}
+
+	return 0;
+}
+
+static unsigned long fdt_key_hash(unsigned long key, const char *prop, int len)
+{
+	int i;
+
+	/* FNV-1a over the raw property bytes */
+	for (i = 0; i < len; i++) {
+		key ^= (unsigned char)prop[i];
+		key *= 0x01000193UL;
+	}
+
+	return key;
+}
+
+int fdt_parse_hart_type_key(void *fdt, u32 hartid, unsigned long *key)
+{
+	const char *prop;
+	int len, cpu_offset;
+
+	if (!fdt || !key)
+		return SBI_EINVAL;
+
+	cpu_offset = fdt_hart_cpu_offset(fdt, hartid);
+	if (cpu_offset < 0)
+		return cpu_offset;
+
+	*key = 0x811c9dc5UL;
+
+	prop = fdt_getprop(fdt, cpu_offset, "compatible", &len);
+	if (prop && len > 0)
+		*key = fdt_key_hash(*key, prop, len);
+
+	prop = fdt_getprop(fdt, cpu_offset, "riscv,isa", &len);
+	if (prop && len > 0)
+		*key = fdt_key_hash(*key, prop, len);
+
+	return 0;
+}
+
+int fdt_parse_reserved_memory(void *fdt, const char *compat, int *node,
+			      unsigned long *addr, unsigned long *size)
+{
+	int rmem_offset, offset;
+
+	if (!fdt || !compat || !addr || !size)
+		return SBI_EINVAL;
+
+	rmem_offset = fdt_path_offset(fdt, "/reserved-memory");
+	if (rmem_offset < 0)
+		return SBI_ENOENT;
+
+	offset = fdt_node_offset_by_compatible(fdt, rmem_offset, compat);
+	if (offset < 0)
+		return SBI_ENOENT;
+
+	if (fdt_get_node_addr_size(fdt, offset, addr, size))
+		return SBI_EINVAL;
+
+	if (node)
+		*node = offset;
+
+	return 0;
+}
+
 int fdt_parse_shakti_uart_node(void *fdt, int nodeoffset,
 			       struct platform_uart_data *uart)
 {
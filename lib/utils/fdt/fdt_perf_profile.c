@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_perf_profile.c - Flat Device Tree performance profile helper routines
+ */
+
+#include <libfdt.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_perf_profile.h>
+#include <sbi/sbi_string.h>
+#include <sbi_utils/fdt/fdt_perf_profile.h>
+
+static unsigned long fdt_perf_read_value(const fdt32_t *val, u32 cells)
+{
+	unsigned long ret = fdt32_to_cpu(val[0]);
+
+#if __riscv_xlen == 64
+	if (cells == 2)
+		ret = (ret << 32) | fdt32_to_cpu(val[1]);
+#else
+	if (cells == 2)
+		ret = fdt32_to_cpu(val[1]);
+#endif
+
+	return ret;
+}
+
+static int fdt_perf_parse_profile(void *fdt, int poffset, u32 value_cells)
+{
+	int len;
+	u32 i, entry_cells;
+	const fdt32_t *val;
+	const char *name;
+	struct sbi_perf_profile prof;
+
+	sbi_memset(&prof, 0, sizeof(prof));
+
+	name = fdt_get_name(fdt, poffset, NULL);
+	if (!name)
+		return SBI_EINVAL;
+	sbi_strncpy(prof.name, name, sizeof(prof.name));
+	prof.name[sizeof(prof.name) - 1] = '\0';
+
+	/* Each entry is <csr mask value> */
+	entry_cells = 1 + 2 * value_cells;
+	val = fdt_getprop(fdt, poffset, "csrs", &len);
+	if (!val || len <= 0 || len % (entry_cells * sizeof(fdt32_t)))
+		return SBI_EINVAL;
+	prof.csr_count = len / (entry_cells * sizeof(fdt32_t));
+	if (SBI_PERF_PROFILE_CSR_MAX < prof.csr_count)
+		return SBI_ENOSPC;
+
+	for (i = 0; i < prof.csr_count; i++) {
+		prof.csrs[i].csr = fdt32_to_cpu(val[0]);
+		prof.csrs[i].mask = fdt_perf_read_value(&val[1], value_cells);
+		prof.csrs[i].value = fdt_perf_read_value(&val[1 + value_cells],
+							 value_cells);
+		val += entry_cells;
+	}
+
+	return sbi_perf_profile_register(&prof);
+}
+
+int fdt_perf_profiles_populate(void *fdt)
+{
+	const fdt32_t *val;
+	u32 value_cells = 1;
+	int rc, len, coffset, poffset, default_offset;
+
+	if (!fdt)
+		return SBI_EINVAL;
+
+	coffset = fdt_path_offset(fdt, "/chosen");
+	if (coffset < 0)
+		return 0;
+	coffset = fdt_node_offset_by_compatible(fdt, coffset,
+						"opensbi,perf-profile,config");
+	if (coffset < 0)
+		return 0;
+
+	val = fdt_getprop(fdt, coffset, "#value-cells", &len);
+	if (val && len >= sizeof(fdt32_t))
+		value_cells = fdt32_to_cpu(*val);
+	if (value_cells < 1 || 2 < value_cells)
+		return SBI_EINVAL;
+
+	default_offset = -1;
+	val = fdt_getprop(fdt, coffset, "default-profile", &len);
+	if (val && len >= sizeof(fdt32_t))
+		default_offset = fdt_node_offset_by_phandle(fdt,
+							fdt32_to_cpu(*val));
+
+	fdt_for_each_subnode(poffset, fdt, coffset) {
+		if (fdt_node_check_compatible(fdt, poffset,
+					      "opensbi,perf-profile,instance"))
+			continue;
+
+		rc = fdt_perf_parse_profile(fdt, poffset, value_cells);
+		if (rc < 0)
+			return rc;
+
+		if (poffset == default_offset) {
+			rc = sbi_perf_profile_set_default(rc);
+			if (rc)
+				return rc;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_record.c - Flat Device Tree SBI call record buffer helper routines
+ */
+
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_record.h>
+#include <sbi_utils/fdt/fdt_helper.h>
+#include <sbi_utils/fdt/fdt_record.h>
+
+int fdt_record_init(void *fdt)
+{
+	int rc;
+	unsigned long addr, size;
+
+	rc = fdt_parse_reserved_memory(fdt, "opensbi,record-buffer", NULL,
+				       &addr, &size);
+	if (rc)
+		return (rc == SBI_ENOENT) ? 0 : rc;
+
+	return sbi_record_configure(addr, size);
+}
@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_trace.c - Flat Device Tree firmware trace buffer helper routines
+ */
+
+#include <libfdt.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_trace.h>
+#include <sbi_utils/fdt/fdt_helper.h>
+#include <sbi_utils/fdt/fdt_trace.h>
+
+int fdt_trace_init(void *fdt)
+{
+	int rc, len, node;
+	const fdt32_t *val;
+	unsigned long addr, size, mask = 0;
+
+	rc = fdt_parse_reserved_memory(fdt, "opensbi,trace-buffer", &node,
+				       &addr, &size);
+	if (rc)
+		return (rc == SBI_ENOENT) ? 0 : rc;
+
+	val = fdt_getprop(fdt, node, "opensbi,trace-mask", &len);
+	if (val && len >= 4)
+		mask = fdt32_to_cpu(*val);
+
+	return sbi_trace_configure(addr, size, mask);
+}
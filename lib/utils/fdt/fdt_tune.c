@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * fdt_tune.c - Flat Device Tree firmware tuning parameter helper routines
+ */
+
+#include <libfdt.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_tune.h>
+#include <sbi_utils/fdt/fdt_tune.h>
+
+int fdt_tune_init(void *fdt)
+{
+	u32 id;
+	u64 val;
+	int len, rc, coff;
+	const fdt32_t *prop;
+
+	if (!fdt)
+		return SBI_EINVAL;
+
+	coff = fdt_path_offset(fdt, "/chosen/opensbi-config");
+	if (coff < 0)
+		return 0;
+
+	for (id = 0; id < SBI_TUNE_PARAM_MAX; id++) {
+		prop = fdt_getprop(fdt, coff, sbi_tune_name(id), &len);
+		if (!prop)
+			continue;
+
+		if (len == sizeof(fdt32_t))
+			val = fdt32_to_cpu(prop[0]);
+		else if (len == 2 * sizeof(fdt32_t))
+			val = ((u64)fdt32_to_cpu(prop[0]) << 32) |
+			      fdt32_to_cpu(prop[1]);
+		else
+			return SBI_EINVAL;
+		if ((unsigned long)val != val)
+			return SBI_EINVAL;
+
+		/* Parameters compiled out of the firmware are ignored */
+		rc = sbi_tune_set(id, val);
+		if (rc && rc != SBI_ENOTSUPP)
+			return rc;
+	}
+
+	return 0;
+}
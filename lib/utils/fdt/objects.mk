@@ -7,3 +7,7 @@
 libsbiutils-objs-y += fdt/fdt_domain.o
 libsbiutils-objs-y += fdt/fdt_helper.o
 libsbiutils-objs-y += fdt/fdt_fixup.o
+libsbiutils-objs-$(CONFIG_SBI_ECALL_PERF_PROFILE) += fdt/fdt_perf_profile.o
+libsbiutils-objs-$(CONFIG_SBI_RECORD) += fdt/fdt_record.o
+libsbiutils-objs-$(CONFIG_SBI_TRACE) += fdt/fdt_trace.o
+libsbiutils-objs-$(CONFIG_SBI_ECALL_TUNE) += fdt/fdt_tune.o
@@ -14,7 +14,9 @@
 extern struct fdt_ipi fdt_ipi_clint;
 
 static struct fdt_ipi *ipi_drivers[] = {
-	&fdt_ipi_clint
+#ifdef CONFIG_FDT_IPI_CLINT
+	&fdt_ipi_clint,
+#endif
 };
 
 static void dummy_send(u32 target_hart)
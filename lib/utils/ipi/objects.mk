@@ -8,4 +8,4 @@
 #
 
 libsbiutils-objs-y += ipi/fdt_ipi.o
-libsbiutils-objs-y += ipi/fdt_ipi_clint.o
+libsbiutils-objs-$(CONFIG_FDT_IPI_CLINT) += ipi/fdt_ipi_clint.o
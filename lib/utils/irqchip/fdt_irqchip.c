@@ -14,7 +14,9 @@
 extern struct fdt_irqchip fdt_irqchip_plic;
 
 static struct fdt_irqchip *irqchip_drivers[] = {
-	&fdt_irqchip_plic
+#ifdef CONFIG_FDT_IRQCHIP_PLIC
+	&fdt_irqchip_plic,
+#endif
 };
 
 static struct fdt_irqchip *current_driver = NULL;
@@ -0,0 +1,208 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <sbi/sbi_error.h>
+#include <sbi_utils/lz4/lz4.h>
+
+/* clang-format off */
+
+#define LZ4_LEGACY_MAGIC		0x184C2102
+#define LZ4_MIN_MATCH			4
+#define LZ4_RUN_MASK			0xf
+
+/* Distance kept between write and read pointers for in-place use */
+#define LZ4_INPLACE_MARGIN(__sz)	(((__sz) >> 8) + 64)
+
+#define LZ4_WORD_SIZE			sizeof(unsigned long)
+#define LZ4_WORD_MASK			(LZ4_WORD_SIZE - 1)
+
+/* clang-format on */
+
+static inline u32 lz4_get_le32(const u8 *p)
+{
+	return (u32)p[0] | ((u32)p[1] << 8) |
+	       ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+/*
+ * Forward copy using word accesses whenever both pointers share the
+ * same alignment. This is safe for overlapping buffers when dst is
+ * below src or when dst is at least one word above src (LZ4 matches).
+ */
+static void lz4_copy(u8 *dst, const u8 *src, size_t len)
+{
+	u8 *end = dst + len;
+
+	if (len >= 2 * LZ4_WORD_SIZE &&
+	    !(((unsigned long)dst ^ (unsigned long)src) & LZ4_WORD_MASK) &&
+	    (dst < src || src + LZ4_WORD_SIZE <= dst)) {
+		while ((unsigned long)dst & LZ4_WORD_MASK)
+			*dst++ = *src++;
+		while (dst + LZ4_WORD_SIZE <= end) {
+			*(unsigned long *)dst = *(const unsigned long *)src;
+			dst += LZ4_WORD_SIZE;
+			src += LZ4_WORD_SIZE;
+		}
+	}
+
+	while (dst < end)
+		*dst++ = *src++;
+}
+
+/* Backward copy for moving data to a higher overlapping address */
+static void lz4_copy_backward(u8 *dst, const u8 *src, size_t len)
+{
+	u8 *d = dst + len;
+	const u8 *s = src + len;
+
+	if (len >= 2 * LZ4_WORD_SIZE &&
+	    !(((unsigned long)d ^ (unsigned long)s) & LZ4_WORD_MASK)) {
+		while ((unsigned long)d & LZ4_WORD_MASK)
+			*--d = *--s;
+		while ((size_t)(d - dst) >= LZ4_WORD_SIZE) {
+			d -= LZ4_WORD_SIZE;
+			s -= LZ4_WORD_SIZE;
+			*(unsigned long *)d = *(const unsigned long *)s;
+		}
+	}
+
+	while (d > dst)
+		*--d = *--s;
+}
+
+static int lz4_read_len(const u8 **src, const u8 *src_end, size_t *len)
+{
+	u8 b;
+
+	do {
+		if (*src >= src_end)
+			return SBI_EINVAL;
+		b = *(*src)++;
+		*len += b;
+	} while (b == 255);
+
+	return 0;
+}
+
+static int lz4_decompress_block(u8 *base, u8 **dstp, u8 *dst_end,
+				const u8 *src, const u8 *src_end)
+{
+	int rc;
+	u8 token;
+	size_t len, off;
+	u8 *dst = *dstp;
+
+	while (src < src_end) {
+		token = *src++;
+
+		/* Literals */
+		len = token >> 4;
+		if (len == LZ4_RUN_MASK) {
+			rc = lz4_read_len(&src, src_end, &len);
+			if (rc)
+				return rc;
+		}
+		if (len > (size_t)(src_end - src) ||
+		    len > (size_t)(dst_end - dst))
+			return SBI_EINVAL;
+		lz4_copy(dst, src, len);
+		dst += len;
+		src += len;
+
+		/* Last sequence of a block only has literals */
+		if (src >= src_end)
+			break;
+
+		/* Match */
+		if ((src_end - src) < 2)
+			return SBI_EINVAL;
+		off = (size_t)src[0] | ((size_t)src[1] << 8);
+		src += 2;
+		if (!off || off > (size_t)(dst - base))
+			return SBI_EINVAL;
+		len = token & LZ4_RUN_MASK;
+		if (len == LZ4_RUN_MASK) {
+			rc = lz4_read_len(&src, src_end, &len);
+			if (rc)
+				return rc;
+		}
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(dst_end - dst))
+			return SBI_EINVAL;
+		lz4_copy(dst, dst - off, len);
+		dst += len;
+	}
+
+	*dstp = dst;
+	return 0;
+}
+
+int lz4_decompress(void *dst, size_t dst_size,
+		   const void *src, size_t src_size, size_t *out_size)
+{
+	int rc;
+	u32 bsize;
+	const u8 *in = src, *in_end = in + src_size;
+	u8 *out = dst, *out_end = out + dst_size;
+
+	if (src_size < 4 || lz4_get_le32(in) != LZ4_LEGACY_MAGIC)
+		return SBI_EINVAL;
+	in += 4;
+
+	while ((in_end - in) >= 4) {
+		bsize = lz4_get_le32(in);
+		in += 4;
+
+		/* Legacy frames can be concatenated */
+		if (bsize == LZ4_LEGACY_MAGIC)
+			continue;
+
+		if (bsize > (size_t)(in_end - in))
+			return SBI_EINVAL;
+		rc = lz4_decompress_block(dst, &out, out_end, in, in + bsize);
+		if (rc)
+			return rc;
+		in += bsize;
+	}
+
+	if (out_size)
+		*out_size = out - (u8 *)dst;
+
+	return 0;
+}
+
+int lz4_decompress_inplace(void *dst, size_t window_size,
+			   const void *src, size_t src_size, size_t *out_size)
+{
+	size_t dst_size;
+	unsigned long tmp, win_start, win_end;
+	const u8 *in = src;
+
+	if (src_size < 8)
+		return SBI_EINVAL;
+	src_size -= 4;
+	dst_size = lz4_get_le32(in + src_size);
+
+	/* Both the frame and the decompressed data must fit the window */
+	win_start = (unsigned long)dst;
+	win_end = win_start + window_size;
+	if (win_end < win_start ||
+	    (unsigned long)in < win_start ||
+	    win_end < (unsigned long)in + src_size ||
+	    window_size < dst_size + LZ4_INPLACE_MARGIN(src_size))
+		return SBI_EINVAL;
+
+	/*
+	 * Move the frame to the end of the window which leaves at least
+	 * the safety margin after the decompressed data. The write pointer
+	 * then never catches up with the read pointer.
+	 */
+	tmp = (win_end - src_size) & ~LZ4_WORD_MASK;
+	if ((unsigned long)in < tmp) {
+		lz4_copy_backward((u8 *)tmp, in, src_size);
+		in = (const u8 *)tmp;
+	}
+
+	return lz4_decompress(dst, dst_size, in, src_size, out_size);
+}
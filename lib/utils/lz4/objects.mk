@@ -0,0 +1,5 @@
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+
+libsbiutils-objs-y += lz4/lz4.o
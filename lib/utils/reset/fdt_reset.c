@@ -15,8 +15,12 @@ extern struct fdt_reset fdt_reset_sifive;
 extern struct fdt_reset fdt_reset_htif;
 
 static struct fdt_reset *reset_drivers[] = {
+#ifdef CONFIG_FDT_RESET_SIFIVE
 	&fdt_reset_sifive,
+#endif
+#ifdef CONFIG_FDT_RESET_HTIF
 	&fdt_reset_htif,
+#endif
 };
 
 static struct fdt_reset *current_driver = NULL;
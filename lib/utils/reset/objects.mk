@@ -8,5 +8,5 @@
 #
 
 libsbiutils-objs-y += reset/fdt_reset.o
-libsbiutils-objs-y += reset/fdt_reset_htif.o
-libsbiutils-objs-y += reset/fdt_reset_sifive.o
+libsbiutils-objs-$(CONFIG_FDT_RESET_HTIF) += reset/fdt_reset_htif.o
+libsbiutils-objs-$(CONFIG_FDT_RESET_SIFIVE) += reset/fdt_reset_sifive.o
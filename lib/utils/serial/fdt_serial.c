@@ -18,10 +18,18 @@ extern struct fdt_serial fdt_serial_htif;
 extern struct fdt_serial fdt_serial_shakti;
 
 static struct fdt_serial *serial_drivers[] = {
+#ifdef CONFIG_FDT_SERIAL_UART8250
 	&fdt_serial_uart8250,
+#endif
+#ifdef CONFIG_FDT_SERIAL_SIFIVE
 	&fdt_serial_sifive,
+#endif
+#ifdef CONFIG_FDT_SERIAL_HTIF
 	&fdt_serial_htif,
+#endif
+#ifdef CONFIG_FDT_SERIAL_SHAKTI
 	&fdt_serial_shakti,
+#endif
 };
 
 static void dummy_putc(char ch)
@@ -47,6 +55,19 @@ void fdt_serial_putc(char ch)
 	current_driver->putc(ch);
 }
 
+void fdt_serial_puts(const char *str, unsigned long len)
+{
+	unsigned long i;
+
+	if (current_driver->puts) {
+		current_driver->puts(str, len);
+		return;
+	}
+
+	for (i = 0; i < len; i++)
+		current_driver->putc(str[i]);
+}
+
 int fdt_serial_getc(void)
 {
 	return current_driver->getc();
@@ -20,5 +20,6 @@ struct fdt_serial fdt_serial_htif = {
 	.match_table = serial_htif_match,
 	.init = NULL,
 	.getc = htif_getc,
-	.putc = htif_putc
+	.putc = htif_putc,
+	.puts = htif_puts
 };
@@ -22,15 +22,15 @@ static volatile void *uart_base;
 
 void shakti_uart_putc(char ch)
 {
-	while((readw(uart_base + REG_STATUS) & 0x2) == 0);
-	writeb(ch, uart_base + REG_TX);
+	while((readw_relaxed(uart_base + REG_STATUS) & 0x2) == 0);
+	writeb_relaxed(ch, uart_base + REG_TX);
 }
 
 int shakti_uart_getc(void)
 {
-	u16 status = readw(uart_base + REG_STATUS);
+	u16 status = readw_relaxed(uart_base + REG_STATUS);
 	if (status & 0x8)
-		return readb(uart_base + REG_RX);
+		return readb_relaxed(uart_base + REG_RX);
 	return -1;
 }
 
@@ -56,14 +56,15 @@ static inline unsigned int uart_min_clk_divisor(uint64_t in_freq,
 	}
 }
 
+/* No ordering against normal memory needed so relaxed accesses suffice */
 static u32 get_reg(u32 num)
 {
-	return readl(uart_base + (num * 0x4));
+	return readl_relaxed(uart_base + (num * 0x4));
 }
 
 static void set_reg(u32 num, u32 val)
 {
-	writel(val, uart_base + (num * 0x4));
+	writel_relaxed(val, uart_base + (num * 0x4));
 }
 
 void sifive_uart_putc(char ch)
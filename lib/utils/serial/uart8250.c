@@ -44,16 +44,20 @@ static u32 uart8250_baudrate;
 static u32 uart8250_reg_width;
 static u32 uart8250_reg_shift;
 
+/*
+ * The UART does not access normal memory so register accesses only need
+ * to be ordered among themselves, which relaxed accessors guarantee.
+ */
 static u32 get_reg(u32 num)
 {
 	u32 offset = num << uart8250_reg_shift;
 
 	if (uart8250_reg_width == 1)
-		return readb(uart8250_base + offset);
+		return readb_relaxed(uart8250_base + offset);
 	else if (uart8250_reg_width == 2)
-		return readw(uart8250_base + offset);
+		return readw_relaxed(uart8250_base + offset);
 	else
-		return readl(uart8250_base + offset);
+		return readl_relaxed(uart8250_base + offset);
 }
 
 static void set_reg(u32 num, u32 val)
@@ -61,11 +65,11 @@ static void set_reg(u32 num, u32 val)
 	u32 offset = num << uart8250_reg_shift;
 
 	if (uart8250_reg_width == 1)
-		writeb(val, uart8250_base + offset);
+		writeb_relaxed(val, uart8250_base + offset);
 	else if (uart8250_reg_width == 2)
-		writew(val, uart8250_base + offset);
+		writew_relaxed(val, uart8250_base + offset);
 	else
-		writel(val, uart8250_base + offset);
+		writel_relaxed(val, uart8250_base + offset);
 }
 
 void uart8250_putc(char ch)
@@ -12,6 +12,7 @@
 #include <sbi/riscv_io.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_hartmask.h>
+#include <sbi/sbi_scratch.h>
 #include <sbi_utils/sys/clint.h>
 
 #define CLINT_IPI_OFF		0
@@ -30,8 +31,8 @@ void clint_ipi_send(u32 target_hart)
 	if (!clint)
 		return;
 
-	/* Set CLINT IPI */
-	writel(1, &clint->ipi[target_hart - clint->first_hartid]);
+	/* Set CLINT IPI (sbi_platform_ipi_send() orders prior writes) */
+	writel_relaxed(1, &clint->ipi[target_hart - clint->first_hartid]);
 }
 
 void clint_ipi_clear(u32 target_hart)
@@ -44,7 +45,7 @@ void clint_ipi_clear(u32 target_hart)
 	if (!clint)
 		return;
 
-	/* Clear CLINT IPI */
+	/* Clear CLINT IPI (fenced so that it is ordered with IPI data) */
 	writel(0, &clint->ipi[target_hart - clint->first_hartid]);
 }
 
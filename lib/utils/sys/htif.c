@@ -76,7 +76,6 @@ static void __set_tohost(uint64_t dev, uint64_t cmd, uint64_t data)
 	tohost = TOHOST_CMD(dev, cmd, data);
 }
 
-#if __riscv_xlen == 32
 static void do_tohost_fromhost(uint64_t dev, uint64_t cmd, uint64_t data)
 {
 	spin_lock(&htif_lock);
@@ -98,16 +97,22 @@ static void do_tohost_fromhost(uint64_t dev, uint64_t cmd, uint64_t data)
 	spin_unlock(&htif_lock);
 }
 
-void htif_putc(char ch)
+static void htif_sys_write(const char *buf, unsigned long len)
 {
-	/* HTIF devices are not supported on RV32, so do a proxy write call */
 	volatile uint64_t magic_mem[8];
 	magic_mem[0] = PK_SYS_write;
 	magic_mem[1] = HTIF_DEV_CONSOLE;
-	magic_mem[2] = (uint64_t)(uintptr_t)&ch;
-	magic_mem[3] = HTIF_CONSOLE_CMD_PUTC;
+	magic_mem[2] = (uint64_t)(uintptr_t)buf;
+	magic_mem[3] = len;
 	do_tohost_fromhost(HTIF_DEV_SYSTEM, 0, (uint64_t)(uintptr_t)magic_mem);
 }
+
+#if __riscv_xlen == 32
+void htif_putc(char ch)
+{
+	/* HTIF devices are not supported on RV32, so do a proxy write call */
+	htif_sys_write(&ch, 1);
+}
 #else
 void htif_putc(char ch)
 {
@@ -117,6 +122,16 @@ void htif_putc(char ch)
 }
 #endif
 
+void htif_puts(const char *str, unsigned long len)
+{
+	/*
+	 * One proxied write system call per buffer instead of one
+	 * console device request per character.
+	 */
+	if (len)
+		htif_sys_write(str, len);
+}
+
 int htif_getc(void)
 {
 	int ch;
@@ -14,7 +14,9 @@
 extern struct fdt_timer fdt_timer_clint;
 
 static struct fdt_timer *timer_drivers[] = {
-	&fdt_timer_clint
+#ifdef CONFIG_FDT_TIMER_CLINT
+	&fdt_timer_clint,
+#endif
 };
 
 static u64 dummy_value(void)
@@ -8,4 +8,4 @@
 #
 
 libsbiutils-objs-y += timer/fdt_timer.o
-libsbiutils-objs-y += timer/fdt_timer_clint.o
+libsbiutils-objs-$(CONFIG_FDT_TIMER_CLINT) += timer/fdt_timer_clint.o
@@ -9,6 +9,8 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_io.h>
+#include <sbi/sbi_cache.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_types.h>
 #include "platform.h"
 
@@ -87,3 +89,44 @@ uintptr_t mcall_write_around(unsigned long enable)
 	}
 	return 0;
 }
+
+unsigned long ae350_cache_block_size(void)
+{
+	unsigned long dsz;
+
+	dsz = (csr_read(CSR_MDCM_CFG) & V5_MDCM_CFG_DSZ_MASK) >>
+	      V5_MDCM_CFG_DSZ_OFFSET;
+
+	/* DSZ == 0 means no L1 data cache */
+	return (dsz) ? (1UL << (dsz + 2)) : 0;
+}
+
+int ae350_cache_op(u32 type, unsigned long addr, unsigned long size)
+{
+	unsigned long pos, cmd, bsize = ae350_cache_block_size();
+
+	if (!bsize)
+		return 0;
+
+	switch (type) {
+	case SBI_CACHE_CLEAN:
+		cmd = V5_UCCTL_L1D_VA_WB;
+		break;
+	case SBI_CACHE_INVAL:
+		cmd = V5_UCCTL_L1D_VA_INVAL;
+		break;
+	case SBI_CACHE_FLUSH:
+		cmd = V5_UCCTL_L1D_VA_WBINVAL;
+		break;
+	default:
+		return SBI_EINVAL;
+	}
+
+	/* M-mode has no translation so VA based CCTL works on PA */
+	for (pos = addr; pos < (addr + size); pos += bsize) {
+		csr_write(CSR_MCCTLBEGINADDR, pos);
+		csr_write(CSR_MCCTLCOMMAND, cmd);
+	}
+
+	return 0;
+}
@@ -15,3 +15,5 @@ uintptr_t mcall_l1_cache_i_prefetch_op(unsigned long enable);
 uintptr_t mcall_l1_cache_d_prefetch_op(unsigned long enable);
 uintptr_t mcall_non_blocking_load_store(unsigned long enable);
 uintptr_t mcall_write_around(unsigned long enable);
+unsigned long ae350_cache_block_size(void);
+int ae350_cache_op(u32 type, unsigned long addr, unsigned long size);
@@ -12,7 +12,9 @@
 #include <sbi/riscv_encoding.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_const.h>
+#include <sbi/sbi_perf_profile.h>
 #include <sbi/sbi_platform.h>
+#include <sbi/sbi_string.h>
 #include <sbi_utils/fdt/fdt_fixup.h>
 #include <sbi_utils/irqchip/plic.h>
 #include <sbi_utils/serial/uart8250.h>
@@ -26,6 +28,66 @@ static struct plic_data plic = {
 	.num_src = AE350_PLIC_NUM_SOURCES,
 };
 
+/* Performance bits of mcache_ctl and mmisc_ctl owned by the profiles */
+#define AE350_PERF_MCACHE_CTL_MASK	(V5_MCACHE_CTL_L1I_PREFETCH_EN | \
+					 V5_MCACHE_CTL_L1D_PREFETCH_EN | \
+					 V5_MCACHE_CTL_DC_WAROUND_1_EN)
+#define AE350_PERF_MMISC_CTL_MASK	(V5_MMISC_CTL_BRPE_EN | \
+					 V5_MMISC_CTL_NON_BLOCKING_EN)
+
+static int ae350_perf_profile_register(const char *name,
+				       unsigned long mcache_ctl,
+				       unsigned long mmisc_ctl)
+{
+	struct sbi_perf_profile prof = {
+		.csr_count = 2,
+		.csrs = {
+			{ CSR_MCACHECTL, AE350_PERF_MCACHE_CTL_MASK,
+			  mcache_ctl & AE350_PERF_MCACHE_CTL_MASK },
+			{ CSR_MMISCCTL, AE350_PERF_MMISC_CTL_MASK,
+			  mmisc_ctl & AE350_PERF_MMISC_CTL_MASK },
+		},
+	};
+	int rc;
+
+	sbi_strncpy(prof.name, name, sizeof(prof.name) - 1);
+	rc = sbi_perf_profile_register(&prof);
+
+	return (rc < 0) ? rc : 0;
+}
+
+/* Platform early initialization. */
+static int ae350_early_init(bool cold_boot)
+{
+	int rc;
+	unsigned long mcache_ctl, mmisc_ctl;
+
+	if (!cold_boot)
+		return 0;
+
+	/*
+	 * The "boot" profile (default) replicates the settings of the
+	 * boot HART on all HARTs whereas the other two only change the
+	 * L1 prefetchers.
+	 */
+	mcache_ctl = csr_read(CSR_MCACHECTL);
+	mmisc_ctl = csr_read(CSR_MMISCCTL);
+
+	rc = ae350_perf_profile_register("boot", mcache_ctl, mmisc_ctl);
+	if (rc)
+		return rc;
+
+	rc = ae350_perf_profile_register("prefetch",
+				mcache_ctl | V5_MCACHE_CTL_L1I_PREFETCH_EN |
+				V5_MCACHE_CTL_L1D_PREFETCH_EN, mmisc_ctl);
+	if (rc)
+		return rc;
+
+	return ae350_perf_profile_register("no-prefetch",
+				mcache_ctl & ~(V5_MCACHE_CTL_L1I_PREFETCH_EN |
+				V5_MCACHE_CTL_L1D_PREFETCH_EN), mmisc_ctl);
+}
+
 /* Platform final initialization. */
 static int ae350_final_init(bool cold_boot)
 {
@@ -160,6 +222,7 @@ static int ae350_vendor_ext_provider(long extid, long funcid,
 
 /* Platform descriptor. */
 const struct sbi_platform_operations platform_ops = {
+	.early_init = ae350_early_init,
 	.final_init = ae350_final_init,
 
 	.console_init = ae350_console_init,
@@ -177,6 +240,9 @@ const struct sbi_platform_operations platform_ops = {
 	.timer_event_start = plmt_timer_event_start,
 	.timer_event_stop  = plmt_timer_event_stop,
 
+	.cache_block_size = ae350_cache_block_size,
+	.cache_op         = ae350_cache_op,
+
 	.vendor_ext_provider = ae350_vendor_ext_provider
 };
 
@@ -42,6 +42,7 @@
 #define CSR_SCCTLDATA		0x9cd
 #define CSR_UCCTLBEGINADDR	0x80c
 #define CSR_MMISCCTL		0x7d0
+#define CSR_MDCM_CFG		0xfc1
 
 enum sbi_ext_andes_fid {
 	SBI_EXT_ANDES_GET_MCACHE_CTL_STATUS = 0,
@@ -90,9 +91,16 @@ enum sbi_ext_andes_fid {
 #define V5_MCACHE_CTL_CCTL_SUEN_OFFSET  8
 
 /*nds cctl command*/
+#define V5_UCCTL_L1D_VA_INVAL 0
+#define V5_UCCTL_L1D_VA_WB 1
+#define V5_UCCTL_L1D_VA_WBINVAL 2
 #define V5_UCCTL_L1D_WBINVAL_ALL 6
 #define V5_UCCTL_L1D_WB_ALL 7
 
+/* nds mdcm_cfg register */
+#define V5_MDCM_CFG_DSZ_OFFSET  6
+#define V5_MDCM_CFG_DSZ_MASK    (7UL << V5_MDCM_CFG_DSZ_OFFSET)
+
 #define V5_MCACHE_CTL_IC_EN     (1UL << V5_MCACHE_CTL_IC_EN_OFFSET)
 #define V5_MCACHE_CTL_DC_EN     (1UL << V5_MCACHE_CTL_DC_EN_OFFSET)
 #define V5_MCACHE_CTL_IC_RWECC  (1UL << V5_MCACHE_CTL_IC_RWECC_OFFSET)
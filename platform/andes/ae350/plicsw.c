@@ -10,6 +10,7 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_io.h>
+#include <sbi/sbi_scratch.h>
 #include <sbi/sbi_types.h>
 #include "plicsw.h"
 #include "platform.h"
@@ -30,7 +31,8 @@ static inline void plicsw_complete(void)
 	u32 source_hart = current_hartid();
 	u32 source = plicsw_dev[source_hart].source_id;
 
-	writel(source, plicsw_dev[source_hart].plicsw_claim);
+	/* Ordered after the claim by the data dependency on source */
+	writel_relaxed(source, plicsw_dev[source_hart].plicsw_claim);
 }
 
 static inline u32 plicsw_get_pending(u32 source_hart, u32 target_hart)
@@ -66,7 +68,8 @@ static inline void plic_sw_pending(u32 target_hart)
 	u32 per_hart_offset = PLICSW_PENDING_PER_HART * source_hart;
 	u32 val = 1 << target_offset << per_hart_offset;
 
-	writel(val, plicsw_dev[source_hart].plicsw_pending);
+	/* sbi_platform_ipi_send() orders prior writes */
+	writel_relaxed(val, plicsw_dev[source_hart].plicsw_pending);
 }
 
 void plicsw_ipi_send(u32 target_hart)
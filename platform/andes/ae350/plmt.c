@@ -10,6 +10,7 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_io.h>
+#include <sbi/sbi_scratch.h>
 
 static u32 plmt_time_hart_count;
 static volatile void *plmt_time_base;
@@ -12,8 +12,12 @@
 
 #include <sbi/sbi_types.h>
 
+struct sbi_perf_profile;
+
 struct platform_override {
 	const struct fdt_match *match_table;
+	const struct sbi_perf_profile *perf_profiles;
+	u32 perf_profile_count;
 	u64 (*features)(const struct fdt_match *match);
 	u64 (*tlbr_flush_limit)(const struct fdt_match *match);
 	int (*early_init)(bool cold_boot, const struct fdt_match *match);
@@ -24,6 +28,10 @@ struct platform_override {
 				  const struct fdt_match *match);
 	void (*system_reset)(u32 reset_type, u32 reset_reason,
 			     const struct fdt_match *match);
+	int (*system_suspend_check)(u32 sleep_type,
+				    const struct fdt_match *match);
+	int (*system_suspend)(u32 sleep_type, ulong mmode_resume_addr,
+			      const struct fdt_match *match);
 	int (*fdt_fixup)(void *fdt, const struct fdt_match *match);
 };
 
@@ -10,12 +10,21 @@
 #include <libfdt.h>
 #include <platform_override.h>
 #include <sbi/riscv_asm.h>
+#include <sbi/sbi_bitops.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hart.h>
 #include <sbi/sbi_hartmask.h>
+#include <sbi/sbi_perf_profile.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_string.h>
+#include <sbi/sbi_system.h>
 #include <sbi_utils/fdt/fdt_domain.h>
 #include <sbi_utils/fdt/fdt_fixup.h>
 #include <sbi_utils/fdt/fdt_helper.h>
+#include <sbi_utils/fdt/fdt_perf_profile.h>
+#include <sbi_utils/fdt/fdt_record.h>
+#include <sbi_utils/fdt/fdt_trace.h>
+#include <sbi_utils/fdt/fdt_tune.h>
 #include <sbi_utils/irqchip/fdt_irqchip.h>
 #include <sbi_utils/serial/fdt_serial.h>
 #include <sbi_utils/timer/fdt_timer.h>
@@ -31,6 +40,16 @@ static const struct platform_override *special_platforms[] = {
 static const struct platform_override *generic_plat = NULL;
 static const struct fdt_match *generic_plat_match = NULL;
 
+/* Per-HART details parsed from the device tree on cold boot */
+struct generic_hart_data {
+	/* Multi-letter ISA extensions listed in riscv,isa */
+	unsigned long extensions[BITS_TO_LONGS(SBI_HART_EXT_MAX)];
+	/* Hash of compatible and riscv,isa for sharing HART features */
+	unsigned long features_key;
+};
+
+static unsigned long generic_hart_data_offset;
+
 static void fw_platform_lookup_special(void *fdt, int root_offset)
 {
 	int pos, noff;
@@ -54,6 +73,7 @@ static void fw_platform_lookup_special(void *fdt, int root_offset)
 
 extern struct sbi_platform platform;
 static u32 generic_hart_index2id[SBI_HARTMASK_MAX_BITS] = { 0 };
+static u32 generic_cbom_block_size = 0;
 
 /*
  * The fw_platform_init() function is called very early on the boot HART
@@ -73,6 +93,7 @@ unsigned long fw_platform_init(unsigned long arg0, unsigned long arg1,
 				unsigned long arg4)
 {
 	const char *model;
+	const fdt32_t *val;
 	void *fdt = (void *)arg1;
 	u32 hartid, hart_count = 0;
 	int rc, root_offset, cpus_offset, cpu_offset, len;
@@ -94,6 +115,10 @@ unsigned long fw_platform_init(unsigned long arg0, unsigned long arg1,
 	if (cpus_offset < 0)
 		goto fail;
 
+	/* Don't share detected features among HARTs with same IDs */
+	if (fdt_getprop(fdt, cpus_offset, "opensbi,heterogeneous-harts", NULL))
+		platform.features |= SBI_PLATFORM_HAS_HETEROGENEOUS_HARTS;
+
 	fdt_for_each_subnode(cpu_offset, fdt, cpus_offset) {
 		rc = fdt_parse_hart_id(fdt, cpu_offset, &hartid);
 		if (rc)
@@ -103,6 +128,10 @@ unsigned long fw_platform_init(unsigned long arg0, unsigned long arg1,
 			continue;
 
 		generic_hart_index2id[hart_count++] = hartid;
+
+		val = fdt_getprop(fdt, cpu_offset, "riscv,cbom-block-size", &len);
+		if (val && len >= sizeof(fdt32_t) && !generic_cbom_block_size)
+			generic_cbom_block_size = fdt32_to_cpu(*val);
 	}
 
 	platform.hart_count = hart_count;
@@ -115,6 +144,52 @@ fail:
 		wfi();
 }
 
+static int generic_hart_data_init(void *fdt)
+{
+	int rc;
+	u32 hartid;
+	struct sbi_scratch *scratch;
+	struct generic_hart_data *hdata;
+
+	generic_hart_data_offset = sbi_scratch_alloc_offset(sizeof(*hdata),
+							    "GENERIC_HART");
+	if (!generic_hart_data_offset)
+		return SBI_ENOMEM;
+
+	for (hartid = 0; hartid <= sbi_scratch_last_hartid(); hartid++) {
+		scratch = sbi_hartid_to_scratch(hartid);
+		if (!scratch)
+			continue;
+		hdata = sbi_scratch_offset_ptr(scratch,
+					       generic_hart_data_offset);
+
+		/* Missing riscv,isa details only mean nothing beyond probing */
+		rc = fdt_parse_isa_extensions(fdt, hartid, hdata->extensions);
+		if (rc && rc != SBI_ENOENT)
+			return rc;
+
+		if (fdt_parse_hart_type_key(fdt, hartid, &hdata->features_key))
+			hdata->features_key = 0;
+	}
+
+	return 0;
+}
+
+static int generic_perf_profiles_init(void)
+{
+	u32 i;
+	int rc;
+
+	/* Profiles of the platform override come before DT profiles */
+	for (i = 0; generic_plat && i < generic_plat->perf_profile_count; i++) {
+		rc = sbi_perf_profile_register(&generic_plat->perf_profiles[i]);
+		if (rc < 0)
+			return rc;
+	}
+
+	return fdt_perf_profiles_populate(sbi_scratch_thishart_arg1_ptr());
+}
+
 static int generic_early_init(bool cold_boot)
 {
 	int rc;
@@ -128,6 +203,31 @@ static int generic_early_init(bool cold_boot)
 	if (!cold_boot)
 		return 0;
 
+	rc = generic_hart_data_init(sbi_scratch_thishart_arg1_ptr());
+	if (rc)
+		return rc;
+
+	rc = fdt_trace_init(sbi_scratch_thishart_arg1_ptr());
+	if (rc)
+		return rc;
+
+	rc = fdt_record_init(sbi_scratch_thishart_arg1_ptr());
+	if (rc)
+		return rc;
+
+	rc = fdt_tune_init(sbi_scratch_thishart_arg1_ptr());
+	if (rc)
+		return rc;
+
+	/* Emulated system suspend for platforms such as QEMU virt */
+	if (fdt_node_offset_by_compatible(sbi_scratch_thishart_arg1_ptr(), -1,
+					  "opensbi,system-suspend-test") >= 0)
+		sbi_system_suspend_test_enable();
+
+	rc = generic_perf_profiles_init();
+	if (rc)
+		return rc;
+
 	return fdt_reset_init();
 }
 
@@ -172,6 +272,28 @@ static void generic_final_exit(void)
 		generic_plat->final_exit(generic_plat_match);
 }
 
+static int generic_extensions_init(void)
+{
+	int ext;
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	struct generic_hart_data *hdata =
+		sbi_scratch_offset_ptr(scratch, generic_hart_data_offset);
+
+	/* Device tree was parsed for all HARTs on cold boot */
+	for_each_set_bit(ext, hdata->extensions, SBI_HART_EXT_MAX)
+		sbi_hart_update_extension(scratch, ext, TRUE);
+
+	return 0;
+}
+
+static unsigned long generic_hart_features_key(void)
+{
+	struct generic_hart_data *hdata =
+		sbi_scratch_thishart_offset_ptr(generic_hart_data_offset);
+
+	return hdata->features_key;
+}
+
 static int generic_domains_init(void)
 {
 	return fdt_domains_populate(sbi_scratch_thishart_arg1_ptr());
@@ -184,6 +306,11 @@ static u64 generic_tlbr_flush_limit(void)
 	return SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT;
 }
 
+static unsigned long generic_cache_block_size(void)
+{
+	return generic_cbom_block_size;
+}
+
 static int generic_system_reset_check(u32 reset_type, u32 reset_reason)
 {
 	if (generic_plat && generic_plat->system_reset_check)
@@ -204,14 +331,34 @@ static void generic_system_reset(u32 reset_type, u32 reset_reason)
 	fdt_system_reset(reset_type, reset_reason);
 }
 
+static int generic_system_suspend_check(u32 sleep_type)
+{
+	if (generic_plat && generic_plat->system_suspend_check)
+		return generic_plat->system_suspend_check(sleep_type,
+							  generic_plat_match);
+	return 0;
+}
+
+static int generic_system_suspend(u32 sleep_type, ulong mmode_resume_addr)
+{
+	if (generic_plat && generic_plat->system_suspend)
+		return generic_plat->system_suspend(sleep_type,
+						    mmode_resume_addr,
+						    generic_plat_match);
+	return SBI_ENOTSUPP;
+}
+
 const struct sbi_platform_operations platform_ops = {
 	.early_init		= generic_early_init,
 	.final_init		= generic_final_init,
 	.early_exit		= generic_early_exit,
 	.final_exit		= generic_final_exit,
+	.extensions_init	= generic_extensions_init,
+	.hart_features_key	= generic_hart_features_key,
 	.domains_init		= generic_domains_init,
 	.domain_get		= fdt_domain_get,
 	.console_putc		= fdt_serial_putc,
+	.console_puts		= fdt_serial_puts,
 	.console_getc		= fdt_serial_getc,
 	.console_init		= fdt_serial_init,
 	.irqchip_init		= fdt_irqchip_init,
@@ -226,8 +373,11 @@ const struct sbi_platform_operations platform_ops = {
 	.timer_event_start	= fdt_timer_event_start,
 	.timer_init		= fdt_timer_init,
 	.timer_exit		= fdt_timer_exit,
+	.cache_block_size	= generic_cache_block_size,
 	.system_reset_check	= generic_system_reset_check,
 	.system_reset		= generic_system_reset,
+	.system_suspend_check	= generic_system_suspend_check,
+	.system_suspend		= generic_system_suspend,
 };
 
 struct sbi_platform platform = {
@@ -4,9 +4,12 @@
 
 #include <sbi/riscv_encoding.h>
 #include <sbi/riscv_io.h>
+#include <sbi/sbi_cache.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_const.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_hart.h>
+#include <sbi/sbi_perf_profile.h>
 #include <sbi/sbi_platform.h>
 #include <sbi_utils/irqchip/plic.h>
 #include <sbi_utils/serial/uart8250.h>
@@ -22,6 +25,27 @@ static struct clint_data clint = {
 	.has_64bit_mmio = FALSE,
 };
 
+/*
+ * Cache, prefetch and branch prediction settings of the boot core are
+ * replicated to the other cores as the default performance profile.
+ */
+static int c910_perf_profile_init(void)
+{
+	struct sbi_perf_profile prof = {
+		.name = "boot",
+		.csr_count = 4,
+		.csrs = {
+			{ CSR_MHCR, -1UL, c910_regs.mhcr },
+			{ CSR_MCCR2, -1UL, c910_regs.mccr2 },
+			{ CSR_MHINT, -1UL, c910_regs.mhint },
+			{ CSR_MXSTATUS, -1UL, c910_regs.mxstatus },
+		},
+	};
+	int rc = sbi_perf_profile_register(&prof);
+
+	return (rc < 0) ? rc : 0;
+}
+
 static int c910_early_init(bool cold_boot)
 {
 	if (cold_boot) {
@@ -45,6 +69,8 @@ static int c910_early_init(bool cold_boot)
 		c910_regs.plic_base_addr = csr_read(CSR_PLIC_BASE);
 		c910_regs.clint_base_addr =
 			c910_regs.plic_base_addr + C910_PLIC_CLINT_OFFSET;
+
+		return c910_perf_profile_init();
 	} else {
 		/* Store to other core */
 		csr_write(CSR_PMPADDR0, c910_regs.pmpaddr0);
@@ -58,9 +84,12 @@ static int c910_early_init(bool cold_boot)
 		csr_write(CSR_PMPCFG0, c910_regs.pmpcfg0);
 
 		csr_write(CSR_MCOR, c910_regs.mcor);
+#ifndef CONFIG_SBI_ECALL_PERF_PROFILE
+		/* Without performance profiles, replicate boot core settings */
 		csr_write(CSR_MHCR, c910_regs.mhcr);
 		csr_write(CSR_MHINT, c910_regs.mhint);
 		csr_write(CSR_MXSTATUS, c910_regs.mxstatus);
+#endif
 	}
 
 	return 0;
@@ -118,6 +147,41 @@ static void c910_system_reset(u32 type, u32 reason)
 	asm volatile ("ebreak");
 }
 
+static unsigned long c910_cache_block_size(void)
+{
+	return C910_CACHE_BLOCK_SIZE;
+}
+
+#define C910_DCACHE_RANGE_OP(__insn, __start, __end)			\
+	do {								\
+		register unsigned long a0 asm("a0");			\
+		for (a0 = (__start); a0 < (__end);			\
+		     a0 += C910_CACHE_BLOCK_SIZE)			\
+			asm volatile(__insn : : "r"(a0) : "memory");	\
+	} while (0)
+
+static int c910_cache_op(u32 type, unsigned long addr, unsigned long size)
+{
+	switch (type) {
+	case SBI_CACHE_CLEAN:
+		C910_DCACHE_RANGE_OP(C910_DCACHE_CPA_A0, addr, addr + size);
+		break;
+	case SBI_CACHE_INVAL:
+		C910_DCACHE_RANGE_OP(C910_DCACHE_IPA_A0, addr, addr + size);
+		break;
+	case SBI_CACHE_FLUSH:
+		C910_DCACHE_RANGE_OP(C910_DCACHE_CIPA_A0, addr, addr + size);
+		break;
+	default:
+		return SBI_EINVAL;
+	}
+
+	/* Wait for cache operations to complete on all cores */
+	asm volatile(C910_SYNC_S : : : "memory");
+
+	return 0;
+}
+
 int c910_hart_start(u32 hartid, ulong saddr)
 {
 	csr_write(CSR_MRVBR, saddr);
@@ -139,6 +203,9 @@ const struct sbi_platform_operations platform_ops = {
 	.timer_init          = c910_timer_init,
 	.timer_event_start   = clint_timer_event_start,
 
+	.cache_block_size    = c910_cache_block_size,
+	.cache_op            = c910_cache_op,
+
 	.system_reset_check  = c910_system_reset_check,
 	.system_reset        = c910_system_reset,
 
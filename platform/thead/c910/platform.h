@@ -20,6 +20,14 @@
 #define CSR_MRMR         0x7c6
 #define CSR_MRVBR        0x7c7
 
+#define C910_CACHE_BLOCK_SIZE      64
+
+/* T-HEAD cache instructions with rs1 = a0 */
+#define C910_DCACHE_CPA_A0         ".long 0x0295000b"
+#define C910_DCACHE_IPA_A0         ".long 0x02a5000b"
+#define C910_DCACHE_CIPA_A0        ".long 0x02b5000b"
+#define C910_SYNC_S                ".long 0x0190000b"
+
 #define C910_PLIC_CLINT_OFFSET     0x04000000  /* 64M */
 #define C910_PLIC_DELEG_OFFSET     0x001ffffc
 #define C910_PLIC_DELEG_ENABLE     0x1
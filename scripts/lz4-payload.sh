@@ -0,0 +1,77 @@
+#!/bin/bash
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+
+function usage()
+{
+	echo "Usage:"
+	echo " $0 [options]"
+	echo "Options:"
+	echo "     -h                    Display help or usage"
+	echo "     -c <lz4_command>      LZ4 command (default: lz4)"
+	echo "     -i <input_file_path>  Input binary file path"
+	echo "     -o <output_file_path> Output LZ4 compressed file path"
+	echo "     -w <window_file_path> Output C header with decompression window size"
+	exit 1;
+}
+
+# Command line options
+LZ4_CMD="lz4"
+INPUT_PATH=""
+OUTPUT_PATH=""
+WINDOW_PATH=""
+
+while getopts "hc:i:o:w:" o; do
+	case "${o}" in
+	h)
+		usage
+		;;
+	c)
+		LZ4_CMD=${OPTARG}
+		;;
+	i)
+		INPUT_PATH=${OPTARG}
+		;;
+	o)
+		OUTPUT_PATH=${OPTARG}
+		;;
+	w)
+		WINDOW_PATH=${OPTARG}
+		;;
+	*)
+		usage
+		;;
+	esac
+done
+shift $((OPTIND-1))
+
+if [ -z "${INPUT_PATH}" ]; then
+	echo "Must specify input file path"
+	usage
+fi
+
+if [ -z "${OUTPUT_PATH}" ]; then
+	echo "Must specify output file path"
+	usage
+fi
+
+# Compress using LZ4 legacy frame format
+${LZ4_CMD} -l -9 -f -q ${INPUT_PATH} ${OUTPUT_PATH} || exit 1
+
+# Append uncompressed size as 32-bit little-endian word
+INPUT_SIZE=$(stat -c %s ${INPUT_PATH})
+FRAME_SIZE=$(stat -c %s ${OUTPUT_PATH})
+printf $(printf "%08x" ${INPUT_SIZE} | \
+	sed 's/\(..\)\(..\)\(..\)\(..\)/\\x\4\\x\3\\x\2\\x\1/') >> ${OUTPUT_PATH}
+
+# Window for in-place decompression (must match LZ4_INPLACE_MARGIN)
+if [ ! -z "${WINDOW_PATH}" ]; then
+	WINDOW_SIZE=$((INPUT_SIZE + (FRAME_SIZE >> 8) + 64))
+	if [ ${WINDOW_SIZE} -lt $((FRAME_SIZE + 4)) ]; then
+		WINDOW_SIZE=$((FRAME_SIZE + 4))
+	fi
+	WINDOW_SIZE=$(((WINDOW_SIZE + 7) & ~7))
+	echo "#define FW_PAYLOAD_LZ4_SIZE $((FRAME_SIZE + 4))" > ${WINDOW_PATH}
+	echo "#define FW_PAYLOAD_LZ4_WINDOW_SIZE ${WINDOW_SIZE}" >> ${WINDOW_PATH}
+fi
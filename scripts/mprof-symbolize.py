@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Symbolizer for binary dumps of the OpenSBI M-mode profiler shared
+# memory (see docs/mmode_profiler.md and include/sbi/sbi_mprof.h for the
+# layout) using symbols of the firmware ELF.
+#
+
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+MPROF_MAGIC = 0x504d4253
+MPROF_VERSION = 1
+
+hdr_fmt = '<IIIIIIIIQQQQ'
+hist_fmt = '<QQII'
+
+modes = ['none', 'timer', 'counter']
+
+def parse_symbols(nm, elf):
+    out = subprocess.run([nm, '-n', '--defined-only', elf], check=True,
+                         stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    addrs = []
+    names = []
+    fw_start = None
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 3:
+            continue
+        addr = int(parts[0], 16)
+        if parts[2] == '_fw_start':
+            fw_start = addr
+        if parts[1] not in 'tTwW':
+            continue
+        addrs.append(addr)
+        names.append(parts[2])
+    return addrs, names, fw_start
+
+def parse_dump(data):
+    if len(data) < struct.calcsize(hdr_fmt):
+        sys.exit('Profiler shared memory too small')
+    (magic, version, hist_count, hist_offset, hist_size, bucket_count,
+     bucket_shift, mode, fw_start, fw_size, period, _) = \
+        struct.unpack_from(hdr_fmt, data, 0)
+    if magic != MPROF_MAGIC:
+        sys.exit('Invalid profiler magic 0x%x' % magic)
+    if version != MPROF_VERSION:
+        sys.exit('Unsupported profiler version %d' % version)
+
+    hists = []
+    for i in range(hist_count):
+        off = hist_offset + i * hist_size
+        if len(data) < off + hist_size:
+            sys.exit('Profiler shared memory truncated at HART index %d' % i)
+        samples, dropped, hartid, _ = struct.unpack_from(hist_fmt, data, off)
+        buckets = struct.unpack_from('<%dI' % bucket_count, data,
+                                     off + struct.calcsize(hist_fmt))
+        hists.append((hartid, samples, dropped, buckets))
+    info = {'mode': mode, 'period': period, 'fw_start': fw_start,
+            'fw_size': fw_size, 'bucket_shift': bucket_shift}
+    return info, hists
+
+def symbolize(info, buckets, addrs, names, delta):
+    funcs = {}
+    for i, count in enumerate(buckets):
+        if not count:
+            continue
+        addr = info['fw_start'] + (i << info['bucket_shift']) - delta
+        idx = bisect.bisect_right(addrs, addr) - 1
+        name = names[idx] if idx >= 0 else '0x%x' % addr
+        funcs[name] = funcs.get(name, 0) + count
+    return funcs
+
+def main():
+    parser = argparse.ArgumentParser(description=
+                                     'Symbolize OpenSBI M-mode profile')
+    parser.add_argument('-e', '--elf', required=True,
+                        help='firmware ELF (for example fw_jump.elf)')
+    parser.add_argument('-n', '--nm', default='nm',
+                        help='nm command (default: nm)')
+    parser.add_argument('-H', '--hart', type=int, action='append',
+                        default=[], help='only report samples of this HART')
+    parser.add_argument('-c', '--count', type=int, default=20,
+                        help='number of functions to report (default: 20)')
+    parser.add_argument('dump', help='binary dump of the shared memory')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+    info, hists = parse_dump(data)
+    addrs, names, elf_fw_start = parse_symbols(args.nm, args.elf)
+    if not addrs:
+        sys.exit('No symbols found in %s' % args.elf)
+
+    # Firmware might run at a different address than the link address
+    delta = 0
+    if elf_fw_start is not None:
+        delta = info['fw_start'] - elf_fw_start
+
+    hists = [h for h in hists if not args.hart or h[0] in args.hart]
+    total = sum(h[1] for h in hists)
+    dropped = sum(h[2] for h in hists)
+    funcs = {}
+    for h in hists:
+        for name, count in symbolize(info, h[3], addrs, names,
+                                     delta).items():
+            funcs[name] = funcs.get(name, 0) + count
+
+    print('Source: %s, period: %d, bucket size: %d bytes' %
+          (modes[info['mode']] if info['mode'] < len(modes) else
+           str(info['mode']), info['period'], 1 << info['bucket_shift']))
+    print('Samples: %d (%d outside firmware)' % (total, dropped))
+    print('%-10s %-8s %s' % ('Samples', 'Percent', 'Function'))
+    res = sorted(funcs.items(), key=lambda f: f[1], reverse=True)
+    for name, count in res[:args.count]:
+        print('%-10d %6.2f%%  %s' % (count, 100.0 * count / total, name))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Per-object size contribution report built from a GNU ld map file.
+# Only input sections which made it into the final image are counted.
+#
+
+import argparse
+import os
+import re
+import sys
+
+sect_re = re.compile(r'^ (?P<sect>\.\S+)(\s+0x(?P<addr>[0-9a-f]+)'
+                     r'\s+0x(?P<size>[0-9a-f]+)\s+(?P<obj>\S.*))?$')
+cont_re = re.compile(r'^\s+0x(?P<addr>[0-9a-f]+)\s+0x(?P<size>[0-9a-f]+)'
+                     r'\s+(?P<obj>\S.*)$')
+
+def section_kind(sect):
+    for prefix, kind in (('.text', 'text'), ('.rodata', 'rodata'),
+                         ('.srodata', 'rodata'), ('.data', 'data'),
+                         ('.sdata', 'data'), ('.bss', 'bss'),
+                         ('.sbss', 'bss')):
+        if sect == prefix or sect.startswith(prefix + '.'):
+            return kind
+    return None
+
+def parse_map(path):
+    sizes = {}
+    in_map = False
+    pending = None
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if not in_map:
+                in_map = line.startswith('Linker script and memory map')
+                continue
+            sect = obj = None
+            m = sect_re.match(line)
+            if m:
+                if not m.group('obj'):
+                    # Long section names wrap onto the next line
+                    pending = m.group('sect')
+                    continue
+                sect, size, obj = m.group('sect'), m.group('size'), \
+                                  m.group('obj')
+            elif pending:
+                m = cont_re.match(line)
+                if m:
+                    sect, size, obj = pending, m.group('size'), \
+                                      m.group('obj')
+            pending = None
+            if not sect:
+                continue
+            kind = section_kind(sect)
+            size = int(size, 16)
+            if not kind or not size:
+                continue
+            obj = re.sub(r'^.*/', '', obj)
+            ent = sizes.setdefault(obj, {'text': 0, 'rodata': 0,
+                                         'data': 0, 'bss': 0})
+            ent[kind] += size
+    return sizes
+
+def main():
+    parser = argparse.ArgumentParser(description=
+                                     'Report per-object firmware size')
+    parser.add_argument('-n', '--count', type=int, default=0,
+                        help='number of objects to report (default: all)')
+    parser.add_argument('maps', nargs='+', help='linker map files')
+    args = parser.parse_args()
+
+    for path in args.maps:
+        sizes = parse_map(path)
+        if not sizes:
+            sys.exit('%s: no input sections found' % path)
+        rows = sorted(sizes.items(), reverse=True,
+                      key=lambda r: sum(r[1].values()) - r[1]['bss'])
+        if args.count:
+            rows = rows[:args.count]
+        total = {'text': 0, 'rodata': 0, 'data': 0, 'bss': 0}
+
+        print('%s:' % os.path.basename(path))
+        print('%8s %8s %8s %8s %8s  %s' % ('text', 'rodata', 'data', 'bss',
+                                           'image', 'object'))
+        for obj, ent in rows:
+            for k in total:
+                total[k] += ent[k]
+            print('%8d %8d %8d %8d %8d  %s' % (ent['text'], ent['rodata'],
+                  ent['data'], ent['bss'],
+                  ent['text'] + ent['rodata'] + ent['data'], obj))
+        print('%8d %8d %8d %8d %8d  %s' % (total['text'], total['rodata'],
+              total['data'], total['bss'],
+              total['text'] + total['rodata'] + total['data'], '(total)'))
+        print('')
+
+if __name__ == '__main__':
+    main()
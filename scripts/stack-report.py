@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Worst-case stack usage report built from GCC -fstack-usage output
+# (*.su files) and the call graph recovered from call relocations in
+# "objdump -dr" output of the given objects or archives.
+#
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+su_re = re.compile(r'^.*:\d+:\d+:(?P<func>[^\t]+)\t(?P<size>\d+)\t(?P<kind>.*)$')
+func_re = re.compile(r'^[0-9a-f]+ <(?P<func>[^>]+)>:$')
+reloc_re = re.compile(r'R_RISCV_(CALL|CALL_PLT|JAL)\s+(?P<sym>[^\s+-]+)')
+jalr_re = re.compile(r'\sjalr\s')
+
+def parse_su(dirs):
+    frames = {}
+    dynamic = set()
+    for d in dirs:
+        for root, _, files in os.walk(d):
+            for name in files:
+                if not name.endswith('.su'):
+                    continue
+                with open(os.path.join(root, name)) as f:
+                    for line in f:
+                        m = su_re.match(line.rstrip('\n'))
+                        if not m:
+                            continue
+                        func = m.group('func')
+                        size = int(m.group('size'))
+                        frames[func] = max(frames.get(func, 0), size)
+                        if 'static' not in m.group('kind'):
+                            dynamic.add(func)
+    return frames, dynamic
+
+def parse_calls(objdump, objs):
+    calls = {}
+    indirect = set()
+    out = subprocess.run([objdump, '-dr'] + objs, check=True,
+                         stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    cur = None
+    for line in out.splitlines():
+        m = func_re.match(line)
+        if m:
+            cur = m.group('func')
+            calls.setdefault(cur, set())
+            continue
+        if cur is None:
+            continue
+        m = reloc_re.search(line)
+        if m:
+            calls[cur].add(m.group('sym'))
+        elif jalr_re.search(line):
+            indirect.add(cur)
+    return calls, indirect
+
+def worst_case(func, frames, calls, memo, stack):
+    if func in memo:
+        return memo[func]
+    if func in stack:
+        # Recursion, report what we have and flag the cycle
+        return (frames.get(func, 0), [func + ' (recursive)'])
+    stack.add(func)
+    best = (0, [])
+    for callee in calls.get(func, ()):
+        res = worst_case(callee, frames, calls, memo, stack)
+        if res[0] > best[0]:
+            best = res
+    stack.discard(func)
+    memo[func] = (frames.get(func, 0) + best[0], [func] + best[1])
+    return memo[func]
+
+def main():
+    parser = argparse.ArgumentParser(description=
+                                     'Report worst-case stack usage')
+    parser.add_argument('-d', '--su-dir', action='append', required=True,
+                        help='directory searched for *.su files')
+    parser.add_argument('-o', '--objdump', default='objdump',
+                        help='objdump command (default: objdump)')
+    parser.add_argument('-r', '--root', action='append', default=[],
+                        help='only report call chains from this function')
+    parser.add_argument('-n', '--count', type=int, default=20,
+                        help='number of entries to report (default: 20)')
+    parser.add_argument('objs', nargs='+', help='objects or archives')
+    args = parser.parse_args()
+
+    frames, dynamic = parse_su(args.su_dir)
+    if not frames:
+        sys.exit('No *.su files found, rebuild with STACK_USAGE=y')
+    calls, indirect = parse_calls(args.objdump, args.objs)
+
+    memo = {}
+    roots = args.root if args.root else sorted(calls.keys())
+    res = [(f,) + worst_case(f, frames, calls, memo, set()) for f in roots]
+    res.sort(key=lambda r: r[1], reverse=True)
+
+    print('%-8s %-8s %s' % ('Total', 'Frame', 'Call chain'))
+    for func, total, chain in res[:args.count]:
+        flags = ''
+        if any(c in dynamic for c in chain):
+            flags += ' [dynamic]'
+        if any(c in indirect for c in chain):
+            flags += ' [indirect calls not followed]'
+        print('%-8d %-8d %s%s' % (total, frames.get(func, 0),
+                                  ' -> '.join(chain), flags))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Decoder for binary dumps of the OpenSBI firmware trace buffer (see
+# docs/firmware_trace.md and include/sbi/sbi_trace.h for the layout).
+#
+
+import argparse
+import struct
+import sys
+
+TRACE_MAGIC = 0x52544253
+TRACE_VERSION = 1
+
+hdr_fmt = '<IIIIIIIIQ'
+ring_fmt = '<QII'
+rec_fmt = '<QIIIIQQ'
+
+categories = ['trap', 'ecall', 'ipi', 'tlb', 'hsm', 'timer', 'domain']
+
+hsm_states = ['STOPPED', 'STOPPING', 'STARTING', 'STARTED']
+
+tlb_types = ['VMA', 'VMA_ASID', 'GVMA', 'GVMA_VMID', 'VVMA', 'VVMA_ASID',
+             'ITLB']
+
+modes = ['U', 'S', '?', 'M']
+
+def fmt_trap_entry(a0, a1, a2, a3):
+    return 'prev=%s mcause=0x%x mepc=0x%x' % (modes[a1 & 3], a2, a3)
+
+def fmt_trap_exit(a0, a1, a2, a3):
+    return 'mepc=0x%x' % a3
+
+def fmt_ecall(a0, a1, a2, a3):
+    err = a3 if a3 < (1 << 63) else a3 - (1 << 64)
+    return 'ext=0x%x fid=%d ret=%d' % (a2, a1, err)
+
+def fmt_ipi_send(a0, a1, a2, a3):
+    return 'hart=%d event=%d' % (a0, a1)
+
+def fmt_ipi_recv(a0, a1, a2, a3):
+    return 'events=0x%x' % a2
+
+def fmt_tlb(a0, a1, a2, a3, remote):
+    t = tlb_types[a1] if a1 < len(tlb_types) else str(a1)
+    s = 'type=%s start=0x%x size=0x%x' % (t, a2, a3)
+    return ('hart=%d ' % a0 + s) if remote else s
+
+def fmt_hsm(a0, a1, a2, a3):
+    st = hsm_states[a1] if a1 < len(hsm_states) else str(a1)
+    return 'hart=%d state=%s' % (a0, st)
+
+def fmt_timer(a0, a1, a2, a3):
+    return 'next=0x%x' % a2
+
+def fmt_domain_switch(a0, a1, a2, a3):
+    return 'domain=%d prev=%d latency=%d cost=%d' % (a0, a1, a2, a3)
+
+events = {
+    (0, 0): ('TRAP_ENTRY', fmt_trap_entry),
+    (0, 1): ('TRAP_EXIT', fmt_trap_exit),
+    (1, 0): ('ECALL', fmt_ecall),
+    (2, 0): ('IPI_SEND', fmt_ipi_send),
+    (2, 1): ('IPI_RECV', fmt_ipi_recv),
+    (3, 0): ('TLB_ENQUEUE', lambda *a: fmt_tlb(*a, remote=True)),
+    (3, 1): ('TLB_COALESCE', lambda *a: fmt_tlb(*a, remote=True)),
+    (3, 2): ('TLB_PROCESS', lambda *a: fmt_tlb(*a, remote=False)),
+    (3, 3): ('TLB_SKIP', lambda *a: fmt_tlb(*a, remote=False)),
+    (4, 0): ('HSM_STATE', fmt_hsm),
+    (5, 0): ('TIMER_START', fmt_timer),
+    (6, 0): ('DOMAIN_SWITCH', fmt_domain_switch),
+}
+
+def parse_buffer(data):
+    if len(data) < struct.calcsize(hdr_fmt):
+        sys.exit('Trace buffer too small')
+    (magic, version, ring_count, ring_entries, ring_offset, ring_size,
+     record_size, _, mask) = struct.unpack_from(hdr_fmt, data, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit('Invalid trace buffer magic 0x%x' % magic)
+    if version != TRACE_VERSION:
+        sys.exit('Unsupported trace buffer version %d' % version)
+    if record_size < struct.calcsize(rec_fmt):
+        sys.exit('Invalid trace record size %d' % record_size)
+
+    rings = []
+    for i in range(ring_count):
+        off = ring_offset + i * ring_size
+        if len(data) < off + ring_size:
+            sys.exit('Trace buffer truncated at ring %d' % i)
+        head, hartid, _ = struct.unpack_from(ring_fmt, data, off)
+        first = max(0, head - ring_entries)
+        recs = []
+        for seq in range(first, head):
+            roff = off + struct.calcsize(ring_fmt) + \
+                   (seq % ring_entries) * record_size
+            recs.append(struct.unpack_from(rec_fmt, data, roff))
+        rings.append((hartid, head - first, first, recs))
+    return mask, rings
+
+def format_record(hartid, rec):
+    time, event, a0, a1, _, a2, a3 = rec
+    name, fmt = events.get((event >> 8, event & 0xff),
+                           ('EVENT_0x%x' % event, None))
+    desc = fmt(a0, a1, a2, a3) if fmt else \
+           'args=0x%x 0x%x 0x%x 0x%x' % (a0, a1, a2, a3)
+    return '%16d hart%-3d %-13s %s' % (time, hartid, name, desc)
+
+def main():
+    parser = argparse.ArgumentParser(description=
+                                     'Decode OpenSBI firmware trace buffer')
+    parser.add_argument('-m', '--merge', action='store_true',
+                        help='merge records of all HARTs sorted by time')
+    parser.add_argument('-H', '--hart', type=int, action='append',
+                        default=[], help='only report records of this HART')
+    parser.add_argument('dump', help='binary dump of the trace buffer')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as f:
+        data = f.read()
+    mask, rings = parse_buffer(data)
+
+    enabled = [c for i, c in enumerate(categories) if mask & (1 << i)]
+    print('Enabled categories: %s' % (', '.join(enabled) or 'none'))
+
+    rings = [r for r in rings if not args.hart or r[0] in args.hart]
+    if args.merge:
+        recs = [(r[0], rec) for r in rings for rec in r[3]]
+        recs.sort(key=lambda x: x[1][0])
+        for hartid, rec in recs:
+            print(format_record(hartid, rec))
+        return
+
+    for hartid, count, dropped, recs in rings:
+        print('HART%d: %d records (%d overwritten)' %
+              (hartid, count, dropped))
+        for rec in recs:
+            print(format_record(hartid, rec))
+
+if __name__ == '__main__':
+    main()